@@ -1,8 +1,12 @@
 #include "./EventShape.h"
+#include "./coreProfiler.h"
+#include <algorithm>
+#include <utility>
 
 EventShape::~EventShape(){}
 
-EventShape::EventShape(const std::vector<LorentzVector> & inputVectors) {
+EventShape::EventShape(const std::vector<LorentzVector> & inputVectors)
+  : cachedR_(0), eigenValuesCached_(false) {
 
   inputVectors_.reserve( inputVectors.size() );
   
@@ -21,12 +25,13 @@ EventShape::EventShape(const std::vector<LorentzVector> & inputVectors) {
 }
 
 /// helper function to fill the 3 dimensional momentum tensor from the inputVecotrs where needed
-TMatrixDSym  EventShape::compMomentumTensor(double r) const {
-   TMatrixDSym momentumTensor(3);
-   momentumTensor.Zero();
+void EventShape::compMomentumTensor(double momentumTensor[3][3], double r) const {
+   for ( int j = 0; j < 3; ++j ){
+     for ( int k = 0; k < 3; ++k ) momentumTensor[j][k] = 0;
+   }
  
    if ( inputVectors_.size() < 2 ){
-     return momentumTensor;
+     return;
    }
  
    // fill momentumTensor from inputVectors
@@ -36,76 +41,114 @@ TMatrixDSym  EventShape::compMomentumTensor(double r) const {
      double pR = ( r == 2. ) ? p2 : TMath::Power(p2, 0.5*r);
      norm += pR;
      double pRminus2 = ( r == 2. ) ? 1. : TMath::Power(p2, 0.5*r - 1.);
-     momentumTensor(0,0) += pRminus2*inputVectors_[i].x()*inputVectors_[i].x();
-     momentumTensor(0,1) += pRminus2*inputVectors_[i].x()*inputVectors_[i].y();
-     momentumTensor(0,2) += pRminus2*inputVectors_[i].x()*inputVectors_[i].z();
-     momentumTensor(1,0) += pRminus2*inputVectors_[i].y()*inputVectors_[i].x();
-     momentumTensor(1,1) += pRminus2*inputVectors_[i].y()*inputVectors_[i].y();
-     momentumTensor(1,2) += pRminus2*inputVectors_[i].y()*inputVectors_[i].z();
-     momentumTensor(2,0) += pRminus2*inputVectors_[i].z()*inputVectors_[i].x();
-     momentumTensor(2,1) += pRminus2*inputVectors_[i].z()*inputVectors_[i].y();
-     momentumTensor(2,2) += pRminus2*inputVectors_[i].z()*inputVectors_[i].z();
+     momentumTensor[0][0] += pRminus2*inputVectors_[i].x()*inputVectors_[i].x();
+     momentumTensor[0][1] += pRminus2*inputVectors_[i].x()*inputVectors_[i].y();
+     momentumTensor[0][2] += pRminus2*inputVectors_[i].x()*inputVectors_[i].z();
+     momentumTensor[1][1] += pRminus2*inputVectors_[i].y()*inputVectors_[i].y();
+     momentumTensor[1][2] += pRminus2*inputVectors_[i].y()*inputVectors_[i].z();
+     momentumTensor[2][2] += pRminus2*inputVectors_[i].z()*inputVectors_[i].z();
    }
- 
-   //std::cout << "momentumTensor:" << std::endl;
-   //std::cout << momentumTensor(0,0) << " " << momentumTensor(0,1) << " " << momentumTensor(0,2) 
-   //          << momentumTensor(1,0) << " " << momentumTensor(1,1) << " " << momentumTensor(1,2) 
-   //          << momentumTensor(2,0) << " " << momentumTensor(2,1) << " " << momentumTensor(2,2) << std::endl;
+   momentumTensor[1][0] = momentumTensor[0][1];
+   momentumTensor[2][0] = momentumTensor[0][2];
+   momentumTensor[2][1] = momentumTensor[1][2];
  
    // return momentumTensor normalized to determinant 1
-   return (1./norm)*momentumTensor;
+   for ( int j = 0; j < 3; ++j ){
+     for ( int k = 0; k < 3; ++k ) momentumTensor[j][k] *= 1./norm;
+   }
 }
  
 /// helper function to fill the 3 dimensional vector of eigen-values;
-/// the largest (smallest) eigen-value is stored at index position 0 (2)
-TVectorD EventShape::compEigenValues(double r) const {
+/// the largest (smallest) eigen-value is stored at index position 0 (2).
+/// Uses the closed form for symmetric 3x3 matrices (O. K. Smith, 1961).
+const double* EventShape::compEigenValues(double r) const {
+
+   if( eigenValuesCached_ && cachedR_ == r ) return eigenValues_;
+
+   double a[3][3];
+   compMomentumTensor(a, r);
 
-   TVectorD eigenValues(3);
-   TMatrixDSym myTensor = compMomentumTensor(r);
-   if( myTensor.IsSymmetric() ){
-     if( myTensor.NonZeros() != 0 ) myTensor.EigenVectors(eigenValues);
+   double p1 = a[0][1]*a[0][1] + a[0][2]*a[0][2] + a[1][2]*a[1][2];
+   if( p1 == 0 ){
+     // diagonal
+     eigenValues_[0] = a[0][0];
+     eigenValues_[1] = a[1][1];
+     eigenValues_[2] = a[2][2];
+     std::sort(eigenValues_, eigenValues_ + 3);
+     std::swap(eigenValues_[0], eigenValues_[2]);
+   } else {
+     double q  = ( a[0][0] + a[1][1] + a[2][2] ) / 3.;
+     double d0 = a[0][0] - q, d1 = a[1][1] - q, d2 = a[2][2] - q;
+     double p  = sqrt( ( d0*d0 + d1*d1 + d2*d2 + 2.*p1 ) / 6. );
+     // half the determinant of ( A - q I ) / p
+     double detB = ( d0 * ( d1*d2 - a[1][2]*a[1][2] )
+                   - a[0][1] * ( a[0][1]*d2 - a[1][2]*a[0][2] )
+                   + a[0][2] * ( a[0][1]*a[1][2] - d1*a[0][2] ) ) / ( p*p*p );
+     double h = std::max( -1., std::min( 1., 0.5 * detB ) );
+     double phi = acos(h) / 3.;
+     eigenValues_[0] = q + 2.*p*cos(phi);
+     eigenValues_[2] = q + 2.*p*cos(phi + 2.*TMath::Pi()/3.);
+     eigenValues_[1] = 3.*q - eigenValues_[0] - eigenValues_[2];
    }
- 
-   // CV: TMatrixDSym::EigenVectors returns eigen-values and eigen-vectors
-   //     ordered by descending eigen-values, so no need to do any sorting here...
-   // std::cout << "eigenValues(0) = " << eigenValues(0) << ","
-   //           << " eigenValues(1) = " << eigenValues(1) << ","
-   //           << " eigenValues(2) = " << eigenValues(2) << std::endl;
- 
-   return eigenValues;
+
+   cachedR_ = r;
+   eigenValuesCached_ = true;
+   return eigenValues_;
 }
 
 double  EventShape::sphericity(double r) const {
 
-  TVectorD eigenValues = compEigenValues(r);
-  return 1.5*(eigenValues(1) + eigenValues(2));
+  CORE_PROFILE_SCOPE("EventShape::sphericity");
+  const double* eigenValues = compEigenValues(r);
+  return 1.5*(eigenValues[1] + eigenValues[2]);
 
 }
 
-double  EventShape::circularity(const unsigned int& numberOfSteps) const {
+/// circularity = pi/2 * min over n of sum |n.pT| / sum |pT|. Between two
+/// directions perpendicular to an input the sum is a positive sinusoid in
+/// phi, so the minimum sits at one of those directions. With every pT
+/// folded into the upper half plane and sorted by angle they are visited
+/// in a single sweep.
+double  EventShape::circularity(const unsigned int& /*numberOfSteps*/) const {
 
-   const double deltaPhi=2*TMath::Pi()/numberOfSteps;
-   double circ=-1, phi=0, area = 0;
-   for(unsigned int i=0;i<inputVectors_.size();i++) {
-     area+=TMath::Sqrt(inputVectors_[i].x()*inputVectors_[i].x()+inputVectors_[i].y()*inputVectors_[i].y());
+   CORE_PROFILE_SCOPE("EventShape::circularity");
+   const unsigned int n = inputVectors_.size();
+   std::vector<std::pair<double, unsigned int> > order(n);
+   std::vector<double> wx(n), wy(n);
+   double area = 0, sx = 0, sy = 0;
+   for(unsigned int i=0; i<n; ++i) {
+     double x = inputVectors_[i].x(), y = inputVectors_[i].y();
+     area+=TMath::Sqrt(x*x+y*y);
+     if( y < 0 || ( y == 0 && x < 0 ) ) { x = -x; y = -y; }
+     wx[i] = x;
+     wy[i] = y;
+     sx += x;
+     sy += y;
+     order[i] = std::make_pair(atan2(y, x), i);
    }
-   for(unsigned int i=0; i<numberOfSteps; ++i){
-     phi+=deltaPhi;
-     double sum=0, tmp=0.;
-     for(unsigned int j=0; j<inputVectors_.size(); ++j){
-       sum+=TMath::Abs(TMath::Cos(phi)*inputVectors_[j].x()+TMath::Sin(phi)*inputVectors_[j].y());
-     }
-     tmp=TMath::Pi()/2*sum/area;
-     if( circ<0 || tmp<circ ){
-       circ=tmp;
+   std::sort(order.begin(), order.end());
+
+   // along the direction of the k-th sorted pT, the inputs before it lie on
+   // one side and those after it on the other; s is the signed sum
+   double minSum = n > 0 ? -1 : 0;
+   for(unsigned int k=0; k<n; ++k){
+     unsigned int i = order[k].second;
+     double pt = TMath::Sqrt(wx[i]*wx[i]+wy[i]*wy[i]);
+     if( pt > 0 ){
+       double sum = TMath::Abs(( wx[i]*sy - wy[i]*sx ) / pt);
+       if( minSum < 0 || sum < minSum ) minSum = sum;
      }
+     sx -= 2*wx[i];
+     sy -= 2*wy[i];
    }
-   return circ;
+   if( minSum < 0 ) minSum = 0;
+   return TMath::Pi()/2*minSum/area;
 }
 
 double 
 EventShape::aplanarity(double r) const
 {
-   TVectorD eigenValues = compEigenValues(r);
-   return 1.5*eigenValues(2);
+   CORE_PROFILE_SCOPE("EventShape::aplanarity");
+   const double* eigenValues = compEigenValues(r);
+   return 1.5*eigenValues[2];
 }
@@ -17,9 +17,6 @@
 #include "TMatrixDSym.h"
 #include "TVectorD.h"
 
-// CMS2
-#include "./CMS2.h"
-
 //#include "Utils.h"
 
 #include "./utilities.h"
@@ -45,15 +42,23 @@ class EventShape {
   double sphericity(double = 2.)  const;
   double aplanarity(double = 2.)  const;
  
+  /// exact minimum over the transverse axis direction; numberOfSteps,
+  /// the number of directions the old scan tried, is ignored
   double circularity(const unsigned int& numberOfSteps = 1000) const;
 
  private:
   
-  TMatrixDSym compMomentumTensor(double = 2.) const;
-  TVectorD compEigenValues(double = 2.) const;
+  void compMomentumTensor(double tensor[3][3], double = 2.) const;
+  const double* compEigenValues(double = 2.) const;
   
   /// cashing of input vectors
   std::vector<XYZVector> inputVectors_;
+
+  /// eigen-values of the momentum tensor for the last r asked for,
+  /// shared by sphericity and aplanarity
+  mutable double cachedR_;
+  mutable bool   eigenValuesCached_;
+  mutable double eigenValues_[3];
   
 };
 
@@ -9,7 +9,8 @@ using namespace std;
 // default constructor
 //
 JetMETUncertainty::JetMETUncertainty ()
-    : ele_unc_b_(0.006), ele_unc_e_(0.015), mu_unc_(0.01), uncl_unc_(0.1), have_jetcorr_unc_(false), have_jetsmear_(false)
+    : ele_unc_b_(0.006), ele_unc_e_(0.015), mu_unc_(0.01), uncl_unc_(0.1), have_jetcorr_unc_(false), have_jetsmear_(false),
+      have_jetcorr_uncertainties_(false), have_smeared_jet_sf_(false)
 {
     jetCorrectionUncertainty_ = 0;
     jetSmearer_               = 0;
@@ -20,7 +21,8 @@ JetMETUncertainty::JetMETUncertainty ()
 //
 JetMETUncertainty::JetMETUncertainty(string jetcorr_unc_file_name,
                                      vector<string> &jetsmear_file_names)
-    : ele_unc_b_(0.006), ele_unc_e_(0.015), mu_unc_(0.01), uncl_unc_(0.1)
+    : ele_unc_b_(0.006), ele_unc_e_(0.015), mu_unc_(0.01), uncl_unc_(0.1),
+      have_jetcorr_uncertainties_(false), have_smeared_jet_sf_(false)
 {
     have_jetcorr_unc_ = false;
     jetcorr_unc_file_name_ = jetcorr_unc_file_name;
@@ -140,6 +142,128 @@ dpair JetMETUncertainty::GetScaledMET (dpair good_met, Component component, Scal
     }
 }
 
+//
+// get all scaled METs and the total uncertainty in one pass over the
+// electrons, muons and jets; same values as GetScaledMET and
+// GetTotalUncertainty
+//
+JetMETUncertainty::Variations JetMETUncertainty::GetAllVariations (dpair good_met)
+{
+    good_met_ = dpair(good_met);
+    double base_met = good_met_.first;
+    double met_x = good_met_.first * cos(good_met_.second);
+    double met_y = good_met_.first * sin(good_met_.second);
+
+    double umet_x[N_COMPONENTS], umet_y[N_COMPONENTS], dmet_x[N_COMPONENTS], dmet_y[N_COMPONENTS];
+    for (int icomp = 0; icomp < N_COMPONENTS; icomp++) {
+        umet_x[icomp] = met_x;
+        umet_y[icomp] = met_y;
+        dmet_x[icomp] = met_x;
+        dmet_y[icomp] = met_y;
+    }
+    double uncl_x = met_x;
+    double uncl_y = met_y;
+
+    for (unsigned int idx = 0; idx < good_els_.size(); idx++) {
+        double eta   = fabs(good_els_.at(idx).eta());
+        double px    = good_els_.at(idx).px();
+        double py    = good_els_.at(idx).py();
+        double scale = (eta < 1.479) ? ele_unc_b_ : ele_unc_e_;
+
+        dmet_x[ELE] -= DOWN * scale * px;
+        dmet_y[ELE] -= DOWN * scale * py;
+        umet_x[ELE] -= UP * scale * px;
+        umet_y[ELE] -= UP * scale * py;
+
+        uncl_x += px;
+        uncl_y += py;
+    }
+
+    for (unsigned int idx = 0; idx < good_mus_.size(); idx++) {
+        double px    = good_mus_.at(idx).px();
+        double py    = good_mus_.at(idx).py();        
+
+        dmet_x[MU] -= DOWN * mu_unc_ * px;
+        dmet_y[MU] -= DOWN * mu_unc_ * py;
+        umet_x[MU] -= UP * mu_unc_ * px;
+        umet_y[MU] -= UP * mu_unc_ * py;
+
+        uncl_x += px;
+        uncl_y += py;
+    }
+
+    if (have_jetcorr_unc_)
+        FillJESUncertainties ();
+    if (have_jetsmear_)
+        FillSmearedJetScaleFactors ();
+    for (unsigned int idx = 0; idx < good_jets_.size(); idx++) {
+        double px = good_jets_.at(idx).px();
+        double py = good_jets_.at(idx).py();
+
+        if (have_jetcorr_unc_) {
+            double scale = jetcorr_uncertainties_.at(idx);
+            dmet_x[JES] -= DOWN * scale * px;
+            dmet_y[JES] -= DOWN * scale * py;
+            umet_x[JES] -= UP * scale * px;
+            umet_y[JES] -= UP * scale * py;
+        }
+
+        if (have_jetsmear_) {
+            double scale = smeared_jet_sf_.at(idx);
+            dmet_x[JER] -= DOWN * scale * px;
+            dmet_y[JER] -= DOWN * scale * py;
+            umet_x[JER] -= UP * scale * px;
+            umet_y[JER] -= UP * scale * py;
+        }
+
+        uncl_x += px;
+        uncl_y += py;
+    }
+
+    // as in SmearMETForUnclusteredEnergyUncertainty
+    dmet_x[UNCL] -= DOWN * uncl_unc_ * uncl_x;
+    dmet_y[UNCL] -= DOWN * uncl_unc_ * uncl_y;
+    umet_x[UNCL] -= DOWN * uncl_unc_ * uncl_x;
+    umet_y[UNCL] -= DOWN * uncl_unc_ * uncl_y;
+
+    Variations vars;
+    double unc_up   = 0.;
+    double unc_down = 0.;
+    for (int icomp = 0; icomp < N_COMPONENTS; icomp++) {
+        if ((icomp == JES && !have_jetcorr_unc_) || (icomp == JER && !have_jetsmear_)) {
+            vars.up[icomp]   = make_pair(-1., 0.);
+            vars.down[icomp] = make_pair(-1., 0.);
+            continue;
+        }
+        vars.up[icomp]   = make_pair(sqrt( pow(umet_x[icomp], 2) + pow(umet_y[icomp], 2)), atan2(umet_y[icomp], umet_x[icomp]));
+        vars.down[icomp] = make_pair(sqrt( pow(dmet_x[icomp], 2) + pow(dmet_y[icomp], 2)), atan2(dmet_y[icomp], dmet_x[icomp]));
+
+        double tmp_up   = (vars.up[icomp].first - base_met) / base_met;
+        unc_up += pow(tmp_up, 2);
+
+        double tmp_down = (vars.down[icomp].first - base_met) / base_met;
+        unc_down += pow(tmp_down, 2);
+    }
+    vars.total = make_pair(sqrt(unc_up), sqrt(unc_down));
+
+    return vars;
+}
+
+//
+// GetAllVariations for the inputs of many events
+// leaves the last event's inputs set
+//
+vector<JetMETUncertainty::Variations> JetMETUncertainty::GetAllVariations (vector<Inputs> &inputs)
+{
+    vector<Variations> vars;
+    vars.reserve(inputs.size());
+    for (unsigned int idx = 0; idx < inputs.size(); idx++) {
+        SetInputParameters(inputs[idx].good_els, inputs[idx].good_mus, inputs[idx].good_jets);
+        vars.push_back(GetAllVariations(inputs[idx].good_met));
+    }
+    return vars;
+}
+
 //
 // smear met for electron energy scale uncertainty
 // default uncertainty is 0.6% in barrel
@@ -269,15 +393,11 @@ void JetMETUncertainty::SmearMETForJESUncertainty ()
     double umet_x = good_met_.first * cos(good_met_.second);
     double umet_y = good_met_.first * sin(good_met_.second);
 
-    jetcorr_uncertainties_.clear();
+    FillJESUncertainties ();
     for (unsigned int idx = 0; idx < good_jets_.size(); idx++) {
         double px = good_jets_.at(idx).px();
         double py = good_jets_.at(idx).py();
-
-        jetCorrectionUncertainty_->setJetEta(good_jets_.at(idx).eta());
-        jetCorrectionUncertainty_->setJetPt(good_jets_.at(idx).pt());
-        double scale = jetCorrectionUncertainty_->getUncertainty(true);
-        jetcorr_uncertainties_.push_back(scale);
+        double scale = jetcorr_uncertainties_.at(idx);
 
         dmet_x -= DOWN * scale * px;
         dmet_y -= DOWN * scale * py;
@@ -308,18 +428,7 @@ void JetMETUncertainty::SmearMETForJERUncertainty ()
         return;
     }
 
-    smeared_jets_ = smearJets(good_jets_, jetSmearer_);
-
-    //
-    // this is all just to make the up/down variation easier to deal with
-    //
-    smeared_jet_sf_.clear();
-    smeared_jet_sf_.reserve(smeared_jets_.size());
-    for (unsigned int idx = 0; idx < smeared_jets_.size(); idx++) {
-        double diff = (smeared_jets_.at(idx).pt() - good_jets_.at(idx).pt()) / good_jets_.at(idx).pt();
-        smeared_jet_sf_.push_back(diff - 1.);
-    }
-    assert(smeared_jet_sf_.size() == good_jets_.size());
+    FillSmearedJetScaleFactors ();
 
     double dmet_x = good_met_.first * cos(good_met_.second);
     double dmet_y = good_met_.first * sin(good_met_.second);
@@ -342,6 +451,47 @@ void JetMETUncertainty::SmearMETForJERUncertainty ()
     met_jer_down_ = make_pair(sqrt( pow(dmet_x, 2) + pow(dmet_y, 2) ), atan2(dmet_y, dmet_x));
 }
 
+//
+// JES uncertainty of each good jet, evaluated once per set of inputs
+//
+void JetMETUncertainty::FillJESUncertainties ()
+{
+    if (have_jetcorr_uncertainties_)
+        return;
+
+    jetcorr_uncertainties_.clear();
+    jetcorr_uncertainties_.reserve(good_jets_.size());
+    for (unsigned int idx = 0; idx < good_jets_.size(); idx++) {
+        jetCorrectionUncertainty_->setJetEta(good_jets_.at(idx).eta());
+        jetCorrectionUncertainty_->setJetPt(good_jets_.at(idx).pt());
+        jetcorr_uncertainties_.push_back(jetCorrectionUncertainty_->getUncertainty(true));
+    }
+    have_jetcorr_uncertainties_ = true;
+}
+
+//
+// JER smearing of each good jet, drawn once per set of inputs
+//
+void JetMETUncertainty::FillSmearedJetScaleFactors ()
+{
+    if (have_smeared_jet_sf_)
+        return;
+
+    smeared_jets_ = smearJets(good_jets_, jetSmearer_);
+
+    //
+    // this is all just to make the up/down variation easier to deal with
+    //
+    smeared_jet_sf_.clear();
+    smeared_jet_sf_.reserve(smeared_jets_.size());
+    for (unsigned int idx = 0; idx < smeared_jets_.size(); idx++) {
+        double diff = (smeared_jets_.at(idx).pt() - good_jets_.at(idx).pt()) / good_jets_.at(idx).pt();
+        smeared_jet_sf_.push_back(diff - 1.);
+    }
+    assert(smeared_jet_sf_.size() == good_jets_.size());
+    have_smeared_jet_sf_ = true;
+}
+
 //
 // set input parameters
 // 1) vector of good electrons as defined by analysis selections
@@ -353,6 +503,9 @@ void JetMETUncertainty::SetInputParameters (VofP4s &good_els, VofP4s &good_mus,
     good_els_  = VofP4s(good_els);
     good_mus_  = VofP4s(good_mus);
     good_jets_ = VofP4s(good_jets);
+
+    have_jetcorr_uncertainties_ = false;
+    have_smeared_jet_sf_        = false;
 }
 
 //
@@ -361,6 +514,7 @@ void JetMETUncertainty::SetInputParameters (VofP4s &good_els, VofP4s &good_mus,
 void JetMETUncertainty::SetJetCorrUncFileName(string jetcorr_unc_file_name)
 {
     have_jetcorr_unc_ = false;
+    have_jetcorr_uncertainties_ = false;
     jetcorr_unc_file_name_ = std::string(jetcorr_unc_file_name);
     if (!jetcorr_unc_file_name.empty()) {
         jetCorrectionUncertainty_ = new JetCorrectionUncertainty(jetcorr_unc_file_name_);
@@ -375,6 +529,7 @@ void JetMETUncertainty::SetJetCorrUncFileName(string jetcorr_unc_file_name)
 void JetMETUncertainty::SetJetSmearFileNames(vector<string> &jetsmear_file_names)
 {
     have_jetsmear_ = false;
+    have_smeared_jet_sf_ = false;
     jetsmear_file_names_ = std::vector<std::string>(jetsmear_file_names);
     if (jetsmear_file_names_.size() == 3) {
         jetSmearer_ = makeJetSmearer(jetsmear_file_names_);
@@ -60,6 +60,13 @@
       b) returns uncertainty on scaling met (up, down)
 
 
+   All components at once: JetMETUncertainty::Variations vars = jetMETUncertainty->GetAllVariations(std::pair<double, double> input_met);
+      a) vars.up[component], vars.down[component] are what GetScaledMET returns
+      b) vars.total is what GetTotalUncertainty returns
+      c) per-jet JES uncertainties and JER factors are evaluated once per SetInputParameters
+         and shared by all calls, so JER UP and DOWN use the same smearing
+
+
    4) How to use the uncertainties:
       a) Simultaneously vary MET and jets --UP-- and determine impact on yields passing full selection.
       b) Simultaneously vary MET and jets --DOWN-- and determine impact on yields passing full selection.
@@ -100,6 +107,22 @@ public:
     enum ScaleType { DOWN = -1, UP = 1 };
     enum Component { ELE = 0, MU, UNCL, JES, JER, N_COMPONENTS };
 
+    // (met, met_phi) for every component and direction, and the total
+    // uncertainty (up, down) as returned by GetTotalUncertainty
+    struct Variations {
+        dpair up[N_COMPONENTS];
+        dpair down[N_COMPONENTS];
+        dpair total;
+    };
+
+    // inputs of one event for the batch GetAllVariations
+    struct Inputs {
+        VofP4s good_els;
+        VofP4s good_mus;
+        VofP4s good_jets;
+        dpair  good_met;
+    };
+
     void SetJetCorrUncFileName (std::string jetcorr_unc_file_name);
     void SetJetSmearFileNames (std::vector<std::string> &jetsmear_file_names);
     void SetElectronUncertainty(double barrel_uncertainty, double endcap_uncertainty);
@@ -112,6 +135,8 @@ public:
     double GetUnclusteredEnergyUncertainty();
     dpair  GetScaledMET (dpair good_met, Component component, ScaleType scale_type);
     dpair  GetTotalUncertainty(dpair good_met);
+    Variations GetAllVariations (dpair good_met);
+    std::vector<Variations> GetAllVariations (std::vector<Inputs> &inputs);
 
     std::vector<double> GetSmearedJetScaleFactors ();
     std::vector<double> GetJESUncertainties ();
@@ -153,6 +178,8 @@ private:
     VofP4s smeared_jets_;
     std::vector<double> smeared_jet_sf_;
     std::vector<double> jetcorr_uncertainties_;
+    bool have_jetcorr_uncertainties_;   // jetcorr_uncertainties_ filled for good_jets_
+    bool have_smeared_jet_sf_;          // smeared_jet_sf_ filled for good_jets_
 
     void SmearMETForElectronUncertainty          ();
     void SmearMETForMuonUncertainty              ();
@@ -161,6 +188,8 @@ private:
     void SmearMETForJERUncertainty               ();
 
     dpair GetUnclusteredMET ();
+    void  FillJESUncertainties ();
+    void  FillSmearedJetScaleFactors ();
 };
 
 #endif
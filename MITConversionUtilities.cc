@@ -1,7 +1,94 @@
 #include "MITConversionUtilities.h"
 #include "CMS2.h"
+#include <algorithm>
 #include "TMath.h"
+#include "utilities.h"
+#include "coreProfiler.h"
 
+//
+// Per-event lookup of conversions by the index of their tracks. The
+// vertex quality of each conversion is evaluated once per event so that
+// an electron query only visits the conversions its tracks belong to.
+//
+namespace {
+
+  struct ConversionInfo {
+    float prob;
+    float dl;
+    bool  arbitratedMerged;
+    int   maxHitsBeforeVtx;
+  };
+
+  struct ConversionLookup {
+    EventTag tag;
+    std::vector<ConversionInfo> convs;
+    std::vector<std::vector<unsigned int> > byGsfTrack;  // algo 29 (gsf) tracks
+    std::vector<std::vector<unsigned int> > byCtfTrack;  // algo 4-13, except 12
+  };
+
+  ConversionLookup lookup;
+
+  void addToIndex(std::vector<std::vector<unsigned int> > &index, int tkidx, unsigned int iconv) {
+    if (tkidx < 0)
+      return;
+    if (index.size() <= (unsigned int)tkidx)
+      index.resize(tkidx + 1);
+    std::vector<unsigned int> &list = index[tkidx];
+    if (list.empty() || list.back() != iconv)
+      list.push_back(iconv);
+  }
+
+  void fillConversionLookup() {
+
+    lookup.convs.clear();
+    for (unsigned int i = 0; i < lookup.byGsfTrack.size(); i++)
+      lookup.byGsfTrack[i].clear();
+    for (unsigned int i = 0; i < lookup.byCtfTrack.size(); i++)
+      lookup.byCtfTrack[i].clear();
+
+    unsigned int nconvs = cms2.convs_isConverted().size();
+    lookup.convs.resize(nconvs);
+    for (unsigned int iconv = 0; iconv < nconvs; iconv++) {
+
+      ConversionInfo &info = lookup.convs[iconv];
+      info.prob             = TMath::Prob( cms2.convs_chi2()[iconv], (Int_t)cms2.convs_ndof()[iconv] );
+      info.dl               = cms2.convs_dl()[iconv];
+      info.arbitratedMerged = cms2.convs_quality()[iconv] & 4;
+      info.maxHitsBeforeVtx = -999999;
+      for (unsigned int j = 0; j < cms2.convs_nHitsBeforeVtx()[iconv].size(); j++)
+        info.maxHitsBeforeVtx = std::max(info.maxHitsBeforeVtx, cms2.convs_nHitsBeforeVtx()[iconv][j]);
+
+      for (unsigned int itk = 0; itk < cms2.convs_tkidx()[iconv].size(); itk++) {
+        int algo = cms2.convs_tkalgo()[iconv][itk];
+        if (algo == 29)
+          addToIndex(lookup.byGsfTrack, cms2.convs_tkidx()[iconv][itk], iconv);
+        if (algo > 3 && algo < 14 && algo != 12)
+          addToIndex(lookup.byCtfTrack, cms2.convs_tkidx()[iconv][itk], iconv);
+      }
+    }
+  }
+
+  bool isGoodConversion(const ConversionInfo &info, int nWrongHitsMax, float probMin, float dlMin, bool requireArbitratedMerged) {
+    bool isGood = info.prob > probMin && info.dl > dlMin;
+    if (requireArbitratedMerged)
+      isGood = info.arbitratedMerged;
+    if (info.maxHitsBeforeVtx > nWrongHitsMax)
+      isGood = false;
+    return isGood;
+  }
+
+  bool hasGoodConversion(const std::vector<std::vector<unsigned int> > &index, int tkidx,
+                         int nWrongHitsMax, float probMin, float dlMin, bool requireArbitratedMerged) {
+    if (tkidx < 0 || (unsigned int)tkidx >= index.size())
+      return false;
+    const std::vector<unsigned int> &list = index[tkidx];
+    for (unsigned int i = 0; i < list.size(); i++) {
+      if (isGoodConversion(lookup.convs[list[i]], nWrongHitsMax, probMin, dlMin, requireArbitratedMerged))
+        return true;
+    }
+    return false;
+  }
+}
 
 bool isMITConversion(unsigned int elidx, 
 		     int nWrongHitsMax, 
@@ -10,50 +97,18 @@ bool isMITConversion(unsigned int elidx,
 		     bool matchCTF,
 		     bool requireArbitratedMerged) {
 
-  unsigned int nconvs = cms2.convs_isConverted().size();
-  if(nconvs == 0) 
-    return false;
-  bool isGoodConversion = false;
-
-  for(unsigned int iconv = 0; iconv < nconvs; iconv++) {
-    
-    bool conversionMatchFound = false;
-    for(unsigned int itk = 0; itk < cms2.convs_tkidx()[iconv].size(); itk++) {
-
-      if(cms2.convs_tkalgo()[iconv][itk] == 29 && cms2.convs_tkidx()[iconv][itk] == cms2.els_gsftrkidx()[elidx])
-	conversionMatchFound = true;
-      if(matchCTF) {
-	if(cms2.convs_tkalgo()[iconv][itk] > 3 && cms2.convs_tkalgo()[iconv][itk] < 14 && cms2.convs_tkalgo()[iconv][itk] != 12 && cms2.convs_tkidx()[iconv][itk] == cms2.els_trkidx()[elidx])
-	  conversionMatchFound = true;
-      }
-    
-      if(conversionMatchFound)
-	break;
-    }
-    
-    
-    if(conversionMatchFound==false)
-      continue;
-    
-    if( TMath::Prob( cms2.convs_chi2()[iconv], (Int_t)cms2.convs_ndof()[iconv] )  > probMin && cms2.convs_dl()[iconv] > dlMin ) isGoodConversion = true;
-    if(requireArbitratedMerged) {
-      if(cms2.convs_quality()[iconv] & 4)
-	isGoodConversion = true;
-      else 
-	isGoodConversion = false;
-    }
+  bool newEvent = isNewEvent(lookup.tag);
+  CORE_PROFILE_CACHE("conversionLookup", !newEvent);
+  if (newEvent)
+    fillConversionLookup();
 
-    for(unsigned int j = 0; j < cms2.convs_nHitsBeforeVtx()[iconv].size(); j++) {
-      if(cms2.convs_nHitsBeforeVtx()[iconv][j] > nWrongHitsMax)
-	isGoodConversion = false;
-    }
-      
-    if(isGoodConversion)
-      break;
-      
-      
-  }//loop over convserions
+  if (lookup.convs.empty())
+    return false;
 
+  if (hasGoodConversion(lookup.byGsfTrack, cms2.els_gsftrkidx()[elidx], nWrongHitsMax, probMin, dlMin, requireArbitratedMerged))
+    return true;
+  if (matchCTF && hasGoodConversion(lookup.byCtfTrack, cms2.els_trkidx()[elidx], nWrongHitsMax, probMin, dlMin, requireArbitratedMerged))
+    return true;
 
-  return isGoodConversion;
+  return false;
 }
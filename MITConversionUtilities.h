@@ -4,6 +4,8 @@
 #include <stdint.h>
 #include <vector>
 
+// conversions are indexed by track once per event, so repeated calls
+// for the electrons of an event only visit the matching conversions
 bool isMITConversion(unsigned int elidx, 
 		     int nWrongHitsMax, 
 		     float probMin,
@@ -1,7 +1,11 @@
 #include "MT2.h"
+#include "../coreProfiler.h"
 #include "math.h"
 #include "Math/VectorUtil.h"
 #include "iostream"
+#include <limits>
+#include <algorithm>
+#include <utility>
 
 using namespace std;
 
@@ -9,12 +13,17 @@ using namespace std;
 // MT2 Calculated with the Bisection method from Cheng & Han //
 ///////////////////////////////////////////////////////////////
 
-// MT2( MET_MAGNITUDE, MET_PHI, P4_LEPTON_1, P4_LEPTON_2, MASS_INVISIBLE_PARTICLE )
-double MT2(
+// pairs whose lower bound is above the running minimum by more than this
+// (relative) margin are not bisected; the margin covers roundoff in the bound
+static const double MT2_BOUND_MARGIN = 1e-9;
+
+// set up the bisection for one pair of visible systems
+static void setMT2Momenta(
+  mt2_bisect::mt2& mt2_event,
   const float met,
   const float metPhi,
-  const ROOT::Math::LorentzVector<ROOT::Math::PxPyPzE4D<float> > v1,
-  const ROOT::Math::LorentzVector<ROOT::Math::PxPyPzE4D<float> > v2,
+  const ROOT::Math::LorentzVector<ROOT::Math::PxPyPzE4D<float> >& v1,
+  const ROOT::Math::LorentzVector<ROOT::Math::PxPyPzE4D<float> >& v2,
   float invisible_particle_mass,
   bool verbose
 ){
@@ -49,22 +58,104 @@ double MT2(
   pmiss[1]  = (double) met*cos(metPhi);
   pmiss[2]  = (double) met*sin(metPhi);
 
-  // instantiate mt2 class, set momenta and mass of invisible particle
-  mt2_bisect::mt2 mt2_event;
+  // set momenta and mass of invisible particle
   mt2_event.set_momenta( pa, pb, pmiss );
   mt2_event.set_mn( invisible_particle_mass );
+}
+
+// MT2( MET_MAGNITUDE, MET_PHI, P4_LEPTON_1, P4_LEPTON_2, MASS_INVISIBLE_PARTICLE )
+double MT2(
+  const float met,
+  const float metPhi,
+  const ROOT::Math::LorentzVector<ROOT::Math::PxPyPzE4D<float> >& v1,
+  const ROOT::Math::LorentzVector<ROOT::Math::PxPyPzE4D<float> >& v2,
+  float invisible_particle_mass,
+  bool verbose
+){
+  CORE_PROFILE_SCOPE("MT2");
+  mt2_bisect::mt2 mt2_event;
+  setMT2Momenta( mt2_event, met, metPhi, v1, v2, invisible_particle_mass, verbose );
 
   //
   return mt2_event.get_mt2();
 }
 
+// MT2( MT2_VALUES, MET_MAGNITUDE, MET_PHI, VECT_P4_1, VECT_P4_2, MASS_INVISIBLE_PARTICLE )
+void MT2(
+  vector<double>& mt2,
+  const float met,
+  const float metPhi,
+  const vector<ROOT::Math::LorentzVector<ROOT::Math::PxPyPzE4D<float> > >& v1,
+  const vector<ROOT::Math::LorentzVector<ROOT::Math::PxPyPzE4D<float> > >& v2,
+  float invisible_particle_mass,
+  bool verbose
+){
+  CORE_PROFILE_SCOPE("MT2 vector");
+  mt2.resize( v1.size() );
+  mt2_bisect::mt2 mt2_event;
+  for(unsigned int i=0; i < v1.size(); i++){
+    setMT2Momenta( mt2_event, met, metPhi, v1[i], v2.at(i), invisible_particle_mass, verbose );
+    mt2[i] = mt2_event.get_mt2();
+  }
+}
+
+// pairs considered and bisections actually run by MT2min since the last reset
+static unsigned long mt2min_npairs      = 0;
+static unsigned long mt2min_nbisections = 0;
+
+void getMT2minCounters( unsigned long& npairs, unsigned long& nbisections ){
+  npairs      = mt2min_npairs;
+  nbisections = mt2min_nbisections;
+}
+
+void resetMT2minCounters(){
+  mt2min_npairs      = 0;
+  mt2min_nbisections = 0;
+}
+
+// MT2min( MET_MAGNITUDE, MET_PHI, VECT_P4_1, VECT_P4_2, MASS_INVISIBLE_PARTICLE )
+double MT2min(
+  const float met,
+  const float metPhi,
+  const vector<ROOT::Math::LorentzVector<ROOT::Math::PxPyPzE4D<float> > >& v1,
+  const vector<ROOT::Math::LorentzVector<ROOT::Math::PxPyPzE4D<float> > >& v2,
+  float invisible_particle_mass,
+  bool verbose
+){
+  CORE_PROFILE_SCOPE("MT2min");
+  double mt2_min = std::numeric_limits<double>::max();
+  mt2_bisect::mt2 mt2_event;
+
+  // visit the pairs in order of increasing lower bound
+  vector<pair<double, unsigned int> > bounds( v1.size() );
+  for(unsigned int i=0; i < v1.size(); i++){
+    setMT2Momenta( mt2_event, met, metPhi, v1[i], v2.at(i), invisible_particle_mass, verbose );
+    bounds[i] = make_pair( mt2_event.get_mt2_lower_bound(), i );
+  }
+  sort( bounds.begin(), bounds.end() );
+
+  mt2min_npairs += v1.size();
+  for(unsigned int k=0; k < bounds.size(); k++){
+    // no remaining pair can beat the running minimum
+    if( bounds[k].first * (1. - MT2_BOUND_MARGIN) > mt2_min ) break;
+    unsigned int i = bounds[k].second;
+    setMT2Momenta( mt2_event, met, metPhi, v1[i], v2[i], invisible_particle_mass, false );
+    double mt2_i = mt2_event.get_mt2();
+    mt2min_nbisections++;
+    if( mt2_i < mt2_min ){
+      mt2_min = mt2_i;
+    }
+  }
+  return mt2_min;
+}
+
 // MT2J( MET_MAGNITUDE, MET_PHI, P4_LEPTON_1, P4_LEPTON_2, VECT_P4_Jets, MASS_INVISIBLE_PARTICLE, MT2_CALCULATION_METHOD )
 double MT2J(
   const float met,
   const float metPhi,
-  const ROOT::Math::LorentzVector<ROOT::Math::PxPyPzE4D<float> > p4_lepton_1,
-  const ROOT::Math::LorentzVector<ROOT::Math::PxPyPzE4D<float> > p4_lepton_2,
-  const vector<ROOT::Math::LorentzVector<ROOT::Math::PxPyPzE4D<float> > > vect_p4_jets,
+  const ROOT::Math::LorentzVector<ROOT::Math::PxPyPzE4D<float> >& p4_lepton_1,
+  const ROOT::Math::LorentzVector<ROOT::Math::PxPyPzE4D<float> >& p4_lepton_2,
+  const vector<ROOT::Math::LorentzVector<ROOT::Math::PxPyPzE4D<float> > >& vect_p4_jets,
   float,
   enum enum_mt2_method method_mt2,
   bool
@@ -73,40 +164,158 @@ double MT2J(
     cout << "MT2.cc: error MT2J called with less than 2 jets... returning mt2 value of -1.0" << endl;
     return -1.0; 
   }
-  double mt2_min = std::numeric_limits<double>::max();
-  for(unsigned int j1=0; j1 < vect_p4_jets.size(); j1++){
-  for(unsigned int j2=0; j2 < vect_p4_jets.size(); j2++){
+  if( method_mt2 != BISECT){
+    cout << "ERROR: Undefined calculation method... returning -1" << endl;
+    return -1.0;
+  }
+
+  // all ordered ( lepton_1 + j1, lepton_2 + j2 ) pairings
+  const unsigned int njets = vect_p4_jets.size();
+  vector<ROOT::Math::LorentzVector<ROOT::Math::PxPyPzE4D<float> > > v1, v2;
+  v1.reserve( njets*(njets-1) );
+  v2.reserve( njets*(njets-1) );
+  for(unsigned int j1=0; j1 < njets; j1++){
+  for(unsigned int j2=0; j2 < njets; j2++){
     if(j1==j2) continue;
-    double mt2_j1_j2;
-    if( method_mt2 == BISECT){
-      mt2_j1_j2 = MT2( met, metPhi, p4_lepton_1 + vect_p4_jets.at(j1), p4_lepton_2 + vect_p4_jets.at(j2) );
-    } else {
-      cout << "ERROR: Undefined calculation method... returning -1" << endl;
-      return -1.0;
-    }
-    if(mt2_j1_j2 < mt2_min){
-      mt2_min = mt2_j1_j2;
-    }
+    v1.push_back( p4_lepton_1 + vect_p4_jets[j1] );
+    v2.push_back( p4_lepton_2 + vect_p4_jets[j2] );
   }}
-  return mt2_min;
+  return MT2min( met, metPhi, v1, v2 );
 }
 
-//////////
-// GRID //
-//////////
-
-//float TMt2::GetMt2j (
-//  const float                 met,
-//  const float                 metPhi,
-//  const LorentzVector         p4_lep1,
-//  const LorentzVector         p4_lep2,
-//  const vector<LorentzVector> v_p4_jets,
-//  const float                 invisible_particle_mass,
-//  const bool                  verbose
-//){
-//  mt2_ = -999.0;
-//  return mt2_;
-//}
+////////////////////////////////////////////////
+// INVISIBLE MOMENTA OF THE MT2 SOLUTION       //
+////////////////////////////////////////////////
+
+namespace {
+
+  // one side, with visible ( m^2, Et, px, py ); Et is the visible transverse
+  // energy sqrt( m^2 + pt^2 ) as in mt2_bisect
+  struct MT2Side {
+    double msq, Et, px, py;
+  };
+
+  // mT^2 of one side with invisible transverse momentum ( qx, qy )
+  inline double mtsq( const MT2Side& v, double mnsq, double qx, double qy ){
+    return v.msq + mnsq + 2 * ( v.Et * sqrt( mnsq + qx*qx + qy*qy ) - v.px * qx - v.py * qy );
+  }
+
+  // interval where a x^2 - 2 b x - d <= 0, for a >= 0; false if it is empty
+  bool quadraticInterval( double a, double b, double d, double& lo, double& hi ){
+    double disc = b*b + a*d;
+    if( disc < 0 ) return false;
+    if( a == 0 ){
+      if( b == 0 ){
+        lo = -HUGE_VAL;
+        hi =  HUGE_VAL;
+        return d >= 0;
+      }
+      double x = -d / ( 2*b );
+      lo = b > 0 ? x : -HUGE_VAL;
+      hi = b > 0 ? HUGE_VAL : x;
+      return true;
+    }
+    // roots ( b +- sqrt( disc ) ) / a, in the form that does not cancel
+    double t  = b + ( b >= 0 ? sqrt( disc ) : -sqrt( disc ) );
+    double x1 = t / a;
+    double x2 = t != 0 ? -d / t : 0;
+    lo = min( x1, x2 );
+    hi = max( x1, x2 );
+    return true;
+  }
+
+  // The region mT^2( q ) <= M^2 of one side, with c = ( M^2 - m^2 - mn^2 ) / 2,
+  // is Et sqrt( mn^2 + q^2 ) <= c + p.q: an ellipse, or a parabola for a
+  // massless visible system. Its extent in qx and its slice in qy at fixed
+  // qx are both intervals where a quadratic is negative.
+  struct MT2Level {
+    MT2Side v;
+    double  mnsq, c;
+    bool qxRange( double& lo, double& hi ) const {
+      return quadraticInterval( v.msq, c * v.px, c*c - ( v.msq + v.px*v.px ) * mnsq, lo, hi );
+    }
+    void qySlice( double qx, double& lo, double& hi ) const {
+      double w = c + v.px * qx;
+      double a = v.msq + v.px*v.px;
+      double b = w * v.py;
+      double d = w*w - v.Et*v.Et * ( mnsq + qx*qx );
+      // at the ends of the qx range the slice is a single point
+      if( !quadraticInterval( a, b, d, lo, hi ) ){
+        lo = a > 0 ? b / a : 0;
+        hi = lo;
+      }
+    }
+  };
+
+  // The regions of side a, in q, and of side b, in pmiss - q, touch at the
+  // MT2 solution. Their overlap in qy at fixed qx, max( lo ) - min( hi ), is
+  // a convex function of qx ( convex lower minus concave upper boundaries ),
+  // and is smallest where the regions touch or overlap the most.
+  struct MT2Overlap {
+    MT2Level a, b;
+    double   pmx, pmy;
+    double operator()( double qx, double& qy ) const {
+      double loa, hia, lob, hib;
+      a.qySlice( qx, loa, hia );
+      b.qySlice( pmx - qx, lob, hib );
+      double lo = max( loa, pmy - hib );
+      double hi = min( hia, pmy - lob );
+      qy = 0.5 * ( lo + hi );
+      return lo - hi;
+    }
+  };
+
+  const int    MT2_MAX_GOLDEN = 200;
+  const double MT2_GOLDEN     = 0.381966011250105151795;
+  const double MT2_TOLERANCE  = 1e-10; // on the split, relative to the event scale
+  const double MT2_FAR        = 1e6;   // open parabolas are cut here, relative to the scale
+  const int    MT2_MAX_WIDEN  = 40;
+
+  // split q at which the regions at level M overlap the most; false if
+  // they do not overlap, i.e. M is below MT2
+  bool mt2Split( const MT2Side& a, const MT2Side& b, double mnsq, double pmx, double pmy,
+                 double M, double scale, double& qx, double& qy ){
+
+    MT2Overlap overlap;
+    overlap.a.v    = a;
+    overlap.a.mnsq = mnsq;
+    overlap.a.c    = 0.5 * ( M*M - a.msq - mnsq );
+    overlap.b.v    = b;
+    overlap.b.mnsq = mnsq;
+    overlap.b.c    = 0.5 * ( M*M - b.msq - mnsq );
+    overlap.pmx    = pmx;
+    overlap.pmy    = pmy;
+
+    double loa, hia, lob, hib;
+    if( !overlap.a.qxRange( loa, hia ) || !overlap.b.qxRange( lob, hib ) ) return false;
+    double lo = max( loa, pmx - hib );
+    double hi = min( hia, pmx - lob );
+    if( lo > hi ) return false;
+    lo = max( lo, -MT2_FAR * scale );
+    hi = min( hi,  MT2_FAR * scale );
+
+    // golden section search of the convex overlap in qx
+    double xa = lo + MT2_GOLDEN * ( hi - lo );
+    double xb = hi - MT2_GOLDEN * ( hi - lo );
+    double fa = overlap( xa, qy );
+    double fb = overlap( xb, qy );
+    for(int i = 0; i < MT2_MAX_GOLDEN && hi - lo > MT2_TOLERANCE * scale; i++){
+      if( fa <= fb ){
+        hi = xb;
+        xb = xa; fb = fa;
+        xa = lo + MT2_GOLDEN * ( hi - lo );
+        fa = overlap( xa, qy );
+      } else {
+        lo = xa;
+        xa = xb; fa = fb;
+        xb = hi - MT2_GOLDEN * ( hi - lo );
+        fb = overlap( xb, qy );
+      }
+    }
+    qx = fa <= fb ? xa : xb;
+    return overlap( qx, qy ) <= 0;
+  }
+}
 
 float TMt2::GetMt2 (
   const float         met,
@@ -120,18 +329,6 @@ float TMt2::GetMt2 (
   //
   mt2_ = -999.0;
 
-  // Check Input
-  if( invisible_particle_mass != 0 ){
-    cout << "ERROR: Non zero invisible particle masses are not implemented... Exiting." << endl;
-    exit(1);
-  }
-  if( grid_spacing_ > grid_size_ ){
-    cout << endl;
-    cout << "ERROR: Grid size must be larger than grid spacing... Exiting." << endl;
-    cout << endl;
-    exit(1);
-  }
-
   // Particle masses... M^2 < 0 sometimes due to floating poing imprecision, leptons are in the massless limit anyway, set M = 0 when M^2 < 0
   double mass1;
   double mass2;
@@ -150,56 +347,58 @@ float TMt2::GetMt2 (
     if(verbose) cout << "p4_lep2.M() < 0... Setting p4_lep2.M() = 0" << endl;
   }
 
+  // MT2 itself comes from the bisection
+  mt2_bisect::mt2 mt2_event;
+  setMT2Momenta( mt2_event, met, metPhi, p4_lep1, p4_lep2, invisible_particle_mass, false );
+  double Min = mt2_event.get_mt2();
+
   // Set transverse quantities 
-  double Et1    = p4_lep1.Et();
-  double Et2    = p4_lep2.Et();
-  double px1    = p4_lep1.Px();
-  double py1    = p4_lep1.Py();
-  double px2    = p4_lep2.Px();
-  double py2    = p4_lep2.Py();
-  double metx   = met*cos(metPhi);
-  double mety   = met*sin(metPhi);
-
-  // Initialize grid variables
-  double EtNu1 = 0;
-  double EtNu2 = 0;
-  double mtsq1 = 0;
-  double mtsq2 = 0;
+  MT2Side a, b;
+  a.msq = mass1 * mass1;
+  a.px  = p4_lep1.Px();
+  a.py  = p4_lep1.Py();
+  a.Et  = sqrt( a.msq + a.px*a.px + a.py*a.py );
+  b.msq = mass2 * mass2;
+  b.px  = p4_lep2.Px();
+  b.py  = p4_lep2.Py();
+  b.Et  = sqrt( b.msq + b.px*b.px + b.py*b.py );
+  double mn   = fabs( invisible_particle_mass );
+  double mnsq = mn * mn;
+  double metx = met*cos(metPhi);
+  double mety = met*sin(metPhi);
+  double scale = max( max( a.Et, b.Et ), max( (double) met, mn ) );
+  if( scale <= 0 ) scale = 1;
+
+  // Unbalanced configurations: the unconstrained minimum of one side, at
+  // q = mn / m * p, already has the larger mT
   double nu1Px = 0;
   double nu1Py = 0;
-  double nu2Px = 0;
-  double nu2Py = 0;
-  double Max   = 0;
-  double Min   = std::numeric_limits<double>::max();
-
-  // Grid Minimization
-  for(int x = ( -1*grid_size_ ); x <= grid_size_; x += grid_spacing_ ){
-  for(int y = ( -1*grid_size_ ); y <= grid_size_; y += grid_spacing_ ){
-      double trial1_Px = x;
-      double trial1_Py = y;
-      double trial2_Px = ( metx - x );
-      double trial2_Py = ( mety - y );
-      EtNu1            = sqrt( pow( trial1_Px, 2 ) + pow( trial1_Py, 2 ) );
-      EtNu2            = sqrt( pow( trial2_Px, 2 ) + pow( trial2_Py, 2 ) );
-      mtsq1            = pow( mass1, 2 ) + 2 * ( Et1 * EtNu1 - px1 * trial1_Px - py1 * trial1_Py );
-      mtsq2            = pow( mass2, 2 ) + 2 * ( Et2 * EtNu2 - px2 * trial2_Px - py2 * trial2_Py );
-      Max              = max( sqrt( mtsq1 ), sqrt( mtsq2 ) );
-      if ( Max < Min ){
-        Min = Max;
-        nu1Px = trial1_Px;
-        nu1Py = trial1_Py;
-        nu2Px = trial2_Px;
-        nu2Py = trial2_Py;
-      }
-  } }
-  if( Min == std::numeric_limits<double>::max() ){
-    cout << "MT2_GRID: Error could not find minimum." << endl;
-    exit(1);
+  if( mass1 > 0 && mtsq( b, mnsq, metx - mn/mass1 * a.px, mety - mn/mass1 * a.py ) <= ( mass1 + mn ) * ( mass1 + mn ) ){
+    nu1Px = mn/mass1 * a.px;
+    nu1Py = mn/mass1 * a.py;
+  }
+  else if( mass2 > 0 && mtsq( a, mnsq, metx - mn/mass2 * b.px, mety - mn/mass2 * b.py ) <= ( mass2 + mn ) * ( mass2 + mn ) ){
+    nu1Px = metx - mn/mass2 * b.px;
+    nu1Py = mety - mn/mass2 * b.py;
+  }
+  else {
+
+    // Balanced: the split where both mT equal MT2. The bisection value can
+    // be below the exact one by its precision ( more in its massless
+    // approximation ), so the level is widened until the regions meet.
+    double level  = max( Min, max( mass1, mass2 ) + mn );
+    double margin = RELATIVE_PRECISION * scale;
+    for(int i = 0; i < MT2_MAX_WIDEN; i++){
+      if( mt2Split( a, b, mnsq, metx, mety, level + margin, scale, nu1Px, nu1Py ) ) break;
+      margin *= 2;
+    }
   }
+  double nu2Px = metx - nu1Px;
+  double nu2Py = mety - nu1Py;
 
-  // Get the ( transverse ) 4-vectors of the neutrinos chosen by MT2
-  p4_nu1_.SetPxPyPzE( nu1Px, nu1Py, 0.0, sqrt( pow( nu1Px, 2) + pow( nu1Py, 2) ) );
-  p4_nu2_.SetPxPyPzE( nu2Px, nu2Py, 0.0, sqrt( pow( nu2Px, 2) + pow( nu2Py, 2) ) );
+  // Get the ( transverse ) 4-vectors of the invisible particles chosen by MT2
+  p4_nu1_.SetPxPyPzE( nu1Px, nu1Py, 0.0, sqrt( mnsq + pow( nu1Px, 2) + pow( nu1Py, 2) ) );
+  p4_nu2_.SetPxPyPzE( nu2Px, nu2Py, 0.0, sqrt( mnsq + pow( nu2Px, 2) + pow( nu2Py, 2) ) );
 
   //
   mt2_ = Min;
@@ -208,9 +407,7 @@ float TMt2::GetMt2 (
 
 // Constructor 
 TMt2::TMt2()  
-  : grid_size_(500)
-  , grid_spacing_(2)
-  , mt2_(-999.0)
+  : mt2_(-999.0)
   , p4_nu1_(0,0,0,0)
   , p4_nu2_(0,0,0,0)
 {
@@ -28,34 +28,61 @@ enum enum_mt2_method { BISECT, GRID };
 double MT2(
   const float,
   const float,
-  const ROOT::Math::LorentzVector<ROOT::Math::PxPyPzE4D<float> >,
-  const ROOT::Math::LorentzVector<ROOT::Math::PxPyPzE4D<float> >,
+  const ROOT::Math::LorentzVector<ROOT::Math::PxPyPzE4D<float> >&,
+  const ROOT::Math::LorentzVector<ROOT::Math::PxPyPzE4D<float> >&,
   float = 0.0,
   bool = false
 );
 
+// MT2 of each ( v1[i], v2[i] ) pair, all sharing one MET
+void MT2(
+  std::vector<double>&,
+  const float,
+  const float,
+  const std::vector<ROOT::Math::LorentzVector<ROOT::Math::PxPyPzE4D<float> > >&,
+  const std::vector<ROOT::Math::LorentzVector<ROOT::Math::PxPyPzE4D<float> > >&,
+  float = 0.0,
+  bool = false
+);
+
+// Smallest MT2 over the ( v1[i], v2[i] ) pairs, all sharing one MET. Pairs
+// are visited in order of increasing lower bound and the search stops once
+// the bound exceeds the best MT2 found.
+double MT2min(
+  const float,
+  const float,
+  const std::vector<ROOT::Math::LorentzVector<ROOT::Math::PxPyPzE4D<float> > >&,
+  const std::vector<ROOT::Math::LorentzVector<ROOT::Math::PxPyPzE4D<float> > >&,
+  float = 0.0,
+  bool = false
+);
+
+// Number of pairs given to MT2min ( and MT2J ) and of bisections actually
+// run, summed since the last reset
+void getMT2minCounters( unsigned long&, unsigned long& );
+void resetMT2minCounters();
+
 // MT2J declaration
 double MT2J(
   const float,
   const float,
-  const ROOT::Math::LorentzVector<ROOT::Math::PxPyPzE4D<float> >,
-  const ROOT::Math::LorentzVector<ROOT::Math::PxPyPzE4D<float> >,
-  const std::vector<ROOT::Math::LorentzVector<ROOT::Math::PxPyPzE4D<float> > >,
+  const ROOT::Math::LorentzVector<ROOT::Math::PxPyPzE4D<float> >&,
+  const ROOT::Math::LorentzVector<ROOT::Math::PxPyPzE4D<float> >&,
+  const std::vector<ROOT::Math::LorentzVector<ROOT::Math::PxPyPzE4D<float> > >&,
   float = 0.0,
   enum_mt2_method = BISECT,
   bool = false
 );
 
-///////////////////////////////////////////////
-// MT2 Calculated Using a Simple Grid Method //
-///////////////////////////////////////////////
+///////////////////////////////////////////////////////////////
+// MT2 from the bisection above and the invisible momenta of //
+// the MET split realizing it, valid for massive invisibles  //
+///////////////////////////////////////////////////////////////
 
 class TMt2 {
 
   private:
     
-    int           grid_size_;
-    int           grid_spacing_;
     float         mt2_;
     LorentzVector p4_nu1_;
     LorentzVector p4_nu2_;
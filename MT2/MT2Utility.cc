@@ -58,6 +58,35 @@ double mt2::get_mt2()
    return mt2_b*scale;
 }
 
+// Value that get_mt2() cannot go below for the current momenta and mn.
+// Cheap, no bisection is run. The larger of
+//  - ma + mn, where mt2_bisect() starts ( mn in mt2_massless() ), and
+//  - a bound from mT_a^2(q) >= masq + mnsq + 2*ka*|q| with ka = Ea - |pa|
+//    ( likewise for b ) and |q_a| + |q_b| >= |pmiss|: the smallest of
+//    max( mT_a, mT_b ) over those lines, less the bisection precision.
+// The second one only helps for massive visible systems, e.g. lepton + b.
+double mt2::get_mt2_lower_bound()
+{
+   if (!momenta_set) return 0;
+
+   if (masq < MIN_MASS && mbsq < MIN_MASS) return sqrt(mnsq)*scale;
+   double bound = sqrt(mnsq + ma*(ma + 2*mn));
+
+   double ka = masq/(Ea + sqrt(pax*pax + pay*pay));
+   double kb = mbsq/(Eb + sqrt(pbx*pbx + pby*pby));
+   double la = masq + mnsq;
+   double lb = mbsq + mnsq;
+   double pmiss = sqrt(pmissxsq + pmissysq);
+   double linesq;
+   if (la >= lb + 2*kb*pmiss)      linesq = la;
+   else if (lb >= la + 2*ka*pmiss) linesq = lb;
+   else                            linesq = (la*kb + lb*ka + 2*ka*kb*pmiss)/(ka + kb);
+
+   double line = sqrt(linesq) - precision;
+   if (line > bound) bound = line;
+   return bound*scale;
+}
+
 void mt2::set_momenta(double* pa0, double* pb0, double* pmiss0)
 {
    solved = false;     //reset solved tag when momenta are changed.
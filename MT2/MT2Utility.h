@@ -24,6 +24,7 @@ class mt2
       void   set_momenta(double *pa0, double *pb0, double* pmiss0);
       void   set_mn(double mn);
       double get_mt2();
+      double get_mt2_lower_bound();
       void   print();
       int    nevt;
    private:  
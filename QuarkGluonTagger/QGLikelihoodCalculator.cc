@@ -1,5 +1,8 @@
 //#include "FWCore/ParameterSet/interface/ParameterSet.h"
 #include "QGLikelihoodCalculator.h"
+#include "TFormula.h"
+#include <algorithm>
+#include <cmath>
 
 using namespace std;
 
@@ -50,6 +53,15 @@ QGLikelihoodCalculator::QGLikelihoodCalculator( const std::string& fileName_nCha
   sjc_ptD_quark_ = new SimpleJetCorrector(*jcp_ptD_quark_);
   sjc_ptD_gluon_ = new SimpleJetCorrector(*jcp_ptD_gluon_);
 
+  pdf_nCharged_quark_.init(*jcp_nCharged_quark_, sjc_nCharged_quark_, true);
+  pdf_nCharged_gluon_.init(*jcp_nCharged_gluon_, sjc_nCharged_gluon_, true);
+
+  pdf_nNeutral_quark_.init(*jcp_nNeutral_quark_, sjc_nNeutral_quark_, true);
+  pdf_nNeutral_gluon_.init(*jcp_nNeutral_gluon_, sjc_nNeutral_gluon_, true);
+
+  pdf_ptD_quark_.init(*jcp_ptD_quark_, sjc_ptD_quark_, false);
+  pdf_ptD_gluon_.init(*jcp_ptD_gluon_, sjc_ptD_gluon_, false);
+
 }
 
 
@@ -78,39 +90,183 @@ float QGLikelihoodCalculator::computeQGLikelihood( float pt, float rhoPF, int nC
 
   //  cout << "pt " << pt << " rhoPF " << rhoPF << " nNeutral " << nNeutral << " nCharged " << nCharged << endl;
 
-  std::vector<float> v_pt_rho;
-  v_pt_rho.push_back( pt );
-  v_pt_rho.push_back( rhoPF );
+  float quarkProb_nCharged = probability(pdf_nCharged_quark_, pt, rhoPF, nCharged);
+  float gluonProb_nCharged = probability(pdf_nCharged_gluon_, pt, rhoPF, nCharged);
 
-  std::vector<float> v_nCharged;
-  v_nCharged.push_back( (float)nCharged );
+  float quarkProb_nNeutral = probability(pdf_nNeutral_quark_, pt, rhoPF, nNeutral);
+  float gluonProb_nNeutral = probability(pdf_nNeutral_gluon_, pt, rhoPF, nNeutral);
 
-  std::vector<float> v_nNeutral;
-  v_nNeutral.push_back( (float)nNeutral );
+  float quarkProb_ptD = probability(pdf_ptD_quark_, pt, rhoPF, ptD);
+  float gluonProb_ptD = probability(pdf_ptD_gluon_, pt, rhoPF, ptD);
 
-  std::vector<float> v_ptD;
-  v_ptD.push_back( ptD );
 
-  //  cout << "== pt " << v_pt_rho.at(0) << " rhoPF " << v_pt_rho.at(1) << " nNeutral " << nNeutral << " nCharged " << nCharged << endl;
-  //  cout << " ciao " << sjc_nCharged_quark_<< endl;
+  float quarkProb = quarkProb_nCharged*quarkProb_nNeutral*quarkProb_ptD;
+  float gluonProb = gluonProb_nCharged*gluonProb_nNeutral*gluonProb_ptD;
 
-  float quarkProb_nCharged = sjc_nCharged_quark_->correction(v_pt_rho, v_nCharged); 
+  float QGLikelihood = (gluonProb+quarkProb>0.) ? quarkProb / (gluonProb + quarkProb ) : -1.;
 
+  return QGLikelihood;
 
-  float gluonProb_nCharged = sjc_nCharged_gluon_->correction(v_pt_rho, v_nCharged);
+}
 
-  float quarkProb_nNeutral = sjc_nNeutral_quark_->correction(v_pt_rho, v_nNeutral);
-  float gluonProb_nNeutral = sjc_nNeutral_gluon_->correction(v_pt_rho, v_nNeutral);
 
-  float quarkProb_ptD = sjc_ptD_quark_->correction(v_pt_rho, v_ptD);
-  float gluonProb_ptD = sjc_ptD_gluon_->correction(v_pt_rho, v_ptD);
+void QGLikelihoodCalculator::computeQGLikelihood( std::vector<float>& qgl, const std::vector<float>& pt, float rhoPF, const std::vector<int>& nCharged, const std::vector<int>& nNeutral, const std::vector<float>& ptD ) {
 
+  qgl.resize(pt.size());
+  for (unsigned int i = 0; i < pt.size(); i++)
+    qgl[i] = computeQGLikelihood(pt[i], rhoPF, nCharged.at(i), nNeutral.at(i), ptD.at(i));
 
-  float quarkProb = quarkProb_nCharged*quarkProb_nNeutral*quarkProb_ptD;
-  float gluonProb = gluonProb_nCharged*gluonProb_nNeutral*gluonProb_ptD;
+}
 
-  float QGLikelihood = (gluonProb+quarkProb>0.) ? quarkProb / (gluonProb + quarkProb ) : -1.;
 
-  return QGLikelihood;
+float QGLikelihoodCalculator::probability( const FlatPDF& pdf, float pt, float rhoPF, float x ) const {
+
+  if (!pdf.isFlat()) {
+    std::vector<float> v_pt_rho;
+    v_pt_rho.push_back( pt );
+    v_pt_rho.push_back( rhoPF );
+    return pdf.corrector()->correction(v_pt_rho, std::vector<float>(1, x));
+  }
+
+  int bin = pdf.bin(pt, rhoPF);
+  if (bin < 0)
+    return 1.;
+  return pdf.value(bin, x);
+
+}
+
+
+float QGLikelihoodCalculator::probability( const FlatPDF& pdf, float pt, float rhoPF, int n ) const {
+
+  if (!pdf.isFlat())
+    return probability(pdf, pt, rhoPF, (float)n);
+
+  int bin = pdf.bin(pt, rhoPF);
+  if (bin < 0)
+    return 1.;
+  return pdf.value(bin, n);
+
+}
+
+
+//
+// FlatPDF
+//
+
+QGLikelihoodCalculator::FlatPDF::FlatPDF() : nParameters_(0), func_(0), sjc_(0) {
+}
+
+
+QGLikelihoodCalculator::FlatPDF::~FlatPDF() {
+
+  delete func_;
+
+}
+
+
+void QGLikelihoodCalculator::FlatPDF::init( const JetCorrectorParameters& jcp, const SimpleJetCorrector* sjc, bool integerVariable ) {
+
+  sjc_ = sjc;
+
+  // only (pt, rho) binned PDFs of one variable are unpacked
+  const JetCorrectorParameters::Definitions& def = jcp.definitions();
+  if (def.nBinVar() != 2 || def.nParVar() != 1 || def.isResponse() || jcp.size() == 0)
+    return;
+
+  TFormula* func = new TFormula("QGL_flat_pdf", def.formula().c_str());
+  nParameters_ = func->GetNpar();
+
+  // bin edges
+  for (unsigned int i = 0; i < jcp.size(); i++) {
+    const JetCorrectorParameters::Record& record = jcp.record(i);
+    if (record.nParameters() != 2 + nParameters_) {
+      delete func;
+      return;
+    }
+    ptEdges_.push_back(record.xMin(0));
+    ptEdges_.push_back(record.xMax(0));
+    rhoEdges_.push_back(record.xMin(1));
+    rhoEdges_.push_back(record.xMax(1));
+  }
+  std::sort(ptEdges_.begin(), ptEdges_.end());
+  ptEdges_.erase(std::unique(ptEdges_.begin(), ptEdges_.end()), ptEdges_.end());
+  std::sort(rhoEdges_.begin(), rhoEdges_.end());
+  rhoEdges_.erase(std::unique(rhoEdges_.begin(), rhoEdges_.end()), rhoEdges_.end());
+
+  // each cell takes the first record covering it, as
+  // JetCorrectorParameters::binIndex does
+  const unsigned int npt  = ptEdges_.size() - 1;
+  const unsigned int nrho = rhoEdges_.size() - 1;
+  cellBin_.assign(npt * nrho, -1);
+  for (unsigned int i = 0; i < jcp.size(); i++) {
+    const JetCorrectorParameters::Record& record = jcp.record(i);
+    unsigned int ipt_lo  = std::lower_bound(ptEdges_.begin(), ptEdges_.end(), record.xMin(0)) - ptEdges_.begin();
+    unsigned int ipt_hi  = std::lower_bound(ptEdges_.begin(), ptEdges_.end(), record.xMax(0)) - ptEdges_.begin();
+    unsigned int irho_lo = std::lower_bound(rhoEdges_.begin(), rhoEdges_.end(), record.xMin(1)) - rhoEdges_.begin();
+    unsigned int irho_hi = std::lower_bound(rhoEdges_.begin(), rhoEdges_.end(), record.xMax(1)) - rhoEdges_.begin();
+    for (unsigned int ipt = ipt_lo; ipt < ipt_hi; ipt++) {
+      for (unsigned int irho = irho_lo; irho < irho_hi; irho++) {
+        if (cellBin_[ipt*nrho+irho] < 0)
+          cellBin_[ipt*nrho+irho] = i;
+      }
+    }
+  }
+
+  // parameters, and the values at each integer for multiplicities
+  xMin_.resize(jcp.size());
+  xMax_.resize(jcp.size());
+  parameters_.resize(jcp.size() * nParameters_);
+  tableOffset_.assign(jcp.size(), -1);
+  for (unsigned int i = 0; i < jcp.size(); i++) {
+    const JetCorrectorParameters::Record& record = jcp.record(i);
+    xMin_[i] = record.parameter(0);
+    xMax_[i] = record.parameter(1);
+    for (unsigned int ipar = 0; ipar < nParameters_; ipar++)
+      parameters_[i*nParameters_+ipar] = record.parameter(2+ipar);
+
+    if (!integerVariable || xMin_[i] != floor(xMin_[i]) || xMax_[i] != floor(xMax_[i]) || xMax_[i] - xMin_[i] > 10000)
+      continue;
+    func->SetParameters(&parameters_[i*nParameters_]);
+    tableOffset_[i] = table_.size();
+    for (float x = xMin_[i]; x <= xMax_[i]; x += 1.)
+      table_.push_back(func->Eval(x));
+  }
+
+  func_ = func;
+
+}
+
+
+int QGLikelihoodCalculator::FlatPDF::bin( float pt, float rho ) const {
+
+  int ipt  = std::upper_bound(ptEdges_.begin(), ptEdges_.end(), pt) - ptEdges_.begin() - 1;
+  int irho = std::upper_bound(rhoEdges_.begin(), rhoEdges_.end(), rho) - rhoEdges_.begin() - 1;
+  const int npt  = ptEdges_.size() - 1;
+  const int nrho = rhoEdges_.size() - 1;
+  if (ipt < 0 || ipt >= npt || irho < 0 || irho >= nrho)
+    return -1;
+  return cellBin_[ipt*nrho+irho];
+
+}
+
+
+float QGLikelihoodCalculator::FlatPDF::value( int bin, float x ) const {
+
+  x = (x < xMin_[bin]) ? xMin_[bin] : (x > xMax_[bin]) ? xMax_[bin] : x;
+  func_->SetParameters(&parameters_[bin*nParameters_]);
+  float result = func_->Eval(x);
+  return result;
+
+}
+
+
+float QGLikelihoodCalculator::FlatPDF::value( int bin, int n ) const {
+
+  if (tableOffset_[bin] < 0)
+    return value(bin, (float)n);
+
+  float x = (float)n;
+  x = (x < xMin_[bin]) ? xMin_[bin] : (x > xMax_[bin]) ? xMax_[bin] : x;
+  return table_[tableOffset_[bin] + int(x - xMin_[bin])];
 
 }
@@ -21,6 +21,8 @@
 #include "../jetcorr/JetCorrectorParameters.h"
 #include "../jetcorr/SimpleJetCorrector.h"
 
+class TFormula;
+
 class QGLikelihoodCalculator {
 
  public:
@@ -30,9 +32,47 @@ class QGLikelihoodCalculator {
    ~QGLikelihoodCalculator();
 
    float computeQGLikelihood( float pt, float rhoPF, int nCharged, int nNeutral, float ptD );
+
+   // same for all the jets of an event
+   void computeQGLikelihood( std::vector<float>& qgl, const std::vector<float>& pt, float rhoPF, const std::vector<int>& nCharged, const std::vector<int>& nNeutral, const std::vector<float>& ptD );
   
  private:
 
+  // One PDF unpacked into flat arrays at construction: the record of each
+  // cell of the (pt, rho) grid spanned by the bin edges, the formula
+  // parameters of each record and, for multiplicities, the PDF value at
+  // every integer in the range of each record. Gives the same values as
+  // SimpleJetCorrector::correction, which is used if the parameters do
+  // not have this layout.
+  class FlatPDF {
+   public:
+    FlatPDF();
+    ~FlatPDF();
+    void init( const JetCorrectorParameters& jcp, const SimpleJetCorrector* sjc, bool integerVariable );
+    int   bin( float pt, float rho ) const;
+    float value( int bin, float x ) const;
+    float value( int bin, int n ) const;
+    bool  isFlat() const { return func_ != 0; }
+    const SimpleJetCorrector* corrector() const { return sjc_; }
+   private:
+    FlatPDF(const FlatPDF&);
+    FlatPDF& operator= (const FlatPDF&);
+    std::vector<float>    ptEdges_;
+    std::vector<float>    rhoEdges_;
+    std::vector<int>      cellBin_;      // [ipt*nrho+irho], -1 if no record
+    std::vector<float>    xMin_;         // [bin]
+    std::vector<float>    xMax_;         // [bin]
+    std::vector<double>   parameters_;   // [bin*nParameters_+ipar]
+    unsigned              nParameters_;
+    std::vector<int>      tableOffset_;  // [bin], -1 if not tabulated
+    std::vector<float>    table_;
+    TFormula*             func_;
+    const SimpleJetCorrector* sjc_;
+  };
+
+  float probability( const FlatPDF& pdf, float pt, float rhoPF, float x ) const;
+  float probability( const FlatPDF& pdf, float pt, float rhoPF, int n ) const;
+
   JetCorrectorParameters *jcp_nCharged_quark_;
   JetCorrectorParameters *jcp_nCharged_gluon_;
   JetCorrectorParameters *jcp_nNeutral_quark_;
@@ -47,6 +87,13 @@ class QGLikelihoodCalculator {
   SimpleJetCorrector *sjc_ptD_quark_;
   SimpleJetCorrector *sjc_ptD_gluon_;
 
+  FlatPDF pdf_nCharged_quark_;
+  FlatPDF pdf_nCharged_gluon_;
+  FlatPDF pdf_nNeutral_quark_;
+  FlatPDF pdf_nNeutral_gluon_;
+  FlatPDF pdf_ptD_quark_;
+  FlatPDF pdf_ptD_gluon_;
+
 };
 
 
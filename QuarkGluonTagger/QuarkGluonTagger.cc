@@ -7,7 +7,7 @@ float getLRM(int ijet , int power) {
   float sum_pt_ri=0;
   float sum_pt=0;
 
-  vector<int> cands = pfjets_pfcandIndicies().at(ijet);
+  const vector<int> &cands = pfjets_pfcandIndicies().at(ijet);
 
   for (unsigned int ivc=0; ivc<cands.size(); ivc++) {
     
@@ -23,13 +23,13 @@ float getLRM(int ijet , int power) {
     if (abs(pfcands_particleId().at(ican))!=11) {
       itrk = pfcands_trkidx().at(ican);
       if( itrk >= (int)trks_trk_p4().size() || itrk < 0 ) continue;
-      dz=trks_dz_pv(itrk,0).first;
+      dz=trks_dz_pv_cached(itrk,0);
     }
 
     if (abs(pfcands_particleId().at(ican))==11 && pfcands_pfelsidx().at(ican)>=0) {
       itrk = els_gsftrkidx().at(pfcands_pfelsidx().at(ican));
       if( itrk >= (int)gsftrks_p4().size() || itrk < 0 ) continue;
-      dz=gsftrks_dz_pv(itrk,0).first;
+      dz=gsftrks_dz_pv_cached(itrk,0);
     }
 
     if(fabs(dz)>0.05) continue; 
@@ -57,7 +57,7 @@ float constituentPtDistribution(int ijet ) {
   float sum_pt2 = 0.;
   float sum_pt  = 0.;  
 
-  vector<int> cands = pfjets_pfcandIndicies().at(ijet);
+  const vector<int> &cands = pfjets_pfcandIndicies().at(ijet);
 
   for (unsigned int ivc=0;ivc<cands.size();ivc++) {
     
@@ -115,3 +115,24 @@ float QGtagger(LorentzVector p4 , int ijet, QGLikelihoodCalculator * qglikeli_)
 }
 
 
+std::vector<float> QGtagger(const std::vector<LorentzVector> &p4s, const std::vector<int> &ijets, QGLikelihoodCalculator * qglikeli_) {
+
+  std::vector<float> qgl(p4s.size(), -1.);
+  double rho = evt_kt6pf_foregiso_rho();
+
+  for (unsigned int i = 0; i < p4s.size(); i++) {
+
+    int ijet = ijets.at(i);
+    int nCharged = pfjets_chargedHadronMultiplicity().at(ijet);
+    int nNeutral = pfjets_neutralHadronMultiplicity().at(ijet)+pfjets_photonMultiplicity().at(ijet);
+    if (nCharged + nNeutral <= 0)
+      continue;
+
+    double corPt = p4s[i].pt();
+    if( fabs(p4s[i].eta())<2.5  && corPt>20)
+      qgl[i] = qglikeli_->computeQGLikelihood(corPt,rho,nCharged,nNeutral,constituentPtDistribution(ijet));
+  }
+
+  return qgl;
+
+}
@@ -34,6 +34,9 @@ float getLRM (int ijet , int power);
 float constituentPtDistribution(int ijet);
 
 float QGtagger(LorentzVector p4 ,int ijet, QGLikelihoodCalculator * );
+
+// same for several jets at once: p4s are the corrected jets, ijets their pfjets indices
+std::vector<float> QGtagger(const std::vector<LorentzVector> &p4s, const std::vector<int> &ijets, QGLikelihoodCalculator * );
  
 
 #endif
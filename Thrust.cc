@@ -1,22 +1,66 @@
 // $Id: Thrust.cc,v 1.2 2013/01/28 23:44:26 kelley Exp $
 #include "./Thrust.h"
+#include "./coreProfiler.h"
+#include <algorithm>
+#include <utility>
 
 const double pi = TMath::Pi(), pi2 = 2 * TMath::Pi(), pi_2 = TMath::Pi() / 2, pi_4 = TMath::Pi() / 4;
 
 void Thrust::init(const std::vector<LorentzVector> & inputVectors) {
+  CORE_PROFILE_SCOPE("Thrust");
   int i = 0;
 
   //  for(std::vector<const Candidate*>::const_iterator t = cands.begin(); t != cands.end(); ++t, ++i) pSum_ += (p_[i] = (*t)->momentum()).r();
   //  for (unsigned int ivc=0;ivc<cands.size();ivc++) pSum_ += pfcands_p4().at(ican).pt();
 
-  for (unsigned int ivc=0; ivc<inputVectors.size(); ivc++, i++) p_[i] = XYZVector(inputVectors.at(ivc).Vect());
-  for (unsigned int ivc=0; ivc<inputVectors.size(); ivc++) pSum_ += XYZVector(inputVectors.at(ivc).Vect()).r();    
+  for (unsigned int ivc=0; ivc<inputVectors.size(); ivc++, i++) {
+    XYZVector p(inputVectors[ivc].Vect());
+    px_[i] = p.x();
+    py_[i] = p.y();
+    pz_[i] = p.z();
+    pSum_ += p.r();
+  }
 
   axis_ = axis(finalAxis(initialAxis()));
   if (axis_.z() < 0) axis_ *= -1;
   thrust_ = thrust(axis_);
 }
 
+// In the transverse plane the thrust axis is parallel to the sum of the
+// momenta on one side of some line through the origin. With every momentum
+// folded into the upper half plane and sorted by angle, each such side is a
+// run of the sorted list, so all candidates follow from one sweep.
+void Thrust::initTransverse(const std::vector<LorentzVector> & inputVectors) {
+  CORE_PROFILE_SCOPE("Thrust transverse");
+  std::vector<std::pair<double, unsigned int> > order(n_);
+  double sumx = 0, sumy = 0;
+  for (unsigned int i = 0; i < n_; ++i) {
+    double x = inputVectors[i].Px(), y = inputVectors[i].Py();
+    pSum_ += sqrt(x*x + y*y);
+    if (y < 0 || (y == 0 && x < 0)) { x = -x; y = -y; }
+    px_[i] = x;
+    py_[i] = y;
+    pz_[i] = 0;
+    sumx += x;
+    sumy += y;
+    order[i] = std::make_pair(atan2(y, x), i);
+  }
+  std::sort(order.begin(), order.end());
+
+  // flip the momenta one by one in angular order
+  double bestx = sumx, besty = sumy, best = sumx*sumx + sumy*sumy;
+  for (unsigned int k = 0; k < n_; ++k) {
+    unsigned int i = order[k].second;
+    sumx -= 2 * px_[i];
+    sumy -= 2 * py_[i];
+    double mag2 = sumx*sumx + sumy*sumy;
+    if (mag2 > best) { best = mag2; bestx = sumx; besty = sumy; }
+  }
+
+  if (best > 0) axis_ = XYZVector(bestx, besty, 0) / sqrt(best);
+  if (pSum_ > 0) thrust_ = sqrt(best) / pSum_;
+}
+
 Thrust::ThetaPhi Thrust::initialAxis() const {
   static const int nSegsTheta = 10, nSegsPhi = 10, nSegs = nSegsTheta * nSegsPhi;
   int i, j;
@@ -143,8 +187,9 @@ Thrust::XYZVector Thrust::axis(double theta, double phi) const {
 double Thrust::thrust(const XYZVector & ax) const {
   double result = 0;
   double sum = 0;
+  const double ax_x = ax.x(), ax_y = ax.y(), ax_z = ax.z();
   for (unsigned int i = 0; i < n_; ++i)
-    sum += fabs(ax.Dot(p_[i]));
+    sum += fabs(ax_x * px_[i] + ax_y * py_[i] + ax_z * pz_[i]);
   if (pSum_ > 0) result = sum / pSum_;
   return result;
 }
@@ -14,9 +14,6 @@
 #include "TMatrixDSym.h"
 #include "TVectorD.h"
 
-// CMS2                                                                                                                                                    
-#include "./CMS2.h"
-
 //#include "Utils.h"                                                                                                                                       
 
 #include "./utilities.h"
@@ -36,12 +33,15 @@ class Thrust {
 
   /// constructor from first and last iterators
   //  template<typename const_iterator>
-  Thrust(const std::vector<LorentzVector> & inputVec) :
+  /// with transverse = true the thrust of the transverse momenta is
+  /// computed exactly, and the axis lies in the transverse plane
+  Thrust(const std::vector<LorentzVector> & inputVec, bool transverse = false) :
     thrust_(0), axis_(0, 0, 0), pSum_(0), 
-    n_(inputVec.size()), p_(n_) {
+    n_(inputVec.size()), px_(n_), py_(n_), pz_(n_) {
     if (n_ == 0) return;
     
-    init(inputVec);
+    if (transverse) initTransverse(inputVec);
+    else init(inputVec);
     
   } 
 
@@ -55,7 +55,8 @@ class Thrust {
     XYZVector axis_;
     double pSum_;
     const unsigned int n_;
-    std::vector<XYZVector> p_;
+    // momentum components kept in separate arrays for the thrust(axis) loop
+    std::vector<double> px_, py_, pz_;
 
     struct ThetaPhi {
       ThetaPhi(double t, double p) : theta( t ), phi( p ) { }
@@ -71,6 +72,7 @@ class Thrust {
     void parabola(double & a, double & b, double & c, 
 		  const XYZVector &, const XYZVector &, const XYZVector &) const;
     void init(const std::vector<LorentzVector> & inputVectors);
+    void initTransverse(const std::vector<LorentzVector> & inputVectors);
 };
 
 #endif
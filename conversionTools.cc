@@ -1,5 +1,6 @@
 #include "CMS2.h"
 #include "conversionTools.h"
+#include "coreProfiler.h"
 
 
 using namespace std;
@@ -51,6 +52,7 @@ ConversionInfo::~ConversionInfo()
 std::vector<ConversionInfo> getConversionInfos(const int gsfElectronIdx,                
                            const double bFieldAtOrigin,
                            const double minFracSharedHits) {
+    CORE_PROFILE_SCOPE("getConversionInfos");
 
 
     //the electron's CTF track must share at least 45% of the inner hits
@@ -0,0 +1,145 @@
+// compiles to an empty object unless -DCORE_PROFILE is given
+#include "coreProfiler.h"
+
+#ifdef CORE_PROFILE
+
+#include <time.h>
+#include <cstdio>
+#include <iomanip>
+#include <map>
+#include <vector>
+
+using namespace std;
+
+namespace {
+
+    struct TraceEvent {
+        const coreprofile::Counter* counter;
+        double start;
+        double duration;
+    };
+
+    // map nodes never move, so the counters can be held by reference
+    map<string, coreprofile::Counter>& counters() {
+        static map<string, coreprofile::Counter> counters;
+        return counters;
+    }
+
+    bool                traceOn        = false;
+    unsigned long       traceMaxEvents = 0;
+    unsigned long       traceDropped   = 0;
+    vector<TraceEvent>  traceEvents;
+
+    // json string contents; counter names are plain identifiers
+    // but may contain "::"
+    string jsonEscape(const string& s) {
+        string out;
+        for (unsigned int i = 0; i < s.size(); i++) {
+            if (s[i] == '"' || s[i] == '\\')
+                out += '\\';
+            out += s[i];
+        }
+        return out;
+    }
+}
+
+namespace coreprofile {
+
+    Counter& counter(const char* name) {
+        Counter& c = counters()[name];
+        c.name = name;
+        return c;
+    }
+
+    double now() {
+        static timespec start;
+        static bool started = false;
+        timespec t;
+        clock_gettime(CLOCK_MONOTONIC, &t);
+        if (!started) {
+            start = t;
+            started = true;
+        }
+        return (t.tv_sec - start.tv_sec) + 1.e-9 * (t.tv_nsec - start.tv_nsec);
+    }
+
+    void setTrace(bool enable, unsigned long maxEvents) {
+        traceOn = enable;
+        traceMaxEvents = maxEvents;
+    }
+
+    bool traceEnabled() {
+        return traceOn;
+    }
+
+    void addTraceEvent(const Counter& counter, double start, double duration) {
+        if (traceEvents.size() >= traceMaxEvents) {
+            traceDropped++;
+            return;
+        }
+        TraceEvent event = { &counter, start, duration };
+        traceEvents.push_back(event);
+    }
+
+    bool writeTrace(const char* filename) {
+        FILE *f = fopen(filename, "w");
+        if (f == 0) {
+            cout << "[coreprofile::writeTrace] ERROR - cannot open " << filename << endl;
+            return false;
+        }
+
+        // complete ("X") events, times in microseconds
+        fprintf(f, "{\"traceEvents\":[\n");
+        for (unsigned int i = 0; i < traceEvents.size(); i++) {
+            fprintf(f, "%s{\"name\":\"%s\",\"cat\":\"CORE\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":0,\"tid\":0}\n",
+                    i == 0 ? "" : ",", jsonEscape(traceEvents[i].counter->name).c_str(),
+                    1.e6 * traceEvents[i].start, 1.e6 * traceEvents[i].duration);
+        }
+        fprintf(f, "],\"displayTimeUnit\":\"ns\"}\n");
+        fclose(f);
+
+        if (traceDropped > 0)
+            cout << "[coreprofile::writeTrace] WARNING - " << traceDropped << " events beyond the limit were not recorded" << endl;
+        return true;
+    }
+
+    void report(ostream& out) {
+        out << "CORE profile report" << endl;
+        out << setw(40) << left << "name"
+            << setw(14) << right << "calls"
+            << setw(14) << "total [s]"
+            << setw(14) << "mean [us]"
+            << setw(12) << "hits"
+            << setw(12) << "misses"
+            << setw(10) << "hit rate" << endl;
+
+        for (map<string, Counter>::const_iterator it = counters().begin(); it != counters().end(); ++it) {
+            const Counter &c = it->second;
+            out << setw(40) << left << c.name << right;
+            if (c.calls > 0)
+                out << setw(14) << c.calls
+                    << setw(14) << setprecision(4) << c.seconds
+                    << setw(14) << setprecision(4) << 1.e6 * c.seconds / c.calls;
+            else
+                out << setw(42) << "";
+            if (c.hits + c.misses > 0)
+                out << setw(12) << c.hits
+                    << setw(12) << c.misses
+                    << setw(10) << setprecision(3) << double(c.hits) / (c.hits + c.misses);
+            out << endl;
+        }
+    }
+
+    void reset() {
+        for (map<string, Counter>::iterator it = counters().begin(); it != counters().end(); ++it) {
+            it->second.calls   = 0;
+            it->second.seconds = 0.;
+            it->second.hits    = 0;
+            it->second.misses  = 0;
+        }
+        traceEvents.clear();
+        traceDropped = 0;
+    }
+}
+
+#endif
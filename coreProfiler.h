@@ -0,0 +1,86 @@
+#ifndef COREPROFILER_H
+#define COREPROFILER_H
+
+//---------------------------------------------------------
+// Opt-in instrumentation of the CORE hot paths. It is
+// compiled in only with -DCORE_PROFILE; otherwise the
+// macros below expand to nothing.
+//
+//   CORE_PROFILE_SCOPE("name")       times the enclosing scope
+//   CORE_PROFILE_CACHE("name", hit)  counts a cache hit or miss
+//
+// Times are inclusive of nested instrumented calls. At the
+// end of the job call coreprofile::report() and, if
+// coreprofile::setTrace(true) was called, writeTrace().
+//---------------------------------------------------------
+
+#ifdef CORE_PROFILE
+
+#include <iostream>
+#include <string>
+
+namespace coreprofile {
+
+    struct Counter {
+        Counter() : calls(0), seconds(0.), hits(0), misses(0) {}
+        std::string name;
+        unsigned long calls;
+        double seconds;
+        unsigned long hits;
+        unsigned long misses;
+    };
+
+    // counter registered under name, created on first use; the
+    // reference stays valid for the whole job
+    Counter& counter(const char* name);
+
+    // seconds since the first call, monotonic
+    double now();
+
+    // Chrome trace-format events are recorded while enabled, up
+    // to maxEvents; open the output in chrome://tracing or Perfetto
+    void setTrace(bool enable, unsigned long maxEvents = 1000000);
+    bool traceEnabled();
+    void addTraceEvent(const Counter& counter, double start, double duration);
+    bool writeTrace(const char* filename);
+
+    void report(std::ostream& out = std::cout);
+    void reset();
+
+    class ScopedTimer {
+    public:
+        ScopedTimer(Counter& counter) : counter_(counter), start_(now()) {}
+        ~ScopedTimer() {
+            double duration = now() - start_;
+            counter_.calls++;
+            counter_.seconds += duration;
+            if (traceEnabled())
+                addTraceEvent(counter_, start_, duration);
+        }
+    private:
+        Counter& counter_;
+        double start_;
+    };
+}
+
+#define CORE_PROFILE_CONCAT_(a, b) a ## b
+#define CORE_PROFILE_CONCAT(a, b) CORE_PROFILE_CONCAT_(a, b)
+
+#define CORE_PROFILE_SCOPE(name)                                                                        \
+    static coreprofile::Counter& CORE_PROFILE_CONCAT(core_profile_counter_, __LINE__) = coreprofile::counter(name); \
+    coreprofile::ScopedTimer CORE_PROFILE_CONCAT(core_profile_timer_, __LINE__)(CORE_PROFILE_CONCAT(core_profile_counter_, __LINE__))
+
+#define CORE_PROFILE_CACHE(name, hit)                                                                   \
+    do {                                                                                                \
+        static coreprofile::Counter& core_profile_cache_ = coreprofile::counter(name);                 \
+        if (hit) core_profile_cache_.hits++; else core_profile_cache_.misses++;                        \
+    } while (0)
+
+#else
+
+#define CORE_PROFILE_SCOPE(name)
+#define CORE_PROFILE_CACHE(name, hit) do {} while (0)
+
+#endif
+
+#endif
@@ -0,0 +1,189 @@
+#include <ctime>
+#include <iomanip>
+#include <stdexcept>
+
+#include "cutFlow.h"
+
+using namespace std;
+
+// cuts timed fewer times than this use the declared cost
+static const unsigned long MIN_TIMED = 10;
+
+CutFlow::CutFlow(bool adaptive, unsigned int reorder_every, unsigned int time_every)
+    : adaptive_(adaptive), reorderEvery_(reorder_every), timeEvery_(time_every), nCalls_(0), nPassedAll_(0)
+{
+}
+
+CutFlow::~CutFlow()
+{
+    for (unsigned int i = 0; i < cuts_.size(); i++)
+        delete cuts_[i].cut;
+}
+
+void CutFlow::addCut(const string& name, CutFlowCut* cut, double cost, const vector<string>& depends_on)
+{
+    Entry entry;
+    entry.name       = name;
+    entry.cut        = cut;
+    entry.cost       = cost;
+    entry.nEvaluated = 0;
+    entry.nPassed    = 0;
+    entry.nTimed     = 0;
+    entry.cpuTime    = 0.;
+
+    for (unsigned int i = 0; i < depends_on.size(); i++) {
+        unsigned int idep = 0;
+        while (idep < cuts_.size() && cuts_[idep].name != depends_on[i])
+            idep++;
+        if (idep == cuts_.size()) {
+            delete cut;
+            throw invalid_argument("[CutFlow::addCut] ERROR - " + name + " depends on unknown cut " + depends_on[i]);
+        }
+        entry.depends.push_back(idep);
+    }
+
+    cuts_.push_back(entry);
+    order_.push_back(cuts_.size() - 1);
+}
+
+void CutFlow::addCut(const string& name, bool (*function)(int), double cost, const vector<string>& depends_on, bool negate)
+{
+    addCut(name, new CutFlowFunction(function, negate), cost, depends_on);
+}
+
+bool CutFlow::pass(int idx)
+{
+    if (adaptive_ && nCalls_ > 0 && reorderEvery_ > 0 && nCalls_ % reorderEvery_ == 0)
+        reorder();
+    bool timed = timeEvery_ > 0 && nCalls_ % timeEvery_ == 0;
+    nCalls_++;
+
+    for (unsigned int i = 0; i < order_.size(); i++) {
+        Entry &entry = cuts_[order_[i]];
+
+        bool passed;
+        if (timed) {
+            clock_t start = clock();
+            passed = entry.cut->pass(idx);
+            entry.cpuTime += double(clock() - start) / CLOCKS_PER_SEC;
+            entry.nTimed++;
+        } else {
+            passed = entry.cut->pass(idx);
+        }
+
+        entry.nEvaluated++;
+        if (!passed)
+            return false;
+        entry.nPassed++;
+    }
+
+    nPassedAll_++;
+    return true;
+}
+
+//
+// expected cost of evaluating the cut, in seconds, per
+// unit of rejection; cuts without enough statistics use
+// their declared cost converted with secondsPerCost
+//
+double CutFlow::expectedCost(unsigned int icut, double secondsPerCost) const
+{
+    const Entry &entry = cuts_[icut];
+
+    double time = entry.cost * secondsPerCost;
+    if (entry.nTimed >= MIN_TIMED)
+        time = entry.cpuTime / entry.nTimed;
+
+    // rejection with one pseudo pass and one pseudo failure
+    double rejection = double(entry.nEvaluated - entry.nPassed + 1) / (entry.nEvaluated + 2);
+    return time / rejection;
+}
+
+//
+// greedy order: among the cuts whose dependencies are
+// already placed, take the one with the lowest expected
+// cost per rejection; ties keep the declaration order
+//
+void CutFlow::reorder()
+{
+    double measuredTime = 0.;
+    double measuredCost = 0.;
+    for (unsigned int i = 0; i < cuts_.size(); i++) {
+        if (cuts_[i].nTimed < MIN_TIMED)
+            continue;
+        measuredTime += cuts_[i].cpuTime / cuts_[i].nTimed;
+        measuredCost += cuts_[i].cost;
+    }
+    double secondsPerCost = (measuredCost > 0. && measuredTime > 0.) ? measuredTime / measuredCost : 1.;
+
+    vector<bool> placed(cuts_.size(), false);
+    order_.clear();
+    while (order_.size() < cuts_.size()) {
+        int best = -1;
+        double bestCost = 0.;
+        for (unsigned int i = 0; i < cuts_.size(); i++) {
+            if (placed[i])
+                continue;
+
+            bool ready = true;
+            for (unsigned int j = 0; j < cuts_[i].depends.size(); j++) {
+                if (!placed[cuts_[i].depends[j]])
+                    ready = false;
+            }
+            if (!ready)
+                continue;
+
+            double cost = expectedCost(i, secondsPerCost);
+            if (best < 0 || cost < bestCost) {
+                best = i;
+                bestCost = cost;
+            }
+        }
+
+        // dependencies always point to earlier cuts, so one is ready
+        placed[best] = true;
+        order_.push_back(best);
+    }
+}
+
+void CutFlow::reset()
+{
+    for (unsigned int i = 0; i < cuts_.size(); i++) {
+        cuts_[i].nEvaluated = 0;
+        cuts_[i].nPassed    = 0;
+        cuts_[i].nTimed     = 0;
+        cuts_[i].cpuTime    = 0.;
+    }
+    nCalls_     = 0;
+    nPassedAll_ = 0;
+}
+
+double CutFlow::cpuTime(unsigned int icut) const
+{
+    const Entry &entry = cuts_.at(icut);
+    return entry.nTimed > 0 ? entry.cpuTime * entry.nEvaluated / entry.nTimed : 0.;
+}
+
+void CutFlow::print(ostream& out) const
+{
+    out << "CutFlow: " << nPassedAll_ << " of " << nCalls_ << " passed" << endl;
+    out << setw(24) << left << "cut"
+        << setw(12) << right << "evaluated"
+        << setw(12) << "passed"
+        << setw(10) << "eff"
+        << setw(14) << "cpu [s]"
+        << setw(16) << "cpu/call [us]" << endl;
+
+    for (unsigned int i = 0; i < order_.size(); i++) {
+        const Entry &entry = cuts_[order_[i]];
+        double eff     = entry.nEvaluated > 0 ? double(entry.nPassed) / entry.nEvaluated : 0.;
+        double cpu     = cpuTime(order_[i]);
+        double perCall = nCalls_ > 0 ? 1.e6 * cpu / nCalls_ : 0.;
+        out << setw(24) << left << entry.name
+            << setw(12) << right << entry.nEvaluated
+            << setw(12) << entry.nPassed
+            << setw(10) << setprecision(4) << eff
+            << setw(14) << setprecision(4) << cpu
+            << setw(16) << setprecision(4) << perCall << endl;
+    }
+}
@@ -0,0 +1,169 @@
+#ifndef CUTFLOW_H
+#define CUTFLOW_H
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+//---------------------------------------------------------
+// one named cut of a CutFlow, evaluated for an index
+// (usually a hypothesis index). CutFlowFunction, CutFlowFunctor
+// and makeCutFlowCut below cover functions of the index,
+// functors, and CORE functions with up to two more bound
+// arguments, each optionally negated into a veto; derive
+// from it only for cuts that fit none of those
+//---------------------------------------------------------
+class CutFlowCut {
+public:
+    virtual ~CutFlowCut() {}
+    virtual bool pass(int idx) = 0;
+};
+
+// cut from a function of the index alone; negate turns it into a veto
+class CutFlowFunction : public CutFlowCut {
+public:
+    CutFlowFunction(bool (*function)(int), bool negate = false) : function_(function), negate_(negate) {}
+    bool pass(int idx) { return function_(idx) != negate_; }
+private:
+    bool (*function_)(int);
+    bool negate_;
+};
+
+// cut from any functor with bool operator()(int), e.g.
+//   std::bind2nd(std::ptr_fun(samesign::isNumeratorHypothesis), true)
+template <class F>
+class CutFlowFunctor : public CutFlowCut {
+public:
+    CutFlowFunctor(const F& functor, bool negate = false) : functor_(functor), negate_(negate) {}
+    bool pass(int idx) { return functor_(idx) != negate_; }
+private:
+    F functor_;
+    bool negate_;
+};
+
+// cuts from CORE functions taking the index and further arguments,
+// which are bound when the cut is made; see makeCutFlowCut below
+template <class A1>
+class CutFlowBind1 : public CutFlowCut {
+public:
+    CutFlowBind1(bool (*function)(int, A1), A1 a1, bool negate = false) : function_(function), a1_(a1), negate_(negate) {}
+    bool pass(int idx) { return function_(idx, a1_) != negate_; }
+private:
+    bool (*function_)(int, A1);
+    A1 a1_;
+    bool negate_;
+};
+
+template <class A1, class A2>
+class CutFlowBind2 : public CutFlowCut {
+public:
+    CutFlowBind2(bool (*function)(int, A1, A2), A1 a1, A2 a2, bool negate = false) : function_(function), a1_(a1), a2_(a2), negate_(negate) {}
+    bool pass(int idx) { return function_(idx, a1_, a2_) != negate_; }
+private:
+    bool (*function_)(int, A1, A2);
+    A1 a1_;
+    A2 a2_;
+    bool negate_;
+};
+
+// the bound argument types come from the function alone, so literals
+// such as 20. for a float argument do not clash
+template <class T> struct CutFlowArg { typedef T type; };
+
+//
+// e.g.
+//   flow.addCut("numerator", makeCutFlowCut(samesign::isNumeratorHypothesis, true));
+//   flow.addCut("no extra Z", makeCutFlowCut(samesign::makesExtraZ, true, true));
+//
+// Functions of something other than the index, such as
+// samesign::passesTrigger(hyp_type, analysis_type), or returning a
+// count, such as nJets, need a small CutFlowCut or functor of their own.
+//
+template <class A1>
+CutFlowCut* makeCutFlowCut(bool (*function)(int, A1), typename CutFlowArg<A1>::type a1, bool negate = false)
+{
+    return new CutFlowBind1<A1>(function, a1, negate);
+}
+
+template <class A1, class A2>
+CutFlowCut* makeCutFlowCut(bool (*function)(int, A1, A2), typename CutFlowArg<A1>::type a1, typename CutFlowArg<A2>::type a2, bool negate = false)
+{
+    return new CutFlowBind2<A1, A2>(function, a1, a2, negate);
+}
+
+template <class F>
+CutFlowCut* makeCutFlowFunctor(const F& functor, bool negate = false)
+{
+    return new CutFlowFunctor<F>(functor, negate);
+}
+
+//---------------------------------------------------------
+// Ordered chain of named cuts, evaluated with short
+// circuit. Each cut has an estimated relative cost and
+// may depend on other cuts, which then always run before
+// it. In adaptive mode the order is recomputed every
+// reorder_every calls from the observed pass rates and
+// CPU times, putting cheap, high rejection cuts first.
+// The pass decision does not depend on the order.
+//
+// Reading the CPU clock costs about as much as a cheap
+// cut, so the cuts are timed only on every time_every-th
+// call; 0 turns timing off and the declared costs are used.
+//---------------------------------------------------------
+class CutFlow {
+public:
+    CutFlow(bool adaptive = true, unsigned int reorder_every = 1000, unsigned int time_every = 64);
+    ~CutFlow();
+
+    // the CutFlow takes ownership of cut
+    void addCut(const std::string& name, CutFlowCut* cut, double cost = 1.,
+                const std::vector<std::string>& depends_on = std::vector<std::string>());
+    // negate makes the function a veto
+    void addCut(const std::string& name, bool (*function)(int), double cost = 1.,
+                const std::vector<std::string>& depends_on = std::vector<std::string>(), bool negate = false);
+
+    // true if idx passes all cuts
+    bool pass(int idx);
+
+    // order the cuts from the current estimates
+    void reorder();
+
+    void reset();
+    void print(std::ostream& out = std::cout) const;
+
+    unsigned int nCuts() const { return cuts_.size(); }
+    const std::vector<unsigned int>& order() const { return order_; }
+    unsigned long nEvaluated(unsigned int icut) const { return cuts_.at(icut).nEvaluated; }
+    unsigned long nPassed(unsigned int icut) const { return cuts_.at(icut).nPassed; }
+    unsigned long nTimed(unsigned int icut) const { return cuts_.at(icut).nTimed; }
+    // estimated from the timed evaluations
+    double cpuTime(unsigned int icut) const;
+
+private:
+    struct Entry {
+        std::string name;
+        CutFlowCut* cut;
+        double cost;                        // declared relative cost
+        std::vector<unsigned int> depends;  // indices of the cuts it depends on
+        unsigned long nEvaluated;
+        unsigned long nPassed;
+        unsigned long nTimed;
+        double cpuTime;                     // seconds, timed evaluations only
+    };
+
+    double expectedCost(unsigned int icut, double secondsPerCost) const;
+
+    std::vector<Entry> cuts_;
+    std::vector<unsigned int> order_;
+    bool adaptive_;
+    unsigned int reorderEvery_;
+    unsigned int timeEvery_;
+    unsigned long nCalls_;
+    unsigned long nPassedAll_;
+
+    // no copies, the cuts are owned
+    CutFlow(const CutFlow&);
+    CutFlow& operator=(const CutFlow&);
+};
+
+#endif
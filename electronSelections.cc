@@ -7,10 +7,12 @@
 
 // CMS2 includes
 #include "electronSelections.h"
+#include "coreProfiler.h"
 #include "eventSelections.h"
 #include "MITConversionUtilities.h"
 #include "muonSelections.h"
 #include "trackSelections.h"
+#include "utilities.h"
 
 using namespace std;
 using namespace tas;
@@ -30,6 +32,7 @@ bool pass_electronSelection( const unsigned int index, const cuts_t selectionTyp
 
 cuts_t electronSelection( const unsigned int index, bool applyAlignmentCorrection, bool removedEtaCutInEndcap, bool useGsfTrack) {
 
+    CORE_PROFILE_SCOPE("electronSelection");
     // keep track of which cuts passed
     cuts_t cuts_passed = 0;
 
@@ -1188,74 +1191,49 @@ float electronIsoValuePF2012_FastJetEffArea_v3(int index, float conesize, int iv
     return pfiso;
 }
 
+// |eta| bins of the effective areas: <= 1.0, (1.0, 1.479], (1.479, 2.0],
+// (2.0, 2.2], (2.2, 2.3], (2.3, 2.4], > 2.4
+static const double fastJetEffAreaEtaEdges[6] = { 1.0, 1.479, 2.0, 2.2, 2.3, 2.4 };
+
+static float fastJetEffArea(const float eta, const float (&areas)[7])
+{
+	// use absolute eta
+    const float etaAbs = fabs(eta);
+    if (etaAbs != etaAbs)
+        return -9999.0f;
+    return areas[binAbove(etaAbs, fastJetEffAreaEtaEdges)];
+}
+
 // calculate Effective area (updated to value from Egamma)
 // https://twiki.cern.ch/twiki/bin/viewauth/CMS/EgammaEARhoCorrection
 // Topic revision: r12 - 28-Nov-2012
+static const float fastJetEffAreas03_v2[7] = { 0.13, 0.14, 0.07, 0.09, 0.11, 0.11, 0.14 };
+static const float fastJetEffAreas04_v2[7] = { 0.21, 0.21, 0.11, 0.14, 0.18, 0.19, 0.26 };
+
 float fastJetEffArea03_v2(const float eta)
 {
-	// use absolute eta
-    const float etaAbs = fabs(eta);
-
-    // get effective area
-    if      (etaAbs <= 1.0                  ) {return 0.13;}
-    else if (etaAbs > 1.0 && etaAbs <= 1.479) {return 0.14;}
-    else if (etaAbs > 1.479 && etaAbs <= 2.0) {return 0.07;}
-    else if (etaAbs > 2.0 && etaAbs <= 2.2  ) {return 0.09;}
-    else if (etaAbs > 2.2 && etaAbs <= 2.3  ) {return 0.11;}
-    else if (etaAbs > 2.3 && etaAbs <= 2.4  ) {return 0.11;}
-    else if (etaAbs > 2.4                   ) {return 0.14;}
-    return -9999.0f;
+    return fastJetEffArea(eta, fastJetEffAreas03_v2);
 }
 
 float fastJetEffArea04_v2(const float eta)
 {
-	// use absolute eta
-    const float etaAbs = fabs(eta);
-
-    // get effective area
-    if      (etaAbs <= 1.0                  ) {return 0.21;}
-    else if (etaAbs > 1.0 && etaAbs <= 1.479) {return 0.21;}
-    else if (etaAbs > 1.479 && etaAbs <= 2.0) {return 0.11;}
-    else if (etaAbs > 2.0 && etaAbs <= 2.2  ) {return 0.14;}
-    else if (etaAbs > 2.2 && etaAbs <= 2.3  ) {return 0.18;}
-    else if (etaAbs > 2.3 && etaAbs <= 2.4  ) {return 0.19;}
-    else if (etaAbs > 2.4                   ) {return 0.26;}
-    return -9999.0f;
+    return fastJetEffArea(eta, fastJetEffAreas04_v2);
 }
 
 // calculate Effective area (updated to value from Egamma)
 // https://twiki.cern.ch/twiki/bin/viewauth/CMS/EgammaEARhoCorrection
 // Topic revision: r10 - 11-Apr-2012
+static const float fastJetEffAreas03_v1[7] = { 0.10, 0.12, 0.085, 0.11, 0.12, 0.12, 0.13 };
+static const float fastJetEffAreas04_v1[7] = { 0.19, 0.25, 0.12, 0.21, 0.27, 0.44, 0.52 };
+
 float fastJetEffArea03_v1(const float eta)
 {
-	// use absolute eta
-    const float etaAbs = fabs(eta);
-
-    // get effective area
-    if      (etaAbs <= 1.0                  ) {return 0.10; }
-    else if (etaAbs > 1.0 && etaAbs <= 1.479) {return 0.12; }
-    else if (etaAbs > 1.479 && etaAbs <= 2.0) {return 0.085;}
-    else if (etaAbs > 2.0 && etaAbs <= 2.2  ) {return 0.11; }
-    else if (etaAbs > 2.2 && etaAbs <= 2.3  ) {return 0.12; }
-    else if (etaAbs > 2.3 && etaAbs <= 2.4  ) {return 0.12; }
-    else if (etaAbs > 2.4                   ) {return 0.13; }
-    return -9999.0f;
+    return fastJetEffArea(eta, fastJetEffAreas03_v1);
 }
 
 float fastJetEffArea04_v1(const float eta)
 {
-	// use absolute eta
-    const float etaAbs = fabs(eta);
-
-    // get effective area
-    if      (etaAbs <= 1.0                  ) {return 0.19;}
-    else if (etaAbs > 1.0 && etaAbs <= 1.479) {return 0.25;}
-    else if (etaAbs > 1.479 && etaAbs <= 2.0) {return 0.12;}
-    else if (etaAbs > 2.0 && etaAbs <= 2.2  ) {return 0.21;}
-    else if (etaAbs > 2.2 && etaAbs <= 2.3  ) {return 0.27;}
-    else if (etaAbs > 2.3 && etaAbs <= 2.4  ) {return 0.44;}
-    else if (etaAbs > 2.4                   ) {return 0.52;}
-    return -9999.0f;
+    return fastJetEffArea(eta, fastJetEffAreas04_v1);
 }
 
 // VBTF stuff
@@ -1485,6 +1463,7 @@ float electronIsolation_rel_FastJet( const unsigned int index, bool use_calo_iso
 
 // Relative Isolation, Non-Truncated
 float electronIsolation_rel_v1( const unsigned int index, bool use_calo_iso ) {
+    CORE_PROFILE_SCOPE("electronIsolation_rel_v1");
     float pt               = cms2.els_p4().at(index).pt();          // Electron Pt
     float TRCK_sum_over_pt = cms2.els_tkIso().at(index) / pt;       // Tracker Relative Isolation, Non-Truncated
     float ECAL_sum_over_pt = electronIsolation_ECAL_rel_v1(index);  // ECAL    Relative Isolation, Non-Truncated
@@ -1579,6 +1558,7 @@ float electronIsolation_rel_ww( const unsigned int index, bool use_calo_iso ) {
 
 #ifdef PFISOFROMNTUPLE
 float electronIsoValuePF( const unsigned int iel, unsigned int ivtx, float coner, float minptn, float dzcut, float footprintdr, float gammastripveto, float elestripveto, int filterId ) {
+  CORE_PROFILE_SCOPE("electronIsoValuePF");
   if (fabs(coner-0.3)<0.0001) {
     if (cms2.els_iso03_pf().at(iel)<-99.) return 9999.;
     return cms2.els_iso03_pf().at(iel)/cms2.els_p4().at(iel).pt();
@@ -1592,6 +1572,7 @@ float electronIsoValuePF( const unsigned int iel, unsigned int ivtx, float coner
 }
 #else
 float electronIsoValuePF( const unsigned int iel, unsigned int ivtx, float coner, float minptn, float dzcut, float footprintdr, float gammastripveto, float elestripveto, int filterId ) {
+  CORE_PROFILE_SCOPE("electronIsoValuePF");
 
   int elgsftkid = cms2.els_gsftrkidx().at(iel);
   int eltkid = cms2.els_trkidx().at(iel);
@@ -1899,14 +1880,30 @@ double electron_d0PV_mindz(unsigned int index){
 // 2012 PF Isolation
 //
 
-void electronIsoValuePF2012(float &pfiso_ch, float &pfiso_em, float &pfiso_nh, const float R, const unsigned int iel, const int ivtx, bool barrelVetoes)
+// Sums the PF isolation of electron iel in ncones cones from a single pass
+// over the PF candidates. The footprint vetoes are those of
+// electronIsoValuePF2012, applied to the cones flagged in vetoes (or to
+// all cones if footprintVetoes and no flags are given); the neutral
+// thresholds (if given) are those of electronIsoValuePF2012reco.
+static void electronIsoValuePF2012_cones(float *pfiso_ch, float *pfiso_em, float *pfiso_nh, const float *R, const float *neutral_threshold, const std::vector<bool> *vetoes,
+                                         const unsigned int ncones, const unsigned int iel, const int ivtx, bool footprintVetoes, bool barrelVetoes)
 {
+    CORE_PROFILE_SCOPE("electronIsoValuePF2012");
 
     // isolation sums
-    pfiso_ch = 0.0;
-    pfiso_em = 0.0; 
-    pfiso_nh = 0.0;
-       
+    float maxR = 0.0;
+    bool anyVetoes = false;
+    for (unsigned int icone = 0; icone < ncones; ++icone) {
+        pfiso_ch[icone] = 0.0;
+        pfiso_em[icone] = 0.0;
+        pfiso_nh[icone] = 0.0;
+        maxR = std::max(maxR, R[icone]);
+        anyVetoes = anyVetoes || (vetoes ? (*vetoes)[icone] : footprintVetoes);
+    }
+
+    // footprint vetoes apply in the endcap, and optionally in the barrel
+    const bool vetoRegion = anyVetoes && (!(cms2.els_fiduciality()[iel] & (1<<ISEB)) || (barrelVetoes && cms2.els_mva()[iel] < -0.1));
+
     // loop on pfcandidates
     for (unsigned int ipf = 0; ipf < cms2.pfcands_p4().size(); ++ipf) {
             
@@ -1917,7 +1914,7 @@ void electronIsoValuePF2012(float &pfiso_ch, float &pfiso_em, float &pfiso_nh, c
     
         // deltaR between electron and cadidate
         const float dR = ROOT::Math::VectorUtil::DeltaR(cms2.pfcands_p4()[ipf], cms2.els_p4()[iel]);
-        if (dR > R)              continue;
+        if (dR > maxR)           continue;
 
         // charged hadrons closest vertex
         // should be the primary vertex
@@ -1926,64 +1923,77 @@ void electronIsoValuePF2012(float &pfiso_ch, float &pfiso_em, float &pfiso_nh, c
             if (pfVertexIndex != ivtx) continue;
         }
 
-        // endcap region
-        if (!(cms2.els_fiduciality()[iel] & (1<<ISEB))) {
-            if (particleId == 211 && dR <= 0.015)   continue;
-            if (particleId == 22  && dR <= 0.08)    continue;
-        } else if (barrelVetoes && cms2.els_mva()[iel] < -0.1) {
-            if (particleId == 211 && dR <= 0.015)   continue;
-            if (particleId == 22  && dR <= 0.08)    continue;            
-        }
+        // footprint vetoes
+        const bool inFootprint = vetoRegion && ((particleId == 211 && dR <= 0.015) || (particleId == 22 && dR <= 0.08));
 
-        // add to isolation sum
-        if (particleId == 211)      pfiso_ch += cms2.pfcands_p4()[ipf].pt();
-        if (particleId == 22)       pfiso_em += cms2.pfcands_p4()[ipf].pt();
-        if (particleId == 130)      pfiso_nh += cms2.pfcands_p4()[ipf].pt();
+        const float pt = cms2.pfcands_p4()[ipf].pt();
+        for (unsigned int icone = 0; icone < ncones; ++icone) {
+
+            if (dR > R[icone])   continue;
+            if (inFootprint && (vetoes ? (*vetoes)[icone] : footprintVetoes))
+                continue;
 
+            // apply threshold to neutrals
+            if (neutral_threshold != 0 && (particleId == 22 || particleId == 130)) {
+                if (pt < neutral_threshold[icone])
+                    continue;
+            }
+
+            // add to isolation sum
+            if (particleId == 211)      pfiso_ch[icone] += pt;
+            if (particleId == 22)       pfiso_em[icone] += pt;
+            if (particleId == 130)      pfiso_nh[icone] += pt;
+        }
     }
 
 }
 
-void electronIsoValuePF2012reco(float &pfiso_ch, float &pfiso_em, float &pfiso_nh, const float R, const unsigned int iel, const int ivtx, float neutral_threshold)
+void electronIsoValuePF2012(float &pfiso_ch, float &pfiso_em, float &pfiso_nh, const float R, const unsigned int iel, const int ivtx, bool barrelVetoes)
 {
+    electronIsoValuePF2012_cones(&pfiso_ch, &pfiso_em, &pfiso_nh, &R, 0, 0, 1, iel, ivtx, true, barrelVetoes);
+}
 
-    // isolation sums
-    pfiso_ch = 0.0;
-    pfiso_em = 0.0; 
-    pfiso_nh = 0.0;
-       
-    // loop on pfcandidates
-    for (unsigned int ipf = 0; ipf < cms2.pfcands_p4().size(); ++ipf) {
-            
-        // skip electrons and muons
-        const int particleId = abs(cms2.pfcands_particleId()[ipf]);
-        if (particleId == 11)    continue;
-        if (particleId == 13)    continue;
-    
-        // deltaR between electron and cadidate
-        const float dR = ROOT::Math::VectorUtil::DeltaR(cms2.pfcands_p4()[ipf], cms2.els_p4()[iel]);
-        if (dR > R)              continue;
-
-        // charged hadrons closest vertex
-        // should be the primary vertex
-        if (particleId == 211) {
-            int pfVertexIndex = cms2.pfcands_vtxidx().at(ipf); 
-            if (pfVertexIndex != ivtx) continue;
-        }
+void electronIsoValuePF2012(std::vector<float> &pfiso_ch, std::vector<float> &pfiso_em, std::vector<float> &pfiso_nh, const std::vector<float> &R, const unsigned int iel, const int ivtx, bool barrelVetoes)
+{
+    pfiso_ch.resize(R.size());
+    pfiso_em.resize(R.size());
+    pfiso_nh.resize(R.size());
+    if (R.empty())
+        return;
+    electronIsoValuePF2012_cones(&pfiso_ch[0], &pfiso_em[0], &pfiso_nh[0], &R[0], 0, 0, R.size(), iel, ivtx, true, barrelVetoes);
+}
 
-        // apply threshold to neutrals
-        if (particleId == 22 || particleId == 130) {
-            if (cms2.pfcands_p4()[ipf].pt() < neutral_threshold)
-                continue;
-        }
+void electronIsoValuePF2012(std::vector<float> &pfiso_ch, std::vector<float> &pfiso_em, std::vector<float> &pfiso_nh, const std::vector<float> &R, const std::vector<float> &neutral_threshold, const std::vector<bool> &vetoes, const unsigned int iel, const int ivtx, bool barrelVetoes)
+{
+    if (neutral_threshold.size() != R.size() || vetoes.size() != R.size()) {
+        cout << "electronIsoValuePF2012: need one neutral threshold and veto flag per cone" << endl;
+        return;
+    }
+    pfiso_ch.resize(R.size());
+    pfiso_em.resize(R.size());
+    pfiso_nh.resize(R.size());
+    if (R.empty())
+        return;
+    electronIsoValuePF2012_cones(&pfiso_ch[0], &pfiso_em[0], &pfiso_nh[0], &R[0], &neutral_threshold[0], &vetoes, R.size(), iel, ivtx, false, barrelVetoes);
+}
 
-        // add to isolation sum
-        if (particleId == 211)      pfiso_ch += cms2.pfcands_p4()[ipf].pt();
-        if (particleId == 22)       pfiso_em += cms2.pfcands_p4()[ipf].pt();
-        if (particleId == 130)      pfiso_nh += cms2.pfcands_p4()[ipf].pt();
+void electronIsoValuePF2012reco(float &pfiso_ch, float &pfiso_em, float &pfiso_nh, const float R, const unsigned int iel, const int ivtx, float neutral_threshold)
+{
+    electronIsoValuePF2012_cones(&pfiso_ch, &pfiso_em, &pfiso_nh, &R, &neutral_threshold, 0, 1, iel, ivtx, false, false);
+}
 
+void electronIsoValuePF2012reco(std::vector<float> &pfiso_ch, std::vector<float> &pfiso_em, std::vector<float> &pfiso_nh, const std::vector<float> &R, const unsigned int iel, const int ivtx, const std::vector<float> &neutral_threshold)
+{
+    if (neutral_threshold.size() != R.size()) {
+        cout << "electronIsoValuePF2012reco: need one neutral threshold per cone" << endl;
+        return;
     }
-
+    pfiso_ch.resize(R.size());
+    pfiso_em.resize(R.size());
+    pfiso_nh.resize(R.size());
+    if (R.empty())
+        return;
+    electronIsoValuePF2012_cones(&pfiso_ch[0], &pfiso_em[0], &pfiso_nh[0], &R[0], &neutral_threshold[0], 0, R.size(), iel, ivtx, false, false);
 }
 
 float electronRadialIsolation(int index, float &chiso, float &nhiso, float &emiso, float neutral_et_threshold, float cone_size, bool barrelVetoes, bool verbose)
@@ -1164,6 +1164,12 @@ double dzPV(const LorentzVector& vtx, const LorentzVector& p4, const LorentzVect
 
 void electronIsoValuePF2012(float &pfiso_ch, float &pfiso_em, float &pfiso_nh, const float R, const unsigned int iel, const int ivtx, bool barrelVetoes = false);
 void electronIsoValuePF2012reco(float &pfiso_ch, float &pfiso_em, float &pfiso_nh, const float R, const unsigned int iel, const int ivtx, float neutral_threshold = 0.5);
+// same as above for several cone sizes (and neutral thresholds) at once,
+// from a single pass over the PF candidates; the sums are returned per cone
+void electronIsoValuePF2012(std::vector<float> &pfiso_ch, std::vector<float> &pfiso_em, std::vector<float> &pfiso_nh, const std::vector<float> &R, const unsigned int iel, const int ivtx, bool barrelVetoes = false);
+void electronIsoValuePF2012reco(std::vector<float> &pfiso_ch, std::vector<float> &pfiso_em, std::vector<float> &pfiso_nh, const std::vector<float> &R, const unsigned int iel, const int ivtx, const std::vector<float> &neutral_threshold);
+// and with each cone's own neutral threshold and footprint veto flag
+void electronIsoValuePF2012(std::vector<float> &pfiso_ch, std::vector<float> &pfiso_em, std::vector<float> &pfiso_nh, const std::vector<float> &R, const std::vector<float> &neutral_threshold, const std::vector<bool> &vetoes, const unsigned int iel, const int ivtx, bool barrelVetoes = false);
 float electronIsoValuePF2012_FastJetEffArea( int index , float conesize = 0.3, int ivtx = 0);
 float electronIsoValuePF2012_FastJetEffArea_v2(int index, float conesize = 0.3, int ivtx = 0, bool useOldIsolation = false);
 float electronIsoValuePF2012_FastJetEffArea_v3(int index, float conesize = 0.3, int ivtx = 0, bool useOldIsolation = false);
@@ -1,6 +1,7 @@
 // $Id: jetSelections.cc,v 1.42 2013/08/11 20:01:47 kelley Exp $
 
 #include <algorithm>
+#include <deque>
 #include <utility>
 #include "Math/VectorUtil.h"
 #include "jetSelections.h"
@@ -10,7 +11,9 @@
 #include "jetcorr/SimpleJetCorrector.icc"
 #include "jetcorr/JetCorrectionUncertainty.icc"
 #include "jetcorr/SimpleJetCorrectionUncertainty.icc"
+#include "jetsmear/JetSmearer.h"
 #include "utilities.h"
+#include "coreProfiler.h"
 
 using std::vector;
 using std::pair;
@@ -38,7 +41,7 @@ float getJetMetSyst(int flag, float pt, float eta) {
   float result;
   const int nBinsEta = 2 ;
   const int nBinsPt = 10 ;
-  float uncert[nBinsEta][nBinsPt] =
+  static const float uncert[nBinsEta][nBinsPt] =
     {
       { 12.0,  7.5,  6.3,  4.7,  3.7,  2.7,  2.6,  2.5,  2.4,  2.3  },
       { 20.0,  17.2, 14.5,  10.7,  7.9,  6.9,  6.0,  5.2,  4.7,  4.4  }
@@ -62,156 +65,527 @@ float getJetMetSyst(int flag, float pt, float eta) {
 
 
 
-// function to give us the indices of jets passing kinematic and cleaning cuts
-static jets_with_corr_t getJets_fast (unsigned int i_hyp, enum JetType type, enum CleaningType cleaning,
-                                      double deltaR, double min_pt, double max_eta, double rescale = 1.0, int systFlag = 0)
+// jet collection of a jet type
+static const vector<LorentzVector>& jetCollection (enum JetType type)
 {
-    // JPT, PF or calo jets?  Introduce this variable so we only have to decide once
-    const vector<LorentzVector> *jets = 0;
     switch (type) {
+#if haveGEN	  
+    case JETS_TYPE_GEN:
+        return cms2.genjets_p4();
+#endif
     case JETS_TYPE_CALO_CORR: case JETS_TYPE_CALO_UNCORR:
-        jets = &cms2.jets_p4();
+        return cms2.jets_p4();
+    default:
+        return cms2.pfjets_p4();
+    }
+}
+
+// ntuple jet energy correction of jet i, 1 for the uncorrected types
+static double jetBaseCorrection (unsigned int i, enum JetType type)
+{
+    switch (type) {
+    case JETS_TYPE_CALO_CORR:
+        return cms2.jets_cor().at(i);
+    case JETS_TYPE_PF_CORR:
+        return cms2.pfjets_cor().at(i);
+    case JETS_TYPE_PF_FAST_CORR:
+        return cms2.pfjets_corL1FastL2L3().at(i);
+    case JETS_TYPE_PF_FAST_CORR_RESIDUAL:
+        return cms2.pfjets_corL1FastL2L3residual().at(i);
+    default:
+        return 1;
+    }
+}
+
+// correction factor of jet i used for the pt cut and the returned p4
+static double jetScale (unsigned int i, enum JetType type, double rescale, int systFlag)
+{
+    double corr = 1;
+    // CALO_CORR and PF_CORR need to be pt-corrected
+    switch (type) {
+    case JETS_TYPE_CALO_CORR:
+        corr = cms2.jets_cor().at(i) * rescale * getJetMetSyst(systFlag, cms2.jets_p4().at(i).pt(), cms2.jets_p4().at(i).eta());
+        break;
+    case JETS_TYPE_PF_CORR:
+//        corr = cms2.pfjets_cor().at(i) * rescale * getJetMetSyst(systFlag, cms2.pfjets_p4().at(i).pt(), cms2.pfjets_p4().at(i).eta());
+        corr = cms2.pfjets_cor().at(i) * rescale * getJetMetSyst(systFlag, cms2.pfjets_p4().at(i).pt() * cms2.pfjets_cor().at(i), cms2.pfjets_p4().at(i).eta());
+        break;
+    case JETS_TYPE_PF_FAST_CORR:
+//        corr = cms2.pfjets_corL1FastL2L3().at(i) * rescale * getJetMetSyst(systFlag, cms2.pfjets_p4().at(i).pt(), cms2.pfjets_p4().at(i).eta());
+        corr = cms2.pfjets_corL1FastL2L3().at(i) * rescale * getJetMetSyst(systFlag, cms2.pfjets_p4().at(i).pt() * cms2.pfjets_corL1FastL2L3().at(i), cms2.pfjets_p4().at(i).eta());
         break;
-    case JETS_TYPE_PF_CORR: case JETS_TYPE_PF_UNCORR: case JETS_TYPE_PF_FAST_CORR: case JETS_TYPE_PF_FAST_CORR_RESIDUAL:
-        jets = &cms2.pfjets_p4();
+    case JETS_TYPE_PF_FAST_CORR_RESIDUAL:
+//        corr = cms2.pfjets_corL1FastL2L3residual().at(i) * rescale * getJetMetSyst(systFlag, cms2.pfjets_p4().at(i).pt(), cms2.pfjets_p4().at(i).eta());
+        corr = cms2.pfjets_corL1FastL2L3residual().at(i) * rescale * getJetMetSyst(systFlag, cms2.pfjets_p4().at(i).pt() * cms2.pfjets_corL1FastL2L3residual().at(i), cms2.pfjets_p4().at(i).eta());
         break;
+    case JETS_TYPE_CALO_UNCORR: 
+    case JETS_TYPE_PF_UNCORR:
 #if haveGEN	  
     case JETS_TYPE_GEN:
-        jets = &cms2.genjets_p4();
-        break;
 #endif
+        corr = rescale;
+        break;
+    }
+    return corr;
+}
+
+//
+// Per-event Delta R between the jets of a collection and the reco
+// electrons and muons, one row of nJets values per lepton (electrons
+// first), with the float arithmetic of VectorUtil::DeltaR(jet, lepton).
+// The overlap masks derived from it are cached per lepton and cone, so
+// all hypotheses and selection calls of the event share them.
+//
+namespace {
+
+    struct CachedJetMask {
+        unsigned int row;
+        double deltaR;
+        bool inclusive;
+        JetMask mask;
+    };
+
+    struct JetLeptonTable {
+        JetLeptonTable() : jets(0), nJets(0), nEls(0) {}
+        EventTag tag;
+        const vector<LorentzVector> *jets;
+        unsigned int nJets;
+        unsigned int nEls;
+        vector<float> dr;                   // [row * nJets + ijet]
+        std::deque<CachedJetMask> masks;    // deque: references stay valid
+    };
+
+    JetLeptonTable& jetLeptonTable(const vector<LorentzVector> &jets)
+    {
+        // one table per jet collection (pf, calo, gen) and one for
+        // p4LeptonOverlapMask
+        static JetLeptonTable tables[4];
+        JetLeptonTable *table = &tables[0];
+        for (unsigned int i = 0; i < 4; i++) {
+            if (tables[i].jets == &jets || tables[i].jets == 0) {
+                table = &tables[i];
+                break;
+            }
+        }
+
+        bool cached = !isNewEvent(table->tag) && table->jets == &jets;
+        CORE_PROFILE_CACHE("jetLeptonTable", cached);
+        if (cached)
+            return *table;
+
+        table->jets  = &jets;
+        table->nJets = jets.size();
+        table->nEls  = cms2.els_p4().size();
+        table->masks.clear();
+
+        unsigned int nJets = table->nJets;
+        unsigned int nLeps = table->nEls + cms2.mus_p4().size();
+        vector<float> jet_eta(nJets), jet_phi(nJets);
+        for (unsigned int j = 0; j < nJets; j++) {
+            jet_eta[j] = jets[j].eta();
+            jet_phi[j] = jets[j].phi();
+        }
+
+        table->dr.resize(nLeps * nJets);
+        for (unsigned int r = 0; r < nLeps; r++) {
+            const LorentzVector &lep = r < table->nEls ? cms2.els_p4()[r] : cms2.mus_p4()[r - table->nEls];
+            const float lep_eta = lep.eta();
+            const float lep_phi = lep.phi();
+            float *row = nJets > 0 ? &table->dr[r * nJets] : 0;
+            for (unsigned int j = 0; j < nJets; j++)
+                row[j] = deltaRFromEtaPhi(jet_eta[j], jet_phi[j], lep_eta, lep_phi);
+        }
+        return *table;
+    }
+
+    unsigned int jetLeptonRow(const JetLeptonTable &table, int lep_id, unsigned int lep_idx)
+    {
+        return abs(lep_id) == 11 ? lep_idx : table.nEls + lep_idx;
+    }
+
+    const JetMask& cachedJetMask(JetLeptonTable &table, unsigned int row, double deltaR, bool inclusive)
+    {
+        for (unsigned int i = 0; i < table.masks.size(); i++) {
+            const CachedJetMask &cached = table.masks[i];
+            if (cached.row == row && cached.deltaR == deltaR && cached.inclusive == inclusive)
+                return cached.mask;
+        }
+
+        table.masks.push_back(CachedJetMask());
+        CachedJetMask &entry = table.masks.back();
+        entry.row       = row;
+        entry.deltaR    = deltaR;
+        entry.inclusive = inclusive;
+        entry.mask.assign((table.nJets + 63) / 64, 0);
+        if (table.nJets == 0)
+            return entry.mask;
+        const float *dr = &table.dr.at(row * table.nJets);
+        for (unsigned int j = 0; j < table.nJets; j++) {
+            bool overlaps = inclusive ? !(dr[j] > deltaR) : dr[j] < deltaR;
+            if (overlaps)
+                entry.mask[j >> 6] |= ULong64_t(1) << (j & 63);
+        }
+        return entry.mask;
+    }
+
+    // adds the jets within deltaR of a hypothesis lepton; its row of the
+    // table is used if the hypothesis p4 is that of the els/mus entry
+    void orHypLeptonMask(JetMask &mask, const vector<LorentzVector> &jets, int id, int idx, const LorentzVector &p4, double deltaR)
+    {
+        const LorentzVector *lep = 0;
+        if (abs(id) == 11)
+            lep = &cms2.els_p4().at(idx);
+        else if (abs(id) == 13)
+            lep = &cms2.mus_p4().at(idx);
+
+        if (lep != 0 && *lep == p4) {
+            JetLeptonTable &table = jetLeptonTable(jets);
+            const JetMask &lep_mask = cachedJetMask(table, jetLeptonRow(table, id, idx), deltaR, false);
+            for (unsigned int w = 0; w < mask.size(); w++)
+                mask[w] |= lep_mask[w];
+            return;
+        }
+        for (unsigned int j = 0; j < jets.size(); j++) {
+            if (ROOT::Math::VectorUtil::DeltaR(jets[j], p4) < deltaR)
+                mask[j >> 6] |= ULong64_t(1) << (j & 63);
+        }
+    }
+
+    // lepton cleaning of one selection call; the mask is built when the
+    // first jet reaches the cleaning step
+    class JetCleaner {
+    public:
+        JetCleaner(const vector<LorentzVector> &jets, unsigned int i_hyp, enum CleaningType cleaning, double deltaR)
+            : jets_(jets), i_hyp_(i_hyp), cleaning_(cleaning), deltaR_(deltaR), built_(false) {}
+
+        bool removes(unsigned int ijet)
+        {
+            if (cleaning_ == JETS_CLEAN_NONE)
+                return false;
+            if (!built_)
+                build();
+            return jetMaskTest(mask_, ijet);
+        }
+
+    private:
+        void build()
+        {
+            built_ = true;
+            mask_.assign((jets_.size() + 63) / 64, 0);
+            switch (cleaning_) {
+            case JETS_CLEAN_HYP_E_MU:
+                orHypLeptonMask(mask_, jets_, cms2.hyp_lt_id().at(i_hyp_), cms2.hyp_lt_index().at(i_hyp_), cms2.hyp_lt_p4().at(i_hyp_), deltaR_);
+                orHypLeptonMask(mask_, jets_, cms2.hyp_ll_id().at(i_hyp_), cms2.hyp_ll_index().at(i_hyp_), cms2.hyp_ll_p4().at(i_hyp_), deltaR_);
+                break;
+            case JETS_CLEAN_HYP_E:
+                if (abs(cms2.hyp_lt_id().at(i_hyp_)) == 11)
+                    orHypLeptonMask(mask_, jets_, 11, cms2.hyp_lt_index().at(i_hyp_), cms2.hyp_lt_p4().at(i_hyp_), deltaR_);
+                if (abs(cms2.hyp_ll_id().at(i_hyp_)) == 11)
+                    orHypLeptonMask(mask_, jets_, 11, cms2.hyp_ll_index().at(i_hyp_), cms2.hyp_ll_p4().at(i_hyp_), deltaR_);
+                break;
+            case JETS_CLEAN_SINGLE_E:
+                orHypLeptonMask(mask_, jets_, 11, i_hyp_, cms2.els_p4().at(i_hyp_), deltaR_);
+                break;
+            case JETS_CLEAN_SINGLE_MU:
+                orHypLeptonMask(mask_, jets_, 13, i_hyp_, cms2.mus_p4().at(i_hyp_), deltaR_);
+                break;
+            default:
+                assert(false);
+            }
+        }
+
+        const vector<LorentzVector> &jets_;
+        unsigned int i_hyp_;
+        enum CleaningType cleaning_;
+        double deltaR_;
+        bool built_;
+        JetMask mask_;
+    };
+}
+
+const JetMask& jetLeptonOverlapMask (enum JetType type, int lep_id, unsigned int lep_idx, double deltaR, bool inclusive)
+{
+    return p4LeptonOverlapMask(jetCollection(type), lep_id, lep_idx, deltaR, inclusive);
+}
+
+const JetMask& p4LeptonOverlapMask (const vector<LorentzVector> &p4s, int lep_id, unsigned int lep_idx, double deltaR, bool inclusive)
+{
+    JetLeptonTable &table = jetLeptonTable(p4s);
+    return cachedJetMask(table, jetLeptonRow(table, lep_id, lep_idx), deltaR, inclusive);
+}
+
+void addJetOverlaps (JetMask &overlaps, enum JetType type, const vector<LorentzVector> &leps, double deltaR, bool inclusive)
+{
+    const vector<LorentzVector> &jets = jetCollection(type);
+    if (overlaps.empty())
+        overlaps.resize((jets.size() + 63) / 64, 0);
+    for (unsigned int l = 0; l < leps.size(); l++) {
+        int lep_id = 0;
+        unsigned int lep_idx = 0;
+        for (unsigned int i = 0; lep_id == 0 && i < cms2.els_p4().size(); i++) {
+            if (cms2.els_p4()[i] == leps[l]) { lep_id = 11; lep_idx = i; }
+        }
+        for (unsigned int i = 0; lep_id == 0 && i < cms2.mus_p4().size(); i++) {
+            if (cms2.mus_p4()[i] == leps[l]) { lep_id = 13; lep_idx = i; }
+        }
+        if (lep_id != 0) {
+            addJetOverlaps(overlaps, jetLeptonOverlapMask(type, lep_id, lep_idx, deltaR, inclusive));
+            continue;
+        }
+        for (unsigned int j = 0; j < jets.size(); j++) {
+            double dr = ROOT::Math::VectorUtil::DeltaR(jets[j], leps[l]);
+            if (inclusive ? !(dr > deltaR) : dr < deltaR)
+                overlaps[j >> 6] |= ULong64_t(1) << (j & 63);
+        }
     }
+}
+
+// the part of the jet selection that does not depend on the jet energy
+// scale: max |eta|, lepton cleaning and jet ID
+static bool jetPassesCleaningAndID (unsigned int i, const LorentzVector &jet, enum JetType type, JetCleaner &cleaner, double max_eta)
+{
+    //------------------------------------------------------------
+    // max |eta| cut
+    //------------------------------------------------------------
+    if (fabs(jet.eta()) > max_eta)
+        return false;
+    //------------------------------------------------------------
+    // lepton cleaning
+    //------------------------------------------------------------
+    if (cleaner.removes(i))
+        return false;
+    //------------------------------------------------------------
+    // jet ID cuts
+    //------------------------------------------------------------
+    if (type == JETS_TYPE_CALO_CORR || type == JETS_TYPE_CALO_UNCORR){
+        if (not passesCaloJetID(jet))
+            return false;
+    }
+    if (type == JETS_TYPE_PF_FAST_CORR || type == JETS_TYPE_PF_CORR || type == JETS_TYPE_PF_UNCORR || type == JETS_TYPE_PF_FAST_CORR_RESIDUAL){
+        if (not passesPFJetID(i)) 
+            return false;
+    }
+    return true;
+}
+
+// function to give us the indices of jets passing kinematic and cleaning cuts
+static jets_with_corr_t getJets_fast (unsigned int i_hyp, enum JetType type, enum CleaningType cleaning,
+                                      double deltaR, double min_pt, double max_eta, double rescale = 1.0, int systFlag = 0)
+{
+    CORE_PROFILE_SCOPE("getJets_fast");
+    // JPT, PF or calo jets?  Introduce this variable so we only have to decide once
+    const vector<LorentzVector> *jets = &jetCollection(type);
+    JetCleaner cleaner(*jets, i_hyp, cleaning, deltaR);
     jets_with_corr_t ret;
     ret.reserve(jets->size()); // reserve so we don't have to realloc later, which is slow
     for (unsigned int i = 0; i < jets->size(); ++i) {
         //------------------------------------------------------------
-        // min pt cut
+        // min pt cut, then the scale independent cuts
         //------------------------------------------------------------
-        double corr = 1;
-        // CALO_CORR and PF_CORR need to be pt-corrected
+        const double corr = jetScale(i, type, rescale, systFlag);
+        const double pt = jets->at(i).pt() * corr;
+        if (pt < min_pt || !jetPassesCleaningAndID(i, jets->at(i), type, cleaner, max_eta))
+            ret.push_back(pair<const LorentzVector *, double>(0, corr));
+        else
+            ret.push_back(pair<const LorentzVector *, double>(&jets->at(i), corr));
+    }
+    return ret;
+}
+
+struct jets_pt_gt {
+    bool operator () (const LorentzVector &v1, const LorentzVector &v2) 
+    {
+        return v1.pt() > v2.pt();
+    }
+};
+
+struct SelectedJets::PtGreater {
+    PtGreater (const vector<LorentzVector> *jets) : jets_(jets) {}
+    bool operator () (const Entry &e1, const Entry &e2) const
+    {
+        return jets_->at(e1.index).pt() * e1.corr > jets_->at(e2.index).pt() * e2.corr;
+    }
+    const vector<LorentzVector> *jets_;
+};
+
+void SelectedJets::clear (const vector<LorentzVector> *jets)
+{
+    jets_   = jets;
+    size_   = 0;
+    onHeap_ = false;
+    heap_.clear();
+}
+
+void SelectedJets::push_back (unsigned int index, double corr)
+{
+    Entry entry;
+    entry.index = index;
+    entry.corr  = corr;
+    if (!onHeap_ && size_ < N_INLINE) {
+        inline_[size_++] = entry;
+        return;
+    }
+    if (!onHeap_) {
+        heap_.assign(inline_, inline_ + size_);
+        onHeap_ = true;
+    }
+    heap_.push_back(entry);
+    size_++;
+}
+
+double SelectedJets::sumPt () const
+{
+    double ret = 0;
+    for (unsigned int i = 0; i < size_; ++i)
+        ret += pt(i);
+    return ret;
+}
+
+vector<LorentzVector> SelectedJets::p4s () const
+{
+    vector<LorentzVector> ret;
+    ret.reserve(size_);
+    for (unsigned int i = 0; i < size_; ++i)
+        ret.push_back(p4(i));
+    return ret;
+}
+
+void SelectedJets::sortByPt ()
+{
+    std::sort(data(), data() + size_, PtGreater(jets_));
+}
+
+void SelectedJets::sortLeading (unsigned int k)
+{
+    if (k >= size_) {
+        sortByPt();
+        return;
+    }
+    if (k == 0)
+        return;
+    std::nth_element(data(), data() + k - 1, data() + size_, PtGreater(jets_));
+    std::sort(data(), data() + k - 1, PtGreater(jets_));
+}
+
+// selectJets, with the b-tag requirement if btags is given
+static void selectJets (SelectedJets &result, unsigned int i_hyp, enum JetType type, enum CleaningType cleaning,
+                        double deltaR, double min_pt, double max_eta, double rescale, int systFlag,
+                        const vector<float> *btags, float btag_wp)
+{
+    CORE_PROFILE_SCOPE("selectJets");
+    const vector<LorentzVector> &jets = jetCollection(type);
+    JetCleaner cleaner(jets, i_hyp, cleaning, deltaR);
+    result.clear(&jets);
+    for (unsigned int i = 0; i < jets.size(); ++i) {
+        const double corr = jetScale(i, type, rescale, systFlag);
+        const double pt = jets.at(i).pt() * corr;
+        if (pt < min_pt || !jetPassesCleaningAndID(i, jets.at(i), type, cleaner, max_eta))
+            continue;
+        if (btags != 0 && !(btags->at(i) > btag_wp))
+            continue;
+        result.push_back(i, corr);
+    }
+}
+
+void selectJets (SelectedJets &result, unsigned int i_hyp, enum JetType type, enum CleaningType cleaning,
+                 double deltaR, double min_pt, double max_eta, double rescale, int systFlag)
+{
+    selectJets(result, i_hyp, type, cleaning, deltaR, min_pt, max_eta, rescale, systFlag, 0, 0);
+}
+
+// discriminator values of the jet type for a b-tagger
+static const vector<float>* btagDiscriminators (enum BtagType btag_type, enum JetType type)
+{
+    const vector<float> *btags = 0;
+    switch (btag_type) {
+    case JETS_BTAG_NONE:
+        // falls through: TCHE with a working point of -999999 tags every jet
+        btags = 0;
+    case JETS_BTAG_TCHEL: case JETS_BTAG_TCHEM:
         switch (type) {
-        case JETS_TYPE_CALO_CORR:
-	  corr = cms2.jets_cor().at(i) * rescale * getJetMetSyst(systFlag, cms2.jets_p4().at(i).pt(), cms2.jets_p4().at(i).eta());
-            break;
-        case JETS_TYPE_PF_CORR:
-//            corr = cms2.pfjets_cor().at(i) * rescale * getJetMetSyst(systFlag, cms2.pfjets_p4().at(i).pt(), cms2.pfjets_p4().at(i).eta());
-            corr = cms2.pfjets_cor().at(i) * rescale * getJetMetSyst(systFlag, cms2.pfjets_p4().at(i).pt() * cms2.pfjets_cor().at(i), cms2.pfjets_p4().at(i).eta());
+        case JETS_TYPE_CALO_CORR: case JETS_TYPE_CALO_UNCORR:
+            btags = &cms2.jets_trackCountingHighEffBJetTag();
             break;
-        case JETS_TYPE_PF_FAST_CORR:
-//            corr = cms2.pfjets_corL1FastL2L3().at(i) * rescale * getJetMetSyst(systFlag, cms2.pfjets_p4().at(i).pt(), cms2.pfjets_p4().at(i).eta());
-            corr = cms2.pfjets_corL1FastL2L3().at(i) * rescale * getJetMetSyst(systFlag, cms2.pfjets_p4().at(i).pt() * cms2.pfjets_corL1FastL2L3().at(i), cms2.pfjets_p4().at(i).eta());
+        case JETS_TYPE_PF_UNCORR: case JETS_TYPE_PF_CORR: case JETS_TYPE_PF_FAST_CORR: case JETS_TYPE_PF_FAST_CORR_RESIDUAL:
+            btags = &cms2.pfjets_trackCountingHighEffBJetTag();
             break;
-        case JETS_TYPE_PF_FAST_CORR_RESIDUAL:
-//            corr = cms2.pfjets_corL1FastL2L3residual().at(i) * rescale * getJetMetSyst(systFlag, cms2.pfjets_p4().at(i).pt(), cms2.pfjets_p4().at(i).eta());
-            corr = cms2.pfjets_corL1FastL2L3residual().at(i) * rescale * getJetMetSyst(systFlag, cms2.pfjets_p4().at(i).pt() * cms2.pfjets_corL1FastL2L3residual().at(i), cms2.pfjets_p4().at(i).eta());
+        default:
+            assert(false);
+        }
+        break;
+    case JETS_BTAG_TCHPM: case JETS_BTAG_TCHPT:
+        switch (type) {
+        case JETS_TYPE_CALO_CORR: case JETS_TYPE_CALO_UNCORR:
+            btags = &cms2.jets_trackCountingHighPurBJetTag();
             break;
-        case JETS_TYPE_CALO_UNCORR: 
-        case JETS_TYPE_PF_UNCORR:
-#if haveGEN	  
-        case JETS_TYPE_GEN:
-#endif
-            corr = rescale;
+        case JETS_TYPE_PF_UNCORR: case JETS_TYPE_PF_CORR: case JETS_TYPE_PF_FAST_CORR: case JETS_TYPE_PF_FAST_CORR_RESIDUAL:
+            btags = &cms2.pfjets_trackCountingHighPurBJetTag();
             break;
+        default:
+            assert(false);
         }
-        const double pt = jets->at(i).pt() * corr;
-        if (pt < min_pt) 
-            goto conti;
-        //------------------------------------------------------------
-        // max |eta| cut
-        //------------------------------------------------------------
-        if (fabs(jets->at(i).eta()) > max_eta)
-            goto conti;
-        //------------------------------------------------------------
-        // lepton cleaning
-        //------------------------------------------------------------
-        switch (cleaning) {
-        case JETS_CLEAN_NONE:
+        break;
+    case JETS_BTAG_SSVHEM:
+        switch (type) {
+        case JETS_TYPE_CALO_CORR: case JETS_TYPE_CALO_UNCORR:
+            btags = &cms2.jets_simpleSecondaryVertexHighEffBJetTag();
             break;
-        case JETS_CLEAN_HYP_E_MU:
-        {
-            const LorentzVector &lt = cms2.hyp_lt_p4().at(i_hyp);
-            if (ROOT::Math::VectorUtil::DeltaR(jets->at(i), lt) < deltaR)
-                goto conti;
-            const LorentzVector &ll = cms2.hyp_ll_p4().at(i_hyp);
-            if (ROOT::Math::VectorUtil::DeltaR(jets->at(i), ll) < deltaR)
-                goto conti;
+        case JETS_TYPE_PF_UNCORR: case JETS_TYPE_PF_CORR: case JETS_TYPE_PF_FAST_CORR: case JETS_TYPE_PF_FAST_CORR_RESIDUAL:
+            btags = &cms2.pfjets_simpleSecondaryVertexHighEffBJetTag();
             break;
+        default:
+            assert(false);
         }
-        case JETS_CLEAN_HYP_E:
-        {
-            const LorentzVector &lt = cms2.hyp_lt_p4().at(i_hyp);
-            const int lt_id = cms2.hyp_lt_id().at(i_hyp);
-            if (abs(lt_id) == 11 && ROOT::Math::VectorUtil::DeltaR(jets->at(i), lt) < deltaR)
-                goto conti;
-            const LorentzVector &ll = cms2.hyp_ll_p4().at(i_hyp);
-            const int ll_id = cms2.hyp_ll_id().at(i_hyp);
-            if (abs(ll_id) == 11 && ROOT::Math::VectorUtil::DeltaR(jets->at(i), ll) < deltaR)
-                goto conti;
+        break;
+    case JETS_BTAG_SSVHPT:
+        switch (type) {
+        case JETS_TYPE_CALO_CORR: case JETS_TYPE_CALO_UNCORR:
+            btags = &cms2.jets_simpleSecondaryVertexHighPurBJetTags();
             break;
-        }
-        case JETS_CLEAN_SINGLE_E:
-        {
-            const LorentzVector &e = cms2.els_p4().at(i_hyp);
-            if (ROOT::Math::VectorUtil::DeltaR(jets->at(i), e) < deltaR)
-                goto conti;
+        case JETS_TYPE_PF_UNCORR: case JETS_TYPE_PF_CORR: case JETS_TYPE_PF_FAST_CORR: case JETS_TYPE_PF_FAST_CORR_RESIDUAL:
+            btags = &cms2.pfjets_simpleSecondaryVertexHighPurBJetTags();
             break;
+        default:
+            assert(false);
         }
-        case JETS_CLEAN_SINGLE_MU:
-        {
-            const LorentzVector &e = cms2.mus_p4().at(i_hyp);
-            if (ROOT::Math::VectorUtil::DeltaR(jets->at(i), e) < deltaR)
-                goto conti;
+        break;
+    case JETS_BTAG_CSVL: case JETS_BTAG_CSVM: case JETS_BTAG_CSVT:
+        switch (type) {
+        case JETS_TYPE_CALO_CORR: case JETS_TYPE_CALO_UNCORR:
+            btags = &cms2.jets_combinedSecondaryVertexBJetTag();
+            break;
+        case JETS_TYPE_PF_UNCORR: case JETS_TYPE_PF_CORR: case JETS_TYPE_PF_FAST_CORR: case JETS_TYPE_PF_FAST_CORR_RESIDUAL:
+            btags = &cms2.pfjets_combinedSecondaryVertexBJetTag();
             break;
-        }
         default:
             assert(false);
         }
-        //------------------------------------------------------------
-        // jet ID cuts
-        //------------------------------------------------------------
-        if (type == JETS_TYPE_CALO_CORR || type == JETS_TYPE_CALO_UNCORR){
-            if (not passesCaloJetID(jets->at(i)))
-                goto conti;
-        }
-        if (type == JETS_TYPE_PF_FAST_CORR || type == JETS_TYPE_PF_CORR || type == JETS_TYPE_PF_UNCORR || type == JETS_TYPE_PF_FAST_CORR_RESIDUAL){
-            if (not passesPFJetID(i)) 
-                goto conti;
-        }
-        //------------------------------------------------------------
-        // jet passed all cuts
-        //------------------------------------------------------------
-        ret.push_back(pair<const LorentzVector *, double>(&jets->at(i), corr));
-        continue;
-        //------------------------------------------------------------
-        // jet failed
-        //------------------------------------------------------------
-    conti:
-        ret.push_back(pair<const LorentzVector *, double>(0, corr));
+        break;
+    default:
+        assert(false);
     }
-    return ret;
+    return btags;
 }
 
-struct jets_pt_gt {
-    bool operator () (const LorentzVector &v1, const LorentzVector &v2) 
-    {
-        return v1.pt() > v2.pt();
+void selectBtaggedJets (SelectedJets &result, unsigned int i_hyp, enum JetType type, enum CleaningType cleaning,
+                        enum BtagType btag_type, double deltaR, double min_pt, double max_eta, double rescale, int systFlag)
+{
+    const vector<float> *btags = btagDiscriminators(btag_type, type);
+    if (btags == 0) {
+        result.clear(&jetCollection(type));
+        return;
     }
-};
+    selectJets(result, i_hyp, type, cleaning, deltaR, min_pt, max_eta, rescale, systFlag, btags, BtagWP[btag_type]);
+}
 
 // functions that we let other people use
 vector<LorentzVector> getJets (unsigned int i_hyp, bool sort_, 
                                enum JetType type, enum CleaningType cleaning,
                                double deltaR, double min_pt, double max_eta, double rescale, int systFlag)
-
 {
-  jets_with_corr_t jets = getJets_fast(i_hyp, type, cleaning, deltaR, min_pt, max_eta, rescale, systFlag);
-    vector<LorentzVector> ret;
-    ret.reserve(jets.size());
-    for (unsigned int i = 0; i < jets.size(); ++i) {
-        // correct the jet momentum if a corrected jet type was requested
-        if (jets[i].first != 0)
-            ret.push_back(*jets[i].first * jets[i].second);
-    }
+    SelectedJets jets;
+    selectJets(jets, i_hyp, type, cleaning, deltaR, min_pt, max_eta, rescale, systFlag);
+    vector<LorentzVector> ret = jets.p4s();
     if (sort_)
         sort(ret.begin(), ret.end(), jets_pt_gt());
     return ret;
@@ -234,29 +608,116 @@ std::vector<bool> getJetFlags (unsigned int i_hyp, enum JetType type, enum Clean
 int nJets (unsigned int i_hyp, enum JetType type, enum CleaningType cleaning,
            double deltaR, double min_pt, double max_eta, double rescale,  int systFlag)
 {
-  jets_with_corr_t jets = getJets_fast(i_hyp, type, cleaning, deltaR, min_pt, max_eta, rescale, systFlag);
-    int ret = 0;
+    SelectedJets jets;
+    selectJets(jets, i_hyp, type, cleaning, deltaR, min_pt, max_eta, rescale, systFlag);
+    return jets.size();
+}
+
+double sumPt (unsigned int i_hyp, enum JetType type, enum CleaningType cleaning,
+              double deltaR, double min_pt, double max_eta, double rescale,  int systFlag)
+{
+    SelectedJets jets;
+    selectJets(jets, i_hyp, type, cleaning, deltaR, min_pt, max_eta, rescale, systFlag);
+    return jets.sumPt();
+}
+
+void getJetVariations (JetVariations &result, const vector<JetVariation> &variations, unsigned int i_hyp,
+                       enum JetType type, enum CleaningType cleaning, double deltaR, double min_pt, double max_eta,
+                       JetCorrectionUncertainty *jet_unc, JetSmearer *jet_smearer)
+{
+    CORE_PROFILE_SCOPE("getJetVariations");
+    const vector<LorentzVector> &jets = jetCollection(type);
+    result.jets   = &jets;
+    result.min_pt = min_pt;
+    result.index.clear();
+    result.corr.assign(variations.size(), vector<double>());
+    JetCleaner cleaner(jets, i_hyp, cleaning, deltaR);
+
     for (unsigned int i = 0; i < jets.size(); ++i) {
-        // correct the jet momentum if a corrected jet type was requested
-        if (jets[i].first != 0)
+        if (!jetPassesCleaningAndID(i, jets.at(i), type, cleaner, max_eta))
+            continue;
+        result.index.push_back(i);
+
+        const double base = jetBaseCorrection(i, type);
+        for (unsigned int ivar = 0; ivar < variations.size(); ++ivar) {
+            const JetVariation &var = variations[ivar];
+            double corr = 1;
+            switch (var.type) {
+            case JETS_VAR_NOMINAL:
+                corr = jetScale(i, type, var.rescale, 0);
+                break;
+            case JETS_VAR_SYST:
+                corr = jetScale(i, type, var.rescale, var.flag);
+                break;
+            case JETS_VAR_JES:
+            {
+                // uncertainty at the pt and eta corrected with the correction of type
+                const LorentzVector vjet = jets.at(i) * base;
+                jet_unc->setJetPt(vjet.pt());
+                jet_unc->setJetEta(vjet.eta());
+                const float jet_cor_unc = jet_unc->getUncertainty(true);
+                corr = base * var.rescale * (1.0 + jet_cor_unc * var.flag);
+                break;
+            }
+            case JETS_VAR_JER:
+                corr = base * var.rescale * jet_smearer->smearScale(jets.at(i) * base);
+                break;
+            }
+            result.corr[ivar].push_back(corr);
+        }
+    }
+}
+
+int JetVariations::nJets (unsigned int ivar) const
+{
+    int ret = 0;
+    for (unsigned int i = 0; i < index.size(); ++i) {
+        if (passes(ivar, i))
             ret++;
     }
     return ret;
 }
 
-double sumPt (unsigned int i_hyp, enum JetType type, enum CleaningType cleaning,
-              double deltaR, double min_pt, double max_eta, double rescale,  int systFlag)
+double JetVariations::sumPt (unsigned int ivar) const
 {
-  jets_with_corr_t jets = getJets_fast(i_hyp, type, cleaning, deltaR, min_pt, max_eta, rescale, systFlag);
     double ret = 0;
-    for (unsigned int i = 0; i < jets.size(); ++i) {
-        // correct the jet momentum if a corrected jet type was requested
-        if (jets[i].first != 0)
-            ret += jets[i].first->pt() * jets[i].second;
+    for (unsigned int i = 0; i < index.size(); ++i) {
+        if (passes(ivar, i))
+            ret += jets->at(index[i]).pt() * corr[ivar][i];
     }
     return ret;
 }
 
+void JetVariations::removeOverlaps (const JetMask &overlaps)
+{
+    // keep the candidates that do not overlap, in place
+    unsigned int nkept = 0;
+    for (unsigned int icand = 0; icand < index.size(); ++icand) {
+        if (jetOverlaps(overlaps, index[icand]))
+            continue;
+        index[nkept] = index[icand];
+        for (unsigned int ivar = 0; ivar < corr.size(); ++ivar)
+            corr[ivar][nkept] = corr[ivar][icand];
+        nkept++;
+    }
+    index.resize(nkept);
+    for (unsigned int ivar = 0; ivar < corr.size(); ++ivar)
+        corr[ivar].resize(nkept);
+}
+
+vector<LorentzVector> JetVariations::getJets (unsigned int ivar, bool sort_) const
+{
+    vector<LorentzVector> ret;
+    ret.reserve(index.size());
+    for (unsigned int i = 0; i < index.size(); ++i) {
+        if (passes(ivar, i))
+            ret.push_back(p4(ivar, i));
+    }
+    if (sort_)
+        sort(ret.begin(), ret.end(), jets_pt_gt());
+    return ret;
+}
+
 static FactorizedJetCorrector *jetCorrector = 0;
 
 void setJetCorrector (FactorizedJetCorrector *jc) 
@@ -395,46 +856,69 @@ bool passesPFJetID(unsigned int pfJetIdx) {
 
 
 
+// Median pt density of an 8 x 10 grid of eta-phi cells covering
+// |eta| < 2.4. Each PF candidate is only tested against the cells around
+// the one its eta and phi fall into (a candidate exactly on a cell edge
+// counts in both cells, as before), and the result is cached per event.
 float randomConeEventDensity(){
 
+    static EventTag tag;
+    static float evt_rho = 0;
+    bool cached = !isNewEvent(tag);
+    CORE_PROFILE_CACHE("randomConeEventDensity", cached);
+    if (cached)
+        return evt_rho;
+
     //define the eta bins
-    vector<float> etabins;
-    for (int i=0;i<8;++i) etabins.push_back(-2.1+0.6*i);
+    const int neta = 8;
+    float etabins[neta];
+    for (int i=0;i<neta;++i) etabins[i] = -2.1+0.6*i;
     //define the phi bins
-    vector<float> phibins;
-    for (int i=0;i<10;i++) phibins.push_back(-TMath::Pi()+(2*i+1)*TMath::TwoPi()/20.);
+    const int nphi = 10;
+    float phibins[nphi];
+    for (int i=0;i<nphi;i++) phibins[i] = -TMath::Pi()+(2*i+1)*TMath::TwoPi()/20.;
   
     float etadist = etabins[1]-etabins[0];
     float phidist = phibins[1]-phibins[0];
     float etahalfdist = (etabins[1]-etabins[0])/2.;
     float phihalfdist = (phibins[1]-phibins[0])/2.;
 
-    vector<float> sumPFNallSMDQ;
-    sumPFNallSMDQ.reserve(80);
-    for (unsigned int ieta=0;ieta<etabins.size();++ieta) {
-        for (unsigned int iphi=0;iphi<phibins.size();++iphi) {
-            float pfniso_ieta_iphi = 0;
-            for (unsigned int ipf=0; ipf<cms2.pfcands_p4().size(); ++ipf){
-                if (fabs(etabins[ieta]-cms2.pfcands_p4().at(ipf).eta())>etahalfdist) continue;
-                if (fabs(deltaPhi(phibins[iphi],cms2.pfcands_p4().at(ipf).phi()))>phihalfdist) continue;
-                pfniso_ieta_iphi+=cms2.pfcands_p4().at(ipf).pt();
+    float sumPFNallSMDQ[neta*nphi];
+    std::fill(sumPFNallSMDQ, sumPFNallSMDQ + neta*nphi, 0.f);
+    for (unsigned int ipf=0; ipf<cms2.pfcands_p4().size(); ++ipf){
+        const float eta = cms2.pfcands_p4().at(ipf).eta();
+        if (fabs(eta) > 2.4 + etahalfdist) continue;
+        const float phi = cms2.pfcands_p4().at(ipf).phi();
+        const float pt  = cms2.pfcands_p4().at(ipf).pt();
+
+        // nearest cell, then its neighbours for candidates on the edges
+        const int ieta0 = int(floor((eta - etabins[0]) / etadist + 0.5));
+        const int iphi0 = int(floor((phi - phibins[0]) / phidist + 0.5));
+        for (int ieta = std::max(ieta0-1, 0); ieta <= std::min(ieta0+1, neta-1); ++ieta) {
+            if (fabs(etabins[ieta]-eta)>etahalfdist) continue;
+            for (int jphi = iphi0-1; jphi <= iphi0+1; ++jphi) {
+                const int iphi = (jphi + nphi) % nphi;
+                if (fabs(deltaPhi(phibins[iphi],phi))>phihalfdist) continue;
+                sumPFNallSMDQ[ieta*nphi + iphi]+=pt;
             }
-            sumPFNallSMDQ.push_back(pfniso_ieta_iphi);
         }
     }
 
+    // median of the cell sums
+    const int ncells = neta*nphi;
     float evt_smdq = 0;
-    sort(sumPFNallSMDQ.begin(),sumPFNallSMDQ.end());
-  
-    if (sumPFNallSMDQ.size()%2) evt_smdq = sumPFNallSMDQ[(sumPFNallSMDQ.size()-1)/2];
-    else evt_smdq = (sumPFNallSMDQ[sumPFNallSMDQ.size()/2]+sumPFNallSMDQ[(sumPFNallSMDQ.size()-2)/2])/2.;
-    return evt_smdq/(etadist*phidist);
+    std::nth_element(sumPFNallSMDQ, sumPFNallSMDQ + ncells/2, sumPFNallSMDQ + ncells);
+    if (ncells%2) evt_smdq = sumPFNallSMDQ[ncells/2];
+    else evt_smdq = (sumPFNallSMDQ[ncells/2]+*std::max_element(sumPFNallSMDQ, sumPFNallSMDQ + ncells/2))/2.;
+
+    evt_rho = evt_smdq/(etadist*phidist);
+    return evt_rho;
 }
 
 
 float jetDz(int ijet, int ivtx) {
     //add protection against non-pf jets
-    vector<int> cands = cms2.pfjets_pfcandIndicies().at(ijet);
+    const vector<int> &cands = cms2.pfjets_pfcandIndicies().at(ijet);
     float jptsq   = 0;
     float jptsqdz = 0;
     for (unsigned int ivc=0;ivc<cands.size();ivc++) {
@@ -446,13 +930,13 @@ float jetDz(int ijet, int ivtx) {
         if (iel>=0) igsf  = cms2.els_gsftrkidx().at(iel);
         float ptsq = pow(cms2.pfcands_p4().at(ican).pt(),2);
         if (igsf>=0) {
-            float dzc = gsftrks_dz_pv(igsf,ivtx).first;
+            float dzc = gsftrks_dz_pv_cached(igsf,ivtx);
             jptsq+=ptsq;
             jptsqdz+=ptsq*dzc;
         } else {
             int itrk = cms2.pfcands_trkidx().at(ican);
             if (itrk<0) continue;
-            float dzc = trks_dz_pv(itrk,ivtx).first;
+            float dzc = trks_dz_pv_cached(itrk,ivtx);
             jptsq+=ptsq;
             jptsqdz+=ptsq*dzc;
         }
@@ -461,6 +945,41 @@ float jetDz(int ijet, int ivtx) {
     else return 99999.;
 }
 
+// |eta| bins of the MC jet resolution: < 0.5, [0.5, 1.0), ... [3.0, 5.0), >= 5.0
+static const double jetErrPtEtaEdges[7] = { 0.5, 1.0, 1.5, 2.0, 2.5, 3.0, 5.0 };
+static const float jetErrPtN[8] = { 3.96859, 3.55226, 4.54826, 4.62622, 2.53324, -3.33814, 2.95397, 0. };
+static const float jetErrPtS[8] = { 0.18348, 0.24026, 0.22652, 0.23664, 0.34306,  0.73360, 0.11619, 0. };
+static const float jetErrPtC[8] = { 0.,      0.,      0.,      0.,      0.,       0.,      0.,      0. };
+static const float jetErrPtM[8] = { 0.62627, 0.52571, 0.58963, 0.48738, 0.28662,  0.08264, 0.96086, 0. };
+
+// those numbers are old, but at least they are in an understandable format
+float jetResolutionErrPt(float pt, float eta)
+{
+    const float aeta = fabs(eta);
+    const unsigned int bin = aeta == aeta ? binAtOrAbove(aeta, jetErrPtEtaEdges) : 7;
+    const float N = jetErrPtN[bin];
+    const float S = jetErrPtS[bin];
+    const float C = jetErrPtC[bin];
+    const float m = jetErrPtM[bin];
+
+    // this is the absolute resolution (squared), not sigma(pt)/pt
+    // so have to multiply by pt^2, thats why m+1 instead of m-1
+    const float InvPerr2 = (N * fabs(N) ) + (S * S) * pow(pt, m+1) + (C * C) * pt * pt;
+
+    return sqrt(InvPerr2);
+}
+
+// |eta| bins of the jer scale factors: < 0.5, [0.5, 1.1), ... >= 2.3, from
+// https://twiki.cern.ch/twiki/bin/view/CMS/JetResolution
+static const double jerScaleEtaEdges[4] = { 0.5, 1.1, 1.7, 2.3 };
+static const float jerScales[5] = { 1.052, 1.057, 1.096, 1.134, 1.288 };
+
+float jetResolutionScale(float jet_eta)
+{
+    const float aeta = fabs(jet_eta);
+    return jerScales[aeta == aeta ? binAtOrAbove(aeta, jerScaleEtaEdges) : 4];
+}
+
 float dz_trk_vtx( const unsigned int trkidx, const unsigned int vtxidx ){
   
   //return ((cms2.trks_vertex_p4()[trkidx].z()-cms2.vtxs_position()[vtxidx].z()) - ((cms2.trks_vertex_p4()[trkidx].x()-cms2.vtxs_position()[vtxidx].x()) * cms2.trks_trk_p4()[trkidx].px() + (cms2.trks_vertex_p4()[trkidx].y() - cms2.vtxs_position()[vtxidx].y()) * cms2.trks_trk_p4()[trkidx].py())/cms2.trks_trk_p4()[trkidx].pt() * cms2.trks_trk_p4()[trkidx].pz()/cms2.trks_trk_p4()[trkidx].pt());
@@ -474,7 +993,7 @@ float pfjet_beta(int ijet, int power , float dzcut , int ivtx , bool verbose ) {
   // cands is the vector of PFCandidate indices matched to the pfjet with index ijet
   //---------------------------------------------------------------------------------
 
-  vector<int> cands = cms2.pfjets_pfcandIndicies().at(ijet);
+  const vector<int> &cands = cms2.pfjets_pfcandIndicies().at(ijet);
 
   float pt_tot = 0.0;
   float pt_vtx = 0.0;
@@ -523,7 +1042,7 @@ float pfjet_beta(int ijet, int power , float dzcut , int ivtx , bool verbose ) {
     // require dz(trk,vtx) < dzcut
     //-------------------------------------------------------------------
 
-    float dz = trks_dz_pv(itrk,ivtx).first;  
+    float dz = trks_dz_pv_cached(itrk,ivtx);  
     if ( fabs(dz) > dzcut )     continue;
 
     //-------------------------------------------------------------------
@@ -545,91 +1064,125 @@ float pfjet_beta(int ijet, int power , float dzcut , int ivtx , bool verbose ) {
 
 }
 
-vector<LorentzVector> getBtaggedJets (unsigned int i_hyp, bool sort_, enum JetType type, enum CleaningType cleaning,
-                                      enum BtagType btag_type, double deltaR, double min_pt, double max_eta, 
-                                      double rescale,  int systFlag)
+void pfjetConstituentInfo(PFJetConstituentInfo &info, int ijet, int ivtx,
+                          const std::vector<int> &betaPowers, const std::vector<float> &betaDzCuts, int lrmPower)
 {
-  jets_with_corr_t jets = getJets_fast(i_hyp, type, cleaning, deltaR, min_pt, max_eta, rescale, systFlag);
-    const vector<float> *btags = 0;
-    const float btag_wp = BtagWP[btag_type];
+  const unsigned int nbeta = std::min(betaPowers.size(), betaDzCuts.size());
+  if (betaPowers.size() != betaDzCuts.size())
+      std::cout << __FILE__ << " " << __LINE__ << " WARNING! need one dz cut per beta power, using the first " << nbeta << std::endl;
+
+  info.beta.assign(nbeta, -2.0);
+  info.dz       = 99999.;
+  info.ptD      = 0.;
+  info.lrm      = 9999.;
+  info.nCharged = cms2.pfjets_chargedHadronMultiplicity().at(ijet);
+  info.nNeutral = cms2.pfjets_neutralHadronMultiplicity().at(ijet) + cms2.pfjets_photonMultiplicity().at(ijet);
+
+  // pfjet_beta sums
+  vector<float> beta_pt_tot(nbeta, 0.0);
+  vector<float> beta_pt_vtx(nbeta, 0.0);
+
+  // jetDz sums
+  float jptsq   = 0;
+  float jptsqdz = 0;
+
+  // constituentPtDistribution sums
+  float sum_pt2 = 0.;
+  float sum_pt  = 0.;
+
+  // getLRM sums
+  float lrm_sum_pt_ri = 0;
+  float lrm_sum_pt    = 0;
+  const float jet_rapidity = cms2.pfjets_p4().at(ijet).Rapidity();
+  const float jet_phi      = cms2.pfjets_p4().at(ijet).Phi();
+
+  const vector<int> &cands = cms2.pfjets_pfcandIndicies().at(ijet);
+  for (unsigned int ivc = 0; ivc < cands.size(); ivc++) {
 
-    switch (btag_type) {
-    case JETS_BTAG_NONE:
-        btags = 0;
-    case JETS_BTAG_TCHEL: case JETS_BTAG_TCHEM:
-        switch (type) {
-        case JETS_TYPE_CALO_CORR: case JETS_TYPE_CALO_UNCORR:
-            btags = &cms2.jets_trackCountingHighEffBJetTag();
-            break;
-        case JETS_TYPE_PF_UNCORR: case JETS_TYPE_PF_CORR: case JETS_TYPE_PF_FAST_CORR: case JETS_TYPE_PF_FAST_CORR_RESIDUAL:
-            btags = &cms2.pfjets_trackCountingHighEffBJetTag();
-            break;
-        default:
-            assert(false);
+    int ican = cands[ivc];
+
+    if( ican >= static_cast<int>(cms2.pfcands_charge().size()) ){
+        std::cout << __FILE__ << " " << __LINE__ << " ERROR! ican, numCandidates " << ican << ", " << cms2.pfcands_charge().size() << std::endl;
+        info.beta.assign(nbeta, -3.0);
+        return;
+    }
+
+    const float pt = cms2.pfcands_p4().at(ican).pt();
+    sum_pt  += pt;
+    sum_pt2 += pt*pt;
+
+    if (cms2.pfcands_charge().at(ican)==0) continue;
+
+    // ctf track, if valid
+    int itrk = cms2.pfcands_trkidx().at(ican);
+    const bool hasTrk = (itrk >= 0 && itrk < (int) cms2.trks_trk_p4().size());
+
+    // beta: ctf tracks only
+    if (hasTrk) {
+        const float dz = trks_dz_pv_cached(itrk,ivtx);
+        for (unsigned int ib = 0; ib < nbeta; ib++) {
+            const double ptpow = pow(pt, betaPowers[ib]);
+            beta_pt_tot[ib] += ptpow;
+            if (fabs(dz) > betaDzCuts[ib]) continue;
+            beta_pt_vtx[ib] += ptpow;
         }
-        break;
-    case JETS_BTAG_TCHPM: case JETS_BTAG_TCHPT:
-        switch (type) {
-        case JETS_TYPE_CALO_CORR: case JETS_TYPE_CALO_UNCORR:
-            btags = &cms2.jets_trackCountingHighPurBJetTag();
-            break;
-        case JETS_TYPE_PF_UNCORR: case JETS_TYPE_PF_CORR: case JETS_TYPE_PF_FAST_CORR: case JETS_TYPE_PF_FAST_CORR_RESIDUAL:
-            btags = &cms2.pfjets_trackCountingHighPurBJetTag();
-            break;
-        default:
-            assert(false);
+    }
+
+    // jetDz: gsf track of the PF electron if there is one, ctf track otherwise
+    {
+        int ipfel = cms2.pfcands_pfelsidx().at(ican);
+        int iel=-1, igsf=-1;
+        if (ipfel>=0) iel   = cms2.pfels_elsidx().at(ipfel);
+        if (iel>=0) igsf  = cms2.els_gsftrkidx().at(iel);
+        float ptsq = pow(pt,2);
+        if (igsf>=0) {
+            float dzc = gsftrks_dz_pv_cached(igsf,ivtx);
+            jptsq+=ptsq;
+            jptsqdz+=ptsq*dzc;
+        } else if (itrk>=0) {
+            float dzc = trks_dz_pv_cached(itrk,ivtx);
+            jptsq+=ptsq;
+            jptsqdz+=ptsq*dzc;
         }
-        break;
-    case JETS_BTAG_SSVHEM:
-        switch (type) {
-        case JETS_TYPE_CALO_CORR: case JETS_TYPE_CALO_UNCORR:
-            btags = &cms2.jets_simpleSecondaryVertexHighEffBJetTag();
-            break;
-        case JETS_TYPE_PF_UNCORR: case JETS_TYPE_PF_CORR: case JETS_TYPE_PF_FAST_CORR: case JETS_TYPE_PF_FAST_CORR_RESIDUAL:
-            btags = &cms2.pfjets_simpleSecondaryVertexHighEffBJetTag();
-            break;
-        default:
-            assert(false);
+    }
+
+    // LRM: charged constituents within dz < 0.05 of the first vertex
+    {
+        const int particleId = abs(cms2.pfcands_particleId().at(ican));
+        float dz = 9999.;
+        bool skip = false;
+        if (particleId != 11) {
+            if (hasTrk) dz = trks_dz_pv_cached(itrk,0);
+            else        skip = true;
         }
-        break;
-    case JETS_BTAG_SSVHPT:
-        switch (type) {
-        case JETS_TYPE_CALO_CORR: case JETS_TYPE_CALO_UNCORR:
-            btags = &cms2.jets_simpleSecondaryVertexHighPurBJetTags();
-            break;
-        case JETS_TYPE_PF_UNCORR: case JETS_TYPE_PF_CORR: case JETS_TYPE_PF_FAST_CORR: case JETS_TYPE_PF_FAST_CORR_RESIDUAL:
-            btags = &cms2.pfjets_simpleSecondaryVertexHighPurBJetTags();
-            break;
-        default:
-            assert(false);
+        if (particleId == 11 && cms2.pfcands_pfelsidx().at(ican) >= 0) {
+            int igsf = cms2.els_gsftrkidx().at(cms2.pfcands_pfelsidx().at(ican));
+            if (igsf >= (int)cms2.gsftrks_p4().size() || igsf < 0) skip = true;
+            else dz = gsftrks_dz_pv_cached(igsf,0);
         }
-        break;
-    case JETS_BTAG_CSVL: case JETS_BTAG_CSVM: case JETS_BTAG_CSVT:
-        switch (type) {
-        case JETS_TYPE_CALO_CORR: case JETS_TYPE_CALO_UNCORR:
-            btags = &cms2.jets_combinedSecondaryVertexBJetTag();
-            break;
-        case JETS_TYPE_PF_UNCORR: case JETS_TYPE_PF_CORR: case JETS_TYPE_PF_FAST_CORR: case JETS_TYPE_PF_FAST_CORR_RESIDUAL:
-            btags = &cms2.pfjets_combinedSecondaryVertexBJetTag();
-            break;
-        default:
-            assert(false);
+        if (!skip && fabs(dz) <= 0.05) {
+            float ri = deltaR(cms2.pfcands_p4().at(ican).Rapidity(), cms2.pfcands_p4().at(ican).Phi(), jet_rapidity, jet_phi);
+            lrm_sum_pt_ri += pow(pt,lrmPower) * pow(ri,lrmPower);
+            lrm_sum_pt    += pow(pt,lrmPower);
         }
-        break;
-    default:
-        assert(false);
     }
+  }
 
-    vector<LorentzVector> ret;
-    ret.reserve(jets.size());
-    if (jets.size() == 0 || btags == 0 )
-        return ret;
-
-    for (unsigned int i = 0; i < jets.size(); ++i) {
-        if (jets[i].first != 0 && btags->at(i) > btag_wp )
-            ret.push_back(*jets[i].first * jets[i].second);         
-    }
+  for (unsigned int ib = 0; ib < nbeta; ib++) {
+      if (beta_pt_tot[ib] > 1e-5) info.beta[ib] = beta_pt_vtx[ib] / beta_pt_tot[ib];
+  }
+  if (jptsq>1E-6) info.dz = jptsqdz/jptsq;
+  if (sum_pt>0.) info.ptD = sqrt( sum_pt2 / (sum_pt*sum_pt) );
+  if (lrm_sum_pt > 0.) info.lrm = lrm_sum_pt_ri / lrm_sum_pt;
+}
 
+vector<LorentzVector> getBtaggedJets (unsigned int i_hyp, bool sort_, enum JetType type, enum CleaningType cleaning,
+                                      enum BtagType btag_type, double deltaR, double min_pt, double max_eta, 
+                                      double rescale,  int systFlag)
+{
+    SelectedJets jets;
+    selectBtaggedJets(jets, i_hyp, type, cleaning, btag_type, deltaR, min_pt, max_eta, rescale, systFlag);
+    vector<LorentzVector> ret = jets.p4s();
     if (sort_)
         sort(ret.begin(), ret.end(), jets_pt_gt());
     return ret;
@@ -640,76 +1193,9 @@ std::vector<bool> getBtaggedJetFlags (unsigned int i_hyp, enum JetType type, enu
                                       double rescale,  int systFlag)
 {
   jets_with_corr_t jets = getJets_fast(i_hyp, type, cleaning, deltaR, min_pt, max_eta, rescale, systFlag);
-    const vector<float> *btags = 0;
+    const vector<float> *btags = btagDiscriminators(btag_type, type);
     const float btag_wp = BtagWP[btag_type];
 
-    switch (btag_type) {
-    case JETS_BTAG_NONE:
-        btags = 0;
-    case JETS_BTAG_TCHEL: case JETS_BTAG_TCHEM:
-        switch (type) {
-        case JETS_TYPE_CALO_CORR: case JETS_TYPE_CALO_UNCORR:
-            btags = &cms2.jets_trackCountingHighEffBJetTag();
-            break;
-        case JETS_TYPE_PF_UNCORR: case JETS_TYPE_PF_CORR: case JETS_TYPE_PF_FAST_CORR: case JETS_TYPE_PF_FAST_CORR_RESIDUAL:
-            btags = &cms2.pfjets_trackCountingHighEffBJetTag();
-            break;
-        default:
-            assert(false);
-        }
-        break;
-    case JETS_BTAG_TCHPM: case JETS_BTAG_TCHPT:
-        switch (type) {
-        case JETS_TYPE_CALO_CORR: case JETS_TYPE_CALO_UNCORR:
-            btags = &cms2.jets_trackCountingHighPurBJetTag();
-            break;
-        case JETS_TYPE_PF_UNCORR: case JETS_TYPE_PF_CORR: case JETS_TYPE_PF_FAST_CORR: case JETS_TYPE_PF_FAST_CORR_RESIDUAL:
-            btags = &cms2.pfjets_trackCountingHighPurBJetTag();
-            break;
-        default:
-            assert(false);
-        }
-        break;
-    case JETS_BTAG_SSVHEM:
-        switch (type) {
-        case JETS_TYPE_CALO_CORR: case JETS_TYPE_CALO_UNCORR:
-            btags = &cms2.jets_simpleSecondaryVertexHighEffBJetTag();
-            break;
-        case JETS_TYPE_PF_UNCORR: case JETS_TYPE_PF_CORR: case JETS_TYPE_PF_FAST_CORR: case JETS_TYPE_PF_FAST_CORR_RESIDUAL:
-            btags = &cms2.pfjets_simpleSecondaryVertexHighEffBJetTag();
-            break;
-        default:
-            assert(false);
-        }
-        break;
-    case JETS_BTAG_SSVHPT:
-        switch (type) {
-        case JETS_TYPE_CALO_CORR: case JETS_TYPE_CALO_UNCORR:
-            btags = &cms2.jets_simpleSecondaryVertexHighPurBJetTags();
-            break;
-        case JETS_TYPE_PF_UNCORR: case JETS_TYPE_PF_CORR: case JETS_TYPE_PF_FAST_CORR: case JETS_TYPE_PF_FAST_CORR_RESIDUAL:
-            btags = &cms2.pfjets_simpleSecondaryVertexHighPurBJetTags();
-            break;
-        default:
-            assert(false);
-        }
-        break;
-    case JETS_BTAG_CSVL: case JETS_BTAG_CSVM: case JETS_BTAG_CSVT:
-        switch (type) {
-        case JETS_TYPE_CALO_CORR: case JETS_TYPE_CALO_UNCORR:
-            btags = &cms2.jets_combinedSecondaryVertexBJetTag();
-            break;
-        case JETS_TYPE_PF_UNCORR: case JETS_TYPE_PF_CORR: case JETS_TYPE_PF_FAST_CORR: case JETS_TYPE_PF_FAST_CORR_RESIDUAL:
-            btags = &cms2.pfjets_combinedSecondaryVertexBJetTag();
-            break;
-        default:
-            assert(false);
-        }
-        break;
-    default:
-        assert(false);
-    }
-
     vector<bool> ret;
     ret.reserve(jets.size());
     if (jets.size() == 0 || btags == 0 )
@@ -725,7 +1211,8 @@ std::vector<bool> getBtaggedJetFlags (unsigned int i_hyp, enum JetType type, enu
 int nBtaggedJets (unsigned int i_hyp, enum JetType type, enum CleaningType cleaning,
                   enum BtagType btag_type, double deltaR, double min_pt, double max_eta, double rescale,  int systFlag)
 {
-  std::vector<LorentzVector> jets = getBtaggedJets(i_hyp, false, type, cleaning, btag_type, deltaR, min_pt, max_eta, rescale, systFlag);
+    SelectedJets jets;
+    selectBtaggedJets(jets, i_hyp, type, cleaning, btag_type, deltaR, min_pt, max_eta, rescale, systFlag);
     return jets.size();
 }
 
@@ -101,6 +101,163 @@ double sumPt (unsigned int i_hyp,  // hyp or single-e to use for cleaning
               double rescale = 1.0,
 	      int systFlag = 0);
 
+//-----------------------------------------------------------------------------
+// Jet-lepton overlaps from a per-event jet x lepton Delta R table. Bit
+// ijet % 64 of word ijet / 64 of the mask is set if jet ijet of the jet
+// type is within deltaR of the lepton (id 11 or 13, index in els or mus):
+// DeltaR(jet, lepton) < deltaR, or <= deltaR if inclusive. The masks are
+// cached for the event; the lepton cleaning of the jet selections uses them.
+//-----------------------------------------------------------------------------
+typedef std::vector<ULong64_t> JetMask;
+
+const JetMask& jetLeptonOverlapMask (enum JetType type, int lep_id, unsigned int lep_idx, double deltaR, bool inclusive = false);
+
+inline bool jetMaskTest (const JetMask &mask, unsigned int ijet) { return (mask[ijet >> 6] >> (ijet & 63)) & 1; }
+
+// the same for any per-event collection of p4s in place of the jets, e.g.
+// cms2.mus_p4(); bit i is set if DeltaR(p4s[i], lepton) is within deltaR
+const JetMask& p4LeptonOverlapMask (const std::vector<LorentzVector> &p4s, int lep_id, unsigned int lep_idx, double deltaR, bool inclusive = false);
+
+// ors the jets of type within deltaR of any of the lepton p4s into overlaps;
+// a p4 equal to that of a reco electron or muon uses its cached mask
+void addJetOverlaps (JetMask &overlaps, enum JetType type, const std::vector<LorentzVector> &leps, double deltaR, bool inclusive = false);
+
+// ors a mask into overlaps, which is empty until the first mask is added
+inline void addJetOverlaps (JetMask &overlaps, const JetMask &mask)
+{
+    if (overlaps.empty())
+        overlaps.resize(mask.size(), 0);
+    for (unsigned int w = 0; w < overlaps.size(); w++)
+        overlaps[w] |= mask[w];
+}
+
+inline bool jetOverlaps (const JetMask &overlaps, unsigned int ijet) { return !overlaps.empty() && jetMaskTest(overlaps, ijet); }
+
+//-----------------------------------------------------------------------------
+// Jets passing a selection, kept as (index in the jet collection, correction
+// factor) pairs; the corrected p4 is only built when asked for. Up to 16
+// jets are stored without a heap allocation. getJets, nJets, sumPt,
+// getBtaggedJets and nBtaggedJets are wrappers around selectJets and
+// selectBtaggedJets.
+//-----------------------------------------------------------------------------
+class SelectedJets {
+public:
+    SelectedJets () : jets_(0), size_(0), onHeap_(false) {}
+
+    void clear (const std::vector<LorentzVector> *jets);
+    void push_back (unsigned int index, double corr);
+
+    unsigned int size () const { return size_; }
+    bool empty () const { return size_ == 0; }
+    unsigned int index (unsigned int i) const { return data()[i].index; }
+    double corr (unsigned int i) const { return data()[i].corr; }
+    double pt (unsigned int i) const { return jets_->at(data()[i].index).pt() * data()[i].corr; }
+    LorentzVector p4 (unsigned int i) const { return jets_->at(data()[i].index) * data()[i].corr; }
+
+    double sumPt () const;
+    // corrected p4s in the current order
+    std::vector<LorentzVector> p4s () const;
+
+    // order by decreasing corrected pt; sortLeading only puts the k
+    // leading jets in front, in order, and leaves the rest unordered
+    void sortByPt ();
+    void sortLeading (unsigned int k);
+
+private:
+    struct Entry {
+        unsigned int index;
+        double corr;
+    };
+    struct PtGreater;
+    static const unsigned int N_INLINE = 16;
+
+    const Entry* data () const { return onHeap_ ? &heap_[0] : inline_; }
+    Entry* data () { return onHeap_ ? &heap_[0] : inline_; }
+
+    const std::vector<LorentzVector> *jets_;
+    Entry inline_[N_INLINE];
+    std::vector<Entry> heap_;   // used once there are more than N_INLINE jets
+    unsigned int size_;
+    bool onHeap_;
+};
+
+void selectJets (SelectedJets &result,
+                 unsigned int i_hyp,  // hyp or single-e to use for cleaning
+                 enum JetType = JET_DEFAULT_TYPE,
+                 enum CleaningType = JET_DEFAULT_CLEANING,
+                 double deltaR = JET_DEFAULT_DR,
+                 double min_pt = JET_DEFAULT_PT,
+                 double max_eta = JET_DEFAULT_ETA,
+                 double rescale = 1.0,
+                 int systFlag = 0);
+
+void selectBtaggedJets (SelectedJets &result,
+                        unsigned int i_hyp,  // hyp or single-e to use for cleaning
+                        enum JetType = JET_DEFAULT_TYPE,
+                        enum CleaningType = JET_DEFAULT_CLEANING,
+                        enum BtagType = JETS_DEFAULT_BTAG,
+                        double deltaR = JET_DEFAULT_DR,
+                        double min_pt = JET_DEFAULT_PT,
+                        double max_eta = JET_DEFAULT_ETA,
+                        double rescale = 1.0,
+                        int systFlag = 0);
+
+//-----------------------------------------------------------------------------
+// Jet selection for several jet energy scale variations at once. The
+// |eta|, lepton cleaning and jet ID cuts are evaluated once per jet; each
+// variation only changes the correction factor, and with it the pt cut.
+// JES and JER variations start from the ntuple correction of the jet
+// type, whether the event is data or MC: on data pass
+// JETS_TYPE_PF_FAST_CORR_RESIDUAL to vary the residual corrected jets.
+//-----------------------------------------------------------------------------
+enum JetVariationType {
+    JETS_VAR_NOMINAL,   // as getJets with systFlag = 0
+    JETS_VAR_SYST,      // as getJets with systFlag = flag (getJetMetSyst)
+    JETS_VAR_JES,       // JetCorrectionUncertainty, scaled by (1 + flag * uncertainty)
+    JETS_VAR_JER        // JetSmearer::smearScale
+};
+
+struct JetVariation {
+    JetVariation (enum JetVariationType type_ = JETS_VAR_NOMINAL, int flag_ = 0, double rescale_ = 1.0)
+        : type(type_), flag(flag_), rescale(rescale_) {}
+    enum JetVariationType type;
+    int flag;
+    double rescale;
+};
+
+struct JetVariations {
+    const std::vector<LorentzVector> *jets;    // the jet collection of the jet type
+    double min_pt;
+    std::vector<unsigned int> index;           // jets passing the scale independent cuts
+    std::vector<std::vector<double> > corr;    // [ivar][icand]: factor applied to jets->at(index[icand])
+
+    unsigned int nVariations () const { return corr.size(); }
+    bool passes (unsigned int ivar, unsigned int icand) const { return !(jets->at(index[icand]).pt() * corr[ivar][icand] < min_pt); }
+    LorentzVector p4 (unsigned int ivar, unsigned int icand) const { return jets->at(index[icand]) * corr[ivar][icand]; }
+
+    // same as nJets, sumPt and getJets for variation ivar
+    int nJets (unsigned int ivar) const;
+    double sumPt (unsigned int ivar) const;
+    std::vector<LorentzVector> getJets (unsigned int ivar, bool sort = false) const;
+
+    // drops the candidates whose jet is in overlaps, for all variations
+    void removeOverlaps (const JetMask &overlaps);
+};
+
+class JetCorrectionUncertainty;
+class JetSmearer;
+// jet_unc and jet_smearer are only needed for JES and JER variations
+void getJetVariations (JetVariations &result,
+                       const std::vector<JetVariation> &variations,
+                       unsigned int i_hyp,  // hyp or single-e to use for cleaning
+                       enum JetType = JET_DEFAULT_TYPE,
+                       enum CleaningType = JET_DEFAULT_CLEANING,
+                       double deltaR = JET_DEFAULT_DR,
+                       double min_pt = JET_DEFAULT_PT,
+                       double max_eta = JET_DEFAULT_ETA,
+                       JetCorrectionUncertainty *jet_unc = 0,
+                       JetSmearer *jet_smearer = 0);
+
 // code to retrieve jet corrections from jet-correction text files
 class FactorizedJetCorrector;
 FactorizedJetCorrector *makeJetCorrector (const char *l2corr 		 = "$CMSSW_BASE/src/CondFormats/JetMETObjects/data/Spring10_L2Relative_AK5Calo.txt", 
@@ -118,10 +275,17 @@ bool jetPassesLooseJetID(int ijet);
 bool passesCaloJetID (const LorentzVector &jetp4);
 bool passesPFJetID(unsigned int pfJetIdx);
 
+// median pt density in an 8 x 10 grid of eta-phi cells (|eta| < 2.4);
+// computed once per event
 float randomConeEventDensity();
 
 float jetDz(int ijet, int ivtx);
 
+// 2012 MC jet resolution as sigma(pt)*pt, and the JER data/MC scale
+// factor; shared by the os2012 and samesign JER smearing
+float jetResolutionErrPt(float pt, float eta);
+float jetResolutionScale(float jet_eta);
+
 // vector of p4's of the jets passing selections
 std::vector<LorentzVector> getBtaggedJets (unsigned int i_hyp,  // hyp or single-e to use for cleaning
                                            bool sort = false,
@@ -166,4 +330,20 @@ std::vector<float> getJetBtagDiscriminators(enum BtagType btag_type, enum JetTyp
 // this function calculates the fraction of the pt of charged particles in a jet associated to the vertex ivtx
 float pfjet_beta(int ijet, int power = 1, float dzcut = 0.05 , int ivtx = 0, bool verbose = false );
 
+// statistics of the PF candidates of a PF jet, all filled in a single pass
+// over the constituents by pfjetConstituentInfo
+struct PFJetConstituentInfo {
+    std::vector<float> beta;  // pfjet_beta, one entry per requested (power, dzcut)
+    float dz;                 // jetDz
+    float ptD;                // constituentPtDistribution (QuarkGluonTagger)
+    float lrm;                // getLRM (QuarkGluonTagger), dz taken w.r.t. the first vertex
+    int   nCharged;           // charged hadron multiplicity
+    int   nNeutral;           // neutral hadron + photon multiplicity
+};
+
+void pfjetConstituentInfo(PFJetConstituentInfo &info, int ijet, int ivtx = 0,
+                          const std::vector<int> &betaPowers = std::vector<int>(1, 1),
+                          const std::vector<float> &betaDzCuts = std::vector<float>(1, 0.05),
+                          int lrmPower = 1);
+
 #endif // SEL_JETS_H
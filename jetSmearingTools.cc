@@ -29,7 +29,7 @@ JetSmearer* makeJetSmearer(std::vector<std::string> &vector_of_file_names)
             return 0;
         }
         char corr_name[1024];
-        int s = fscanf(f, " %1024s\n", corr_name);
+        int s = fscanf(f, " %1023s\n", corr_name);
         // std::cout << "s = " << s << std::endl;
         if (s != 1) {
             perror("reading file list");
@@ -4,6 +4,7 @@
 #include "TString.h"
 #include "TObjArray.h"
 #include "TF1.h"
+#include <cstdlib>
 
 using namespace std;
 
@@ -14,6 +15,11 @@ void JetSmearer::setDeltaR (double dr) {
 }
 
 LorentzVector JetSmearer::smearJet (const LorentzVector& p4, bool recoOnly)
+{
+    return p4 * smearScale(p4, recoOnly);
+}
+
+double JetSmearer::smearScale (const LorentzVector& p4, bool recoOnly)
 {
     double scale = 1.;
 
@@ -33,7 +39,7 @@ LorentzVector JetSmearer::smearJet (const LorentzVector& p4, bool recoOnly)
         scale = 1. + (kjet - 1.) * ((jet_energy - genjet_energy) / jet_energy);
     }
 
-    return p4 * scale;
+    return scale;
 }
 
 JetSmearer::JetSmearer() : deltaR_(0.5), res_delim_(",")
@@ -327,6 +333,44 @@ SigInputObj JetSmearer::evalPFJet(const LorentzVector& p4) const {
     return obj_jet;
 }
 
+// et * sqrt(C^2 + S^2/et + N^2/et^2) for parameters (N, S, C); a phi
+// resolution with a single parameter c is c * et
+double JetSmearer::evalResolution(resolutionType type, resolutionFunc func, double et) const {
+
+    std::map<functionCombo,functionPars>::const_iterator it = functionmap_.find(functionCombo(type, func));
+    if (it == functionmap_.end() || et <= 0.)
+        return 0.;
+    const functionPars &par = it->second;
+    if (func == PHI && par.size() == 1)
+        return par[0] * et;
+    if (par.size() < 3)
+        return 0.;
+    return et * sqrt(par[2]*par[2] + par[1]*par[1]/et + par[0]*par[0]/(et*et));
+}
+
+SigInputObj JetSmearer::evalPFCandidate(const LorentzVector& p4, int pdgId) const {
+
+    resolutionType type;
+    std::string inputtype;
+    switch (abs(pdgId)) {
+        case 211: type = PFtype1; inputtype = "PFChargedHadron"; break;
+        case 11:  type = PFtype2; inputtype = "PFElectron";      break;
+        case 13:  type = PFtype3; inputtype = "PFMuon";          break;
+        case 22:  type = PFtype4; inputtype = "PFPhoton";        break;
+        case 130: type = PFtype5; inputtype = "PFNeutralHadron"; break;
+        case 1:   type = PFtype6; inputtype = "PFHFHadron";      break;
+        case 2:   type = PFtype7; inputtype = "PFHFEM";          break;
+        default:  type = PFtype1; inputtype = "PFChargedHadron"; break;
+    }
+
+    double et  = p4.pt();
+    double phi = p4.phi();
+    double sigma_et  = evalResolution(type, ET, et);
+    double sigma_tan = evalResolution(type, PHI, et);
+    SigInputObj obj(inputtype, et, phi, sigma_et, sigma_tan);
+    return obj;
+}
+
 double JetSmearer::getJetPtThreshold ()
 {
     return ptResolThreshold_;
@@ -26,11 +26,17 @@ public:
     ~JetSmearer ();
     void setResFileNames (const std::string& ptFileName, const std::string& phiFileName, const std::string& resFileName);
   LorentzVector smearJet (const LorentzVector& p4, bool recoOnly = false);
+    // factor smearJet scales p4 by
+    double smearScale (const LorentzVector& p4, bool recoOnly = false);
     double getJetResolution(const LorentzVector& p4);
     void setDeltaR (double dr);
     double getJetPtThreshold ();
     void setDelimiter (const std::string&);
     std::string getDelimiter ();
+    // resolution terms of a PF jet and of a PF candidate (pdgId as in
+    // pfcands_particleId) without a track, for the MET significance
+    SigInputObj evalPFJet(const LorentzVector& p4)  const;
+    SigInputObj evalPFCandidate(const LorentzVector& p4, int pdgId) const;
 
 private:
     double deltaR_;
@@ -54,7 +60,7 @@ private:
     std::map<functionCombo,functionPars> functionmap_;
     void addfunction(const resolutionType type, const resolutionFunc func, std::vector<double> parameters);
     std::string getLine(std::ifstream *filep, const std::string& identifier);
-    SigInputObj evalPFJet(const LorentzVector& p4)  const;
+    double evalResolution(resolutionType type, resolutionFunc func, double et) const;
     std::string res_delim_;
 };
 
@@ -1,66 +1,143 @@
 #include <math.h>
 #include <stdlib.h>
 #include <set>
+#include <algorithm>
 #include "TDatabasePDG.h"
 #include "Math/VectorUtil.h"
 #include "CMS2.h"
 #include "mcSelections.h"
+#include "coreProfiler.h"
 #include "Math/LorentzVector.h"
 
 using namespace std;
 
 typedef ROOT::Math::LorentzVector<ROOT::Math::PxPyPzE4D<float> > LorentzVector;
 
+//-------------------------------------------------
+// Per-event index of the generator record
+//-------------------------------------------------
+const GenRecordIndex& genRecordIndex() {
+  static GenRecordIndex gen;
+  bool cached = !isNewEvent(gen.tag);
+  CORE_PROFILE_CACHE("genRecordIndex", cached);
+  if (cached)
+    return gen;
+
+  unsigned int size = cms2.genps_id().size();
+  gen.byId.resize(size);
+  gen.eta.resize(size);
+  gen.phi.resize(size);
+  gen.pt.resize(size);
+  gen.hasNuE.assign(size, false);
+  gen.hasNuMu.assign(size, false);
+  gen.status3.clear();
+  gen.taus.clear();
+  gen.tauDaughterBegin.clear();
+  gen.tauDaughterEta.clear();
+  gen.tauDaughterPhi.clear();
+  gen.firstZLepton = -1;
+
+  for (unsigned int i = 0; i < size; ++i) {
+    int id = cms2.genps_id()[i];
+    gen.byId[i] = std::make_pair(id, i);
+    gen.eta[i]  = cms2.genps_p4()[i].Eta();
+    gen.phi[i]  = cms2.genps_p4()[i].Phi();
+    gen.pt[i]   = cms2.genps_p4()[i].pt();
+
+    if (cms2.genps_status()[i] == 3)
+      gen.status3.push_back(i);
+
+    for (unsigned int j = 0; j < cms2.genps_lepdaughter_id()[i].size(); j++) {
+      int daughter = abs(cms2.genps_lepdaughter_id()[i][j]);
+      if (daughter == 12) gen.hasNuE[i]  = true;
+      if (daughter == 14) gen.hasNuMu[i] = true;
+    }
+
+    if (abs(id) == 15) {
+      gen.taus.push_back(i);
+      gen.tauDaughterBegin.push_back(gen.tauDaughterEta.size());
+      for (unsigned int j = 0; j < cms2.genps_lepdaughter_id()[i].size(); j++) {
+        gen.tauDaughterEta.push_back(cms2.genps_lepdaughter_p4()[i][j].Eta());
+        gen.tauDaughterPhi.push_back(cms2.genps_lepdaughter_p4()[i][j].Phi());
+      }
+    }
+
+    if (gen.firstZLepton < 0 && cms2.genps_id_mother()[i] == 23 && (abs(id) == 11 || abs(id) == 13 || abs(id) == 15))
+      gen.firstZLepton = i;
+  }
+  gen.tauDaughterBegin.push_back(gen.tauDaughterEta.size());
+
+  std::sort(gen.byId.begin(), gen.byId.end());
+  return gen;
+}
+
+unsigned int genCountWithId(int id) {
+  const GenRecordIndex &gen = genRecordIndex();
+  std::vector<std::pair<int, unsigned int> >::const_iterator first =
+    std::lower_bound(gen.byId.begin(), gen.byId.end(), std::make_pair(id, 0u));
+  std::vector<std::pair<int, unsigned int> >::const_iterator last =
+    std::lower_bound(first, gen.byId.end(), std::make_pair(id + 1, 0u));
+  return last - first;
+}
+
+unsigned int genNearestIndex(const LorentzVector& p4) {
+  const GenRecordIndex &gen = genRecordIndex();
+  float eta = p4.Eta();
+  float phi = p4.Phi();
+  unsigned int mc3idx = 999999;
+  double mindR = 9999;
+  for (unsigned int i = 0; i < gen.eta.size(); i++) {
+    float dr = deltaRFromEtaPhi(eta, phi, gen.eta[i], gen.phi[i]);
+    if (dr < mindR) {
+      mindR = dr;
+      mc3idx = i;
+    }
+  }
+  return mc3idx;
+}
+
+int genTauLeptonMotherId(const LorentzVector& mc_p4, int nu_id, int st1_motherid) {
+  const GenRecordIndex &gen = genRecordIndex();
+  float eta = mc_p4.Eta();
+  float phi = mc_p4.Phi();
+  bool foundneutrino = false; //ensures that the matched lepton from a tau really came from a W
+  for (unsigned int k = 0; k < gen.taus.size(); k++) {
+    unsigned int i = gen.taus[k];
+    if (nu_id == 12 ? gen.hasNuE[i] : gen.hasNuMu[i])
+      foundneutrino = true;
+    for (unsigned int j = gen.tauDaughterBegin[k]; j < gen.tauDaughterBegin[k+1]; j++) {
+      if (deltaRFromEtaPhi(eta, phi, gen.tauDaughterEta[j], gen.tauDaughterPhi[j]) < 0.0001) //should be the same exact status==1 gen particle!
+        st1_motherid = cms2.genps_id_mother()[i];
+    }
+    if (!foundneutrino)
+      st1_motherid = -9999;
+  }
+  return st1_motherid;
+}
+
 //-------------------------------------------------
 // Auxiliary function to scan the doc line and 
 // identify DY-> ee vs mm vs tt
 //-------------------------------------------------
 int getDrellYanType() {
-  bool foundEP = false;
-  bool foundEM = false;
-  bool foundMP = false;
-  bool foundMM = false;
-  bool foundTP = false;
-  bool foundTM = false;
-  for (unsigned int i = 0; i < cms2.genps_id().size(); ++i) {
-    if ( cms2.genps_id_mother().at(i) == 23 ){
-      switch ( TMath::Abs(cms2.genps_id().at(i)) ){
-      case 11:
-	return 0;
-	break;
-      case 13:
-	return 1;
-	break;
-      case 15:
-	return 2;
-	break;
-      default:
-	break;
-      }
-    }
-    switch ( cms2.genps_id().at(i) ){
+  const GenRecordIndex &gen = genRecordIndex();
+  if (gen.firstZLepton >= 0) {
+    switch ( TMath::Abs(cms2.genps_id().at(gen.firstZLepton)) ){
     case 11:
-      foundEM = true;
-      break;
-    case -11:
-      foundEP = true;
-      break;
+      return 0;
     case 13:
-      foundMM = true;
-      break;
-    case -13:
-      foundMP = true;
-      break;
-    case 15:
-      foundTM = true;
-      break;
-    case -15:
-      foundTP = true;
-      break;
+      return 1;
     default:
-      break;
+      return 2;
     }
   }
+
+  bool foundEP = genCountWithId(-11) > 0;
+  bool foundEM = genCountWithId(11)  > 0;
+  bool foundMP = genCountWithId(-13) > 0;
+  bool foundMM = genCountWithId(13)  > 0;
+  bool foundTP = genCountWithId(-15) > 0;
+  bool foundTM = genCountWithId(15)  > 0;
   
   if ( foundEP && foundEM ) return 0;  //DY->ee
   if ( foundMP && foundMM ) return 1;  //DY->mm
@@ -311,36 +388,12 @@ bool isZZ() {
 //------------------------------------------
 int getZZType() 
 {
-     int foundEP = 0;
-     int foundEM = 0;
-     int foundMP = 0;
-     int foundMM = 0;
-     int foundTP = 0;
-     int foundTM = 0;
-     for (unsigned int i = 0; i < cms2.genps_id().size(); ++i) {
-	  switch ( cms2.genps_id().at(i) ){
-	  case 11:
-	       foundEM++;
-	       break;
-	  case -11:
-	       foundEP++;
-	       break;
-	  case 13:
-	       foundMM++;
-	       break;
-	  case -13:
-	       foundMP++;
-	       break;
-	  case 15:
-	       foundTM++;
-	       break;
-	  case -15:
-	       foundTP++;
-	       break;
-	  default:
-	       break;
-	  }
-     }
+     int foundEP = genCountWithId(-11);
+     int foundEM = genCountWithId(11);
+     int foundMP = genCountWithId(-13);
+     int foundMM = genCountWithId(13);
+     int foundTP = genCountWithId(-15);
+     int foundTM = genCountWithId(15);
   
      if (foundEM == foundEP && foundMM == foundMP && (foundEM != 0 || foundMM != 0)) {
 	  // both Zs decay to e or mu
@@ -494,25 +547,8 @@ int leptonIsFromW(int idx, int id, bool alsoSusy) {
     //we have to do some work to trace the parentage
     //to do this, we have to go to the status==3 block because 
     //the daughter info is not in status==1
-    if(abs(st1_motherid)==15) {
-      bool foundelectronneutrino = false; //ensures that the matched electron from a tau really came from a W
-      for(unsigned int i = 0; i < cms2.genps_id().size(); i++) {//status 3 loop
-	if(abs(cms2.genps_id()[i]) == 15 ) { //make sure we get the right tau!
-	  cms2.genps_lepdaughter_id()[i].size(); 
-	  for(unsigned int j = 0; j < cms2.genps_lepdaughter_id()[i].size(); j++) { //loop over the tau's status1 daughters
-	    if(abs(cms2.genps_lepdaughter_id()[i][j]) == 12)
-	      foundelectronneutrino = true;
-	    float dr = ROOT::Math::VectorUtil::DeltaR(cms2.els_mc_p4()[idx], cms2.genps_lepdaughter_p4()[i][j]);
-	    if (dr < 0.0001) { //should be the same exact status==1 gen particle!
-	      st1_motherid = cms2.genps_id_mother()[i];
-	      continue;
-	    }//if (dr < 0.0001)
-	  }//loop over the tau's daughters
-	  if(!foundelectronneutrino)
-	    st1_motherid = -9999;
-	}//tau
-      }//status 3 loop
-    }//if(abs(st1_motherid)==15) {
+    if(abs(st1_motherid)==15)
+      st1_motherid = genTauLeptonMotherId(cms2.els_mc_p4()[idx], 12, st1_motherid);
   } else if (abs(id) == 13) {
     st1_id = cms2.mus_mc_id()[idx];
     st3_id = cms2.mus_mc3_id()[idx];
@@ -522,25 +558,8 @@ int leptonIsFromW(int idx, int id, bool alsoSusy) {
     //we have to do some work to trace the parentage
     //to do this, we have to go to the status==3 block because 
     //the daughter info is not in status==1
-    if(abs(st1_motherid)==15) {
-      bool foundmuonneutrino = false;
-      for(unsigned int i = 0; i < cms2.genps_id().size(); i++) {//status 3 loop
-	if(abs(cms2.genps_id()[i]) == 15 ) { //make sure we get the right tau!
-	  cms2.genps_lepdaughter_id()[i].size();
-	  for(unsigned int j = 0; j < cms2.genps_lepdaughter_id()[i].size(); j++) {//loop over the tau's status1 daughters
-	    if(abs(cms2.genps_lepdaughter_id()[i][j]) == 14)
-	      foundmuonneutrino = true;
-	    float dr = ROOT::Math::VectorUtil::DeltaR(cms2.mus_mc_p4()[idx], cms2.genps_lepdaughter_p4()[i][j]);
-	    if (dr < 0.0001) { //should be the same exact status==1 gen particle!
- 	      st1_motherid = cms2.genps_id_mother()[i];
-	      continue;
-	    }//if (dr < 0.0001)
-	  }//loop over the tau's daughters
-	  if(!foundmuonneutrino)
-	    st1_motherid = -9999;
-	}//tau
-      }//status 3 loop
-    }//if(abs(st1_motherid)==15) {
+    if(abs(st1_motherid)==15)
+      st1_motherid = genTauLeptonMotherId(cms2.mus_mc_p4()[idx], 14, st1_motherid);
   } else {
     std::cout << "You fool.  Give me +/- 11 or +/- 13 please" << std::endl;
     return false;
@@ -605,21 +624,9 @@ int leptonIsFromW(int idx, int id, bool alsoSusy) {
   if(abs(st3_id) == 15) {
     //have to find the index of the status3 particle by dR
     //because the indices are buggy
-    unsigned int mc3idx = 999999;
-    LorentzVector lepp4 =  abs(id)==11 ? cms2.els_p4()[idx] : cms2.mus_p4()[idx];
-    double mindR = 9999;
-    for(unsigned int i = 0; i < cms2.genps_id().size(); i++) {
-      float dr = ROOT::Math::VectorUtil::DeltaR(lepp4, cms2.genps_p4()[i]);
-      if(dr < mindR) {
-	mindR = dr;
-	mc3idx = i;
-      }
-    }
-    bool foundElOrMuNu = false;    
-    for(unsigned int i = 0; i < cms2.genps_lepdaughter_p4()[mc3idx].size(); i++) {
-      if(abs(cms2.genps_lepdaughter_id()[mc3idx][i]) == 12 || abs(cms2.genps_lepdaughter_id()[mc3idx][i]) == 14)
-	foundElOrMuNu = true;
-    }
+    unsigned int mc3idx = genNearestIndex(abs(id)==11 ? cms2.els_p4()[idx] : cms2.mus_p4()[idx]);
+    const GenRecordIndex &gen = genRecordIndex();
+    bool foundElOrMuNu = gen.hasNuE.at(mc3idx) || gen.hasNuMu.at(mc3idx);
     if(!foundElOrMuNu) //comes from a hadronic decay of the tau
       return -3;
     if(id*st3_id > 0) 
@@ -1020,16 +1027,18 @@ bool isNotPromptSusyLeptonHyp(int idx) {
 int mc3idx_eormu(int id, int idx, float maxDr, float minPt){
   LorentzVector lepp4 =  abs(id)==11 ? cms2.els_p4()[idx] : cms2.mus_p4()[idx];
   
+  const GenRecordIndex &gen = genRecordIndex();
+  float eta = lepp4.Eta();
+  float phi = lepp4.Phi();
+  
   float dRMin = 999999;
-  int nGens = cms2.genps_id().size();
   int genidx = -1;
-  for (int iG = 0; iG < nGens; ++iG){
-    if (cms2.genps_status()[iG]==3){
-      float dr = ROOT::Math::VectorUtil::DeltaR(lepp4, cms2.genps_p4()[iG]);
-      if (dr < maxDr && cms2.genps_p4()[iG].pt() > minPt && dr < dRMin){
-	genidx = iG;
-	dRMin = dr;
-      }
+  for (unsigned int k = 0; k < gen.status3.size(); ++k){
+    unsigned int iG = gen.status3[k];
+    float dr = deltaRFromEtaPhi(eta, phi, gen.eta[iG], gen.phi[iG]);
+    if (dr < maxDr && gen.pt[iG] > minPt && dr < dRMin){
+      genidx = iG;
+      dRMin = dr;
     }
   }
   return genidx;
@@ -2,7 +2,45 @@
 # ifndef MCSELECTIONS_H
 # define MCSELECTIONS_H
 
+#include <utility>
+#include <vector>
 #include "CMS2.h"
+#include "utilities.h"
+
+//--------------------------------------------------------
+// Per-event index of the generator record (genps_), built
+// on first use in each event and shared by the MC truth
+// functions below. The record only stores mother ids, so
+// the daughter adjacency is that of genps_lepdaughter_.
+//--------------------------------------------------------
+struct GenRecordIndex {
+  EventTag tag;
+  std::vector<std::pair<int, unsigned int> > byId;  // (pdg id, genps index), sorted
+  std::vector<float> eta;                           // of genps_p4
+  std::vector<float> phi;
+  std::vector<float> pt;
+  std::vector<unsigned int> status3;                // genps with status 3
+  std::vector<bool> hasNuE;                         // lepton daughters include a nu_e
+  std::vector<bool> hasNuMu;                        // lepton daughters include a nu_mu
+  std::vector<unsigned int> taus;                   // genps with |id| == 15
+  std::vector<unsigned int> tauDaughterBegin;       // daughters of taus[k] are [tauDaughterBegin[k], tauDaughterBegin[k+1])
+  std::vector<float> tauDaughterEta;
+  std::vector<float> tauDaughterPhi;
+  int firstZLepton;                                 // first e, mu or tau with a Z mother, -1 if none
+};
+
+const GenRecordIndex& genRecordIndex();
+
+// number of genps with the given (signed) pdg id
+unsigned int genCountWithId(int id);
+
+// index of the genps closest in dR to p4, 999999 if there is none
+unsigned int genNearestIndex(const LorentzVector& p4);
+
+// tau walk of leptonIsFromW for a status 1 lepton mc_p4 with a tau mother:
+// returns the mother id of the tau whose lepton daughters contain mc_p4,
+// -9999 if the taus have no neutrino of flavour nu_id (12 or 14)
+int genTauLeptonMotherId(const LorentzVector& mc_p4, int nu_id, int st1_motherid);
 
 int getDrellYanType();
 bool isDYee();
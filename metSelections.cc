@@ -6,6 +6,8 @@
 #include <algorithm>
 #include <string>
 #include <utility>
+#include <sstream>
+#include <stdexcept>
 #include "TMath.h"
 #include "TVector2.h"
 #include "Math/LorentzVector.h"
@@ -18,13 +20,14 @@
 #include "metSelections.h"
 #include "jetSelections.h"
 #include "eventSelections.h"
+#include "utilities.h"
+#include "coreProfiler.h"
 #include "jetcorr/FactorizedJetCorrector.h"
 
 //---------------------------------------------
 // function to calculate latest tcMET
 //---------------------------------------------
 #include "tcmet/getTcmetFromCaloMet.icc"
-#include "tcmet/getResponseFunction_fit.icc"
 
 typedef ROOT::Math::LorentzVector<ROOT::Math::PtEtaPhiE4D<float> > LorentzVector2;
 
@@ -66,9 +69,7 @@ metStruct customType1Met( float metx , float mety , float sumet  , VofP4 jets ,
 
 metStruct correctedTCMET(bool printout, ostream& ostr) 
 {
-    // static because we only want to get the response function once
-    static TH2F* rf = getResponseFunction_fit();
-    return getTcmetFromCaloMet(rf, printout,ostr);
+    return getTcmetFromCaloMet(printout, ostr);
 }
 
 //---------------------------------------------------
@@ -321,49 +322,119 @@ metStruct correctTCMETforHypMuons (int hyp_index, float met_x, float met_y, floa
    }
  */
 
+//
+// per-event PF candidate quantities used by trackerMET: eta and phi for the
+// DeltaR tests, and dz to the first vertex for charged candidates with a track
+//
+namespace {
+
+    struct TrackerMETCands {
+        EventTag tag;
+        std::vector<float>  eta;
+        std::vector<float>  phi;
+        std::vector<double> dz;
+        std::vector<bool>   hasTrack;
+    };
+
+    const TrackerMETCands& trackerMETCands() {
+        static TrackerMETCands cands;
+        bool cached = !isNewEvent(cands.tag);
+        CORE_PROFILE_CACHE("trackerMETCands", cached);
+        if (cached)
+            return cands;
+
+        const std::vector<LorentzVector> &p4s = cms2.pfcands_p4();
+        unsigned int n = cms2.pfcands_particleId().size();
+        cands.eta.resize(n);
+        cands.phi.resize(n);
+        cands.dz.assign(n, 0.);
+        cands.hasTrack.assign(n, false);
+        for (unsigned int i = 0; i < n; ++i) {
+            cands.eta[i] = p4s.at(i).Eta();
+            cands.phi[i] = p4s.at(i).Phi();
+            if (cms2.pfcands_charge().at(i) == 0) continue;
+            int trkIndex = cms2.pfcands_trkidx().at(i);
+            if (trkIndex < 0) continue;
+            cands.hasTrack[i] = true;
+            cands.dz[i] = dzPV(cms2.trks_vertex_p4()[trkIndex], cms2.trks_trk_p4()[trkIndex], cms2.vtxs_position().front());
+        }
+        return cands;
+    }
+
+}
+
 metStruct trackerMET( int hyp_index, double deltaZCut,
         const std::vector<LorentzVector>* jets )
 {
-    if ( cms2.vtxs_sumpt().empty() ) return metStruct();
-    double pX(0), pY(0);
-    pX -= cms2.hyp_lt_p4().at(hyp_index).px();
-    pY -= cms2.hyp_lt_p4().at(hyp_index).py();
-    pX -= cms2.hyp_ll_p4().at(hyp_index).px();
-    pY -= cms2.hyp_ll_p4().at(hyp_index).py();
-
-    for (unsigned int i=0; i<cms2.pfcands_particleId().size(); ++i){
-        if ( cms2.pfcands_charge().at(i)==0 ) continue;
-        if ( fabs(ROOT::Math::VectorUtil::DeltaR(cms2.pfcands_p4().at(i),cms2.hyp_lt_p4().at(hyp_index)))<0.1 ) continue;
-        if ( fabs(ROOT::Math::VectorUtil::DeltaR(cms2.pfcands_p4().at(i),cms2.hyp_ll_p4().at(hyp_index)))<0.1 ) continue;
-        if ( jets ){
-            bool matched = false;
-            for ( std::vector<LorentzVector>::const_iterator jet = jets->begin(); jet != jets->end(); ++jet )
-                if ( fabs(ROOT::Math::VectorUtil::DeltaR(cms2.pfcands_p4().at(i),*jet))<0.5 ) matched=true;
-            if (matched) continue;
-        }
+    std::vector<metStruct> mets;
+    trackerMET(mets, std::vector<int>(1, hyp_index), deltaZCut, jets);
+    return mets.front();
+}
 
-        int trkIndex = cms2.pfcands_trkidx().at(i);
-        if (trkIndex<0) continue;
-        double dzpv = dzPV(cms2.trks_vertex_p4()[trkIndex], cms2.trks_trk_p4()[trkIndex], cms2.vtxs_position().front());
+void trackerMET( std::vector<metStruct>& mets, const std::vector<int>& hyp_indices,
+        double deltaZCut, const std::vector<LorentzVector>* jets )
+{
+    const unsigned int nhyp = hyp_indices.size();
+    mets.assign(nhyp, metStruct());
+    if ( cms2.vtxs_sumpt().empty() ) return;
+
+    std::vector<double> pX(nhyp, 0), pY(nhyp, 0);
+    std::vector<float> lt_eta(nhyp), lt_phi(nhyp), ll_eta(nhyp), ll_phi(nhyp);
+    for (unsigned int h=0; h<nhyp; ++h){
+        const LorentzVector &lt = cms2.hyp_lt_p4().at(hyp_indices[h]);
+        const LorentzVector &ll = cms2.hyp_ll_p4().at(hyp_indices[h]);
+        pX[h] -= lt.px();
+        pY[h] -= lt.py();
+        pX[h] -= ll.px();
+        pY[h] -= ll.py();
+        lt_eta[h] = lt.Eta();
+        lt_phi[h] = lt.Phi();
+        ll_eta[h] = ll.Eta();
+        ll_phi[h] = ll.Phi();
+    }
 
-        if ( fabs(dzpv) > deltaZCut) continue;
+    std::vector<float> jet_eta, jet_phi;
+    if ( jets ){
+        for ( std::vector<LorentzVector>::const_iterator jet = jets->begin(); jet != jets->end(); ++jet ){
+            jet_eta.push_back(jet->Eta());
+            jet_phi.push_back(jet->Phi());
+        }
+    }
 
-        pX -= cms2.pfcands_p4().at(i).px();
-        pY -= cms2.pfcands_p4().at(i).py();
+    // charged candidates with a track from the first vertex and away from
+    // the jets are shared by all hypotheses; only the lepton veto differs
+    const TrackerMETCands &cands = trackerMETCands();
+    const std::vector<LorentzVector> &p4s = cms2.pfcands_p4();
+    for (unsigned int i=0; i<cands.hasTrack.size(); ++i){
+        if ( !cands.hasTrack[i] ) continue;
+        if ( fabs(cands.dz[i]) > deltaZCut) continue;
+
+        bool matched = false;
+        for (unsigned int j=0; j<jet_eta.size() && !matched; ++j)
+            if ( deltaRFromEtaPhi(cands.eta[i], cands.phi[i], jet_eta[j], jet_phi[j]) < 0.5 ) matched=true;
+        if (matched) continue;
+
+        for (unsigned int h=0; h<nhyp; ++h){
+            if ( deltaRFromEtaPhi(cands.eta[i], cands.phi[i], lt_eta[h], lt_phi[h]) < 0.1 ) continue;
+            if ( deltaRFromEtaPhi(cands.eta[i], cands.phi[i], ll_eta[h], ll_phi[h]) < 0.1 ) continue;
+            pX[h] -= p4s.at(i).px();
+            pY[h] -= p4s.at(i).py();
+        }
     }
 
-    if (jets){
-        for ( std::vector<LorentzVector>::const_iterator jet = jets->begin(); jet != jets->end(); ++jet ){
-            pX -= jet->px();
-            pY -= jet->py();
+    for (unsigned int h=0; h<nhyp; ++h){
+        if (jets){
+            for ( std::vector<LorentzVector>::const_iterator jet = jets->begin(); jet != jets->end(); ++jet ){
+                pX[h] -= jet->px();
+                pY[h] -= jet->py();
+            }
         }
+        metStruct &met = mets[h];
+        met.met     = sqrt(pX[h] * pX[h] + pY[h] * pY[h]);
+        met.metphi  = atan2(pY[h], pX[h]);
+        met.metx = pX[h];
+        met.mety = pY[h];
     }
-    metStruct met;
-    met.met     = sqrt(pX * pX + pY * pY);
-    met.metphi  = atan2(pY, pX);
-    met.metx = pX;
-    met.mety = pY;
-    return met;
 }
 
 LorentzVector cmsReducedMET(LorentzVector sumJet, LorentzVector lep1, LorentzVector lep2, LorentzVector metP4, int version) 
@@ -499,6 +570,195 @@ std::pair<float, float> scaleMET(std::pair<float, float> p_met, LorentzVector p4
     return ( std::make_pair(sqrt(metNewx * metNewx + metNewy * metNewy), metNewPhi) );
 }
 
+//-----------------------------------------------------
+// batch projected and reduced MET
+//-----------------------------------------------------
+MetProjector::MetProjector ()
+    : nhyp_(0)
+{
+}
+
+void MetProjector::setHypotheses(const std::vector<int> &hyp_indices, const std::vector<LorentzVector> &jets, int cms_reduced_version)
+{
+    nhyp_ = hyp_indices.size();
+    lt_phi_.resize(nhyp_);
+    ll_phi_.resize(nhyp_);
+    dil_x_.resize(nhyp_);
+    dil_y_.resize(nhyp_);
+    al_x_.resize(nhyp_);
+    al_y_.resize(nhyp_);
+    at_x_.resize(nhyp_);
+    at_y_.resize(nhyp_);
+    dilLong_.resize(nhyp_);
+    dilPerp_.resize(nhyp_);
+    jetLong_.resize(nhyp_);
+    jetPerp_.resize(nhyp_);
+    rot_c_.resize(nhyp_);
+    rot_s_.resize(nhyp_);
+    clu_x_.resize(nhyp_);
+    clu_y_.resize(nhyp_);
+
+    LorentzVector sumJet;
+    for (unsigned int j = 0; j < jets.size(); ++j)
+        sumJet += jets[j];
+
+    // same arithmetic as the TVector2 operations of cmsReducedMET_v2
+    const double c90 = cos(TMath::Pi()/2);
+    const double s90 = sin(TMath::Pi()/2);
+
+    for (unsigned int h = 0; h < nhyp_; ++h) {
+        const LorentzVector &lep1 = cms2.hyp_lt_p4().at(hyp_indices[h]);
+        const LorentzVector &lep2 = cms2.hyp_ll_p4().at(hyp_indices[h]);
+        lt_phi_[h] = lep1.phi();
+        ll_phi_[h] = lep2.phi();
+
+        const LorentzVector &lead  = lep1.Pt() > lep2.Pt() ? lep1 : lep2;
+        const LorentzVector &trail = lep1.Pt() > lep2.Pt() ? lep2 : lep1;
+        double lead_x  = lead.px();
+        double lead_y  = lead.py();
+        double trail_x = trail.px();
+        double trail_y = trail.py();
+
+        dil_x_[h] = lead_x + trail_x;
+        dil_y_[h] = lead_y + trail_y;
+        double thr_x = lead_x - trail_x;
+        double thr_y = lead_y - trail_y;
+        float dphill = fabs(ROOT::Math::VectorUtil::DeltaPhi(lep1, lep2));
+
+        double al_x = 0., al_y = 0., at_x = 0., at_y = 0.;
+        if (dphill >= TMath::Pi()/2) {
+            if (thr_x * thr_x + thr_y * thr_y) {
+                double mod = TMath::Sqrt(thr_x * thr_x + thr_y * thr_y);
+                al_x = thr_x / mod;
+                al_y = thr_y / mod;
+            }
+            at_x = al_x * c90 - al_y * s90;
+            at_y = al_x * s90 + al_y * c90;
+            if (at_x * lead_x + at_y * lead_y < 0) {
+                at_x *= -1;
+                at_y *= -1;
+            }
+        } else {
+            if (dil_x_[h] * dil_x_[h] + dil_y_[h] * dil_y_[h]) {
+                double mod = TMath::Sqrt(dil_x_[h] * dil_x_[h] + dil_y_[h] * dil_y_[h]);
+                at_x = dil_x_[h] / mod;
+                at_y = dil_y_[h] / mod;
+            }
+            al_x = at_x * c90 - at_y * s90;
+            al_y = at_x * s90 + at_y * c90;
+            if (al_x * lead_x + al_y * lead_y < 0) {
+                al_x *= -1;
+                al_y *= -1;
+            }
+        }
+        al_x_[h] = al_x;
+        al_y_[h] = al_y;
+        at_x_[h] = at_x;
+        at_y_[h] = at_y;
+
+        dilLong_[h] = dil_x_[h] * al_x + dil_y_[h] * al_y;
+        dilPerp_[h] = dil_x_[h] * at_x + dil_y_[h] * at_y;
+
+        float jetLong = 0.;
+        float jetPerp = 0.;
+        for (unsigned int j = 0; j < jets.size(); ++j) {
+            double jet_x = jets[j].Px();
+            double jet_y = jets[j].Py();
+            jetLong += jet_x * al_x + jet_y * al_y;
+            jetPerp += jet_x * at_x + jet_y * at_y;
+        }
+        jetLong_[h] = jetLong;
+        jetPerp_[h] = jetPerp;
+
+        // cmsReducedMET: rotation to the bisector (version 1) or dilepton (version 2) axis
+        LorentzVector Q = lep1 + lep2;
+        double angle = 0.;
+        if (cms_reduced_version == 1) {
+            float bisectorPhi = min(lep1.Phi(), lep2.Phi()) + ROOT::Math::VectorUtil::DeltaPhi(lep1, lep2)/2;
+            angle = -bisectorPhi;
+        } else if (cms_reduced_version == 2) {
+            angle = -Q.Phi();
+        }
+        double c = cms_reduced_version == 1 || cms_reduced_version == 2 ? TMath::Cos(angle) : 1.;
+        double s = cms_reduced_version == 1 || cms_reduced_version == 2 ? TMath::Sin(angle) : 0.;
+        rot_c_[h] = c;
+        rot_s_[h] = s;
+        clu_x_[h] = (Q.Px() * c - Q.Py() * s) + 1. * (sumJet.Px() * c - sumJet.Py() * s);
+        clu_y_[h] = (Q.Px() * s + Q.Py() * c) + 1. * (sumJet.Px() * s + sumJet.Py() * c);
+    }
+}
+
+void MetProjector::compute(const std::vector<std::vector<metStruct> > &mets)
+{
+    // each flavour has one metStruct for the event or one per hypothesis
+    for (unsigned int f = 0; f < mets.size(); ++f) {
+        if (mets[f].size() != 1 && mets[f].size() != nhyp_) {
+            std::ostringstream message;
+            message << "MetProjector::compute: MET flavour " << f << " has " << mets[f].size()
+                    << " entries, expected 1 or one per hypothesis (" << nhyp_ << ")";
+            std::cout << message.str() << std::endl;
+            throw std::invalid_argument(message.str());
+        }
+    }
+
+    unsigned int n = mets.size() * nhyp_;
+    projected_.resize(n);
+    reducedLong_.resize(n);
+    reducedPerp_.resize(n);
+    cmsReduced_x_.resize(n);
+    cmsReduced_y_.resize(n);
+
+    for (unsigned int f = 0; f < mets.size(); ++f) {
+        const std::vector<metStruct> &flavour = mets[f];
+        for (unsigned int h = 0; h < nhyp_; ++h) {
+            const metStruct &met = flavour[flavour.size() == 1 ? 0 : h];
+            unsigned int i = f * nhyp_ + h;
+
+            // projectedMET
+            float tightDPhi = min(fabs(lt_phi_[h] - met.metphi), (float)(2 * TMath::Pi()) - fabs(lt_phi_[h] - met.metphi));
+            float looseDPhi = min(fabs(ll_phi_[h] - met.metphi), (float)(2 * TMath::Pi()) - fabs(ll_phi_[h] - met.metphi));
+            float deltaPhi  = min(tightDPhi, looseDPhi);
+            projected_[i] = ((deltaPhi < TMath::Pi() / 2.) ? met.met * sin(deltaPhi) : met.met);
+
+            // cmsReducedMET_v2, independent minimization
+            double uncl_x = met.met * cos(met.metphi) + dil_x_[h];
+            double uncl_y = met.met * sin(met.metphi) + dil_y_[h];
+            float unclLong = uncl_x * al_x_[h] + uncl_y * al_y_[h];
+            float unclPerp = uncl_x * at_x_[h] + uncl_y * at_y_[h];
+
+            float unclRedMet_long = dilLong_[h] - 1.0 * unclLong;
+            float unclRedMet_perp = dilPerp_[h] - 1.0 * unclPerp;
+            float cluRedMet_long  = dilLong_[h] + 1.0 * jetLong_[h];
+            float cluRedMet_perp  = dilPerp_[h] + 1.0 * jetPerp_[h];
+
+            reducedLong_[i] = (fabs(unclRedMet_long) < fabs(cluRedMet_long) ? unclRedMet_long : cluRedMet_long);
+            reducedPerp_[i] = (fabs(unclRedMet_perp) < fabs(cluRedMet_perp) ? unclRedMet_perp : cluRedMet_perp);
+
+            // cmsReducedMET
+            double met_x = met.met * cos(met.metphi);
+            double met_y = met.met * sin(met.metphi);
+            double uncl_rx = -(met_x * rot_c_[h] - met_y * rot_s_[h]);
+            double uncl_ry = -(met_x * rot_s_[h] + met_y * rot_c_[h]);
+            cmsReduced_x_[i] = (fabs(uncl_rx) < fabs(clu_x_[h]) ? uncl_rx : clu_x_[h]);
+            cmsReduced_y_[i] = (fabs(uncl_ry) < fabs(clu_y_[h]) ? uncl_ry : clu_y_[h]);
+        }
+    }
+}
+
+std::pair<float, float> MetProjector::reducedMET(unsigned int flavour, unsigned int ihyp) const
+{
+    unsigned int i = flavour * nhyp_ + ihyp;
+    return std::make_pair(reducedLong_.at(i), reducedPerp_.at(i));
+}
+
+LorentzVector MetProjector::cmsReducedMET(unsigned int flavour, unsigned int ihyp) const
+{
+    unsigned int i = flavour * nhyp_ + ihyp;
+    double x = cmsReduced_x_.at(i);
+    double y = cmsReduced_y_.at(i);
+    return LorentzVector(x, y, 0, sqrt(x * x + y * y));
+}
+
 MetCorrector::MetCorrector(std::vector<std::string> &list_of_files)
 {
     //
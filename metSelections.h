@@ -89,6 +89,10 @@ metStruct customType1Met( float metx , float mety , float sumet  , VofP4 jets ,
 metStruct trackerMET( int hyp_index, double deltaZCut = 0.2, 
                       const VofP4* jets = 0 );
 
+// trackerMET for each of hyp_indices, in a single pass over the PF candidates
+void trackerMET( std::vector<metStruct>& mets, const std::vector<int>& hyp_indices,
+                 double deltaZCut = 0.2, const VofP4* jets = 0 );
+
 
 //---------------------------------------------
 // function to calculate CMS reduced MET
@@ -102,6 +106,61 @@ std::pair<float, float> cmsReducedMET_v2(LorentzVector lep1, LorentzVector lep2,
 //-----------------------------------------------------
 std::pair<float, float> scaleMET(std::pair<float, float> p_met, LorentzVector p4_dilep, double rescale = 1.0);
 
+//-----------------------------------------------------
+// projected MET and CMS reduced MET (as projectedMET,
+// cmsReducedMET_v2 and cmsReducedMET) for several
+// hypotheses and several MET flavours in one call; the
+// buffers are reused from event to event
+//-----------------------------------------------------
+class MetProjector
+{
+public:
+    MetProjector ();
+
+    // hypothesis leptons (hyp_lt_p4, hyp_ll_p4) and the jets entering the reduced MET;
+    // cms_reduced_version is the version argument of cmsReducedMET
+    void setHypotheses(const std::vector<int> &hyp_indices, const std::vector<LorentzVector> &jets, int cms_reduced_version = 1);
+
+    // mets[flavour] holds one metStruct for the event (pf, tc, type1, ...)
+    // or one per hypothesis (e.g. from the vector version of trackerMET);
+    // any other size throws std::invalid_argument
+    void compute(const std::vector<std::vector<metStruct> > &mets);
+
+    unsigned int nHypotheses() const { return nhyp_; }
+    float projectedMET(unsigned int flavour, unsigned int ihyp) const { return projected_.at(flavour * nhyp_ + ihyp); }
+    std::pair<float, float> reducedMET(unsigned int flavour, unsigned int ihyp) const;
+    // as cmsReducedMET with metP4 from the met and metphi of the metStruct
+    LorentzVector cmsReducedMET(unsigned int flavour, unsigned int ihyp) const;
+
+private:
+    unsigned int nhyp_;
+
+    // per hypothesis
+    std::vector<float>  lt_phi_;
+    std::vector<float>  ll_phi_;
+    std::vector<double> dil_x_;
+    std::vector<double> dil_y_;
+    std::vector<double> al_x_;      // longitudinal axis
+    std::vector<double> al_y_;
+    std::vector<double> at_x_;      // perpendicular axis
+    std::vector<double> at_y_;
+    std::vector<float>  dilLong_;
+    std::vector<float>  dilPerp_;
+    std::vector<float>  jetLong_;
+    std::vector<float>  jetPerp_;
+    std::vector<double> rot_c_;     // cmsReducedMET rotation
+    std::vector<double> rot_s_;
+    std::vector<double> clu_x_;     // cmsReducedMET clustered part, rotated
+    std::vector<double> clu_y_;
+
+    // per flavour and hypothesis, index flavour * nhyp_ + ihyp
+    std::vector<float>  projected_;
+    std::vector<float>  reducedLong_;
+    std::vector<float>  reducedPerp_;
+    std::vector<double> cmsReduced_x_;
+    std::vector<double> cmsReduced_y_;
+};
+
 
 class MetCorrector
 {
@@ -0,0 +1,146 @@
+#include <math.h>
+#include <vector>
+#include "CMS2.h"
+#include "metSignificance.h"
+#include "utilities.h"
+#include "coreProfiler.h"
+#include "jetsmear/JetSmearer.h"
+#include "jetsmear/SigInputObj.h"
+
+void addToMETCovariance(metCovariance& cov, const SigInputObj& obj)
+{
+    double cosphi  = cos(obj.get_phi());
+    double sinphi  = sin(obj.get_phi());
+    double sigma_e2   = obj.get_sigma_e() * obj.get_sigma_e();
+    double sigma_tan2 = obj.get_sigma_tan() * obj.get_sigma_tan();
+    cov.xx += sigma_e2 * cosphi * cosphi + sigma_tan2 * sinphi * sinphi;
+    cov.xy += cosphi * sinphi * (sigma_e2 - sigma_tan2);
+    cov.yy += sigma_e2 * sinphi * sinphi + sigma_tan2 * cosphi * cosphi;
+}
+
+//
+// per-event cache: covariance terms of every PF candidate, of the
+// constituents of each pfjet, and the jet resolutions evaluated so far
+//
+namespace {
+
+    struct JetResolutionEntry {
+        int ijet;
+        float scale;
+        metCovariance cov;
+    };
+
+    struct METSigCache {
+        METSigCache() : jetSmearer(0) {}
+        EventTag tag;
+        JetSmearer* jetSmearer;
+        metCovariance allCands;
+        std::vector<metCovariance> cands;
+        std::vector<metCovariance> jetConstituents;
+        std::vector<bool> jetConstituentsDone;
+        std::vector<JetResolutionEntry> jets;
+    };
+
+    METSigCache& metSigCache(JetSmearer* jetSmearer)
+    {
+        static METSigCache cache;
+        bool cached = !isNewEvent(cache.tag) && cache.jetSmearer == jetSmearer;
+        CORE_PROFILE_CACHE("metSigCache", cached);
+        if (cached)
+            return cache;
+
+        cache.jetSmearer = jetSmearer;
+        cache.allCands = metCovariance();
+        cache.jets.clear();
+        cache.jetConstituents.assign(cms2.pfjets_p4().size(), metCovariance());
+        cache.jetConstituentsDone.assign(cms2.pfjets_p4().size(), false);
+
+        const std::vector<LorentzVector> &p4s = cms2.pfcands_p4();
+        cache.cands.assign(p4s.size(), metCovariance());
+        for (unsigned int ipf = 0; ipf < p4s.size(); ipf++) {
+            int itrk = cms2.pfcands_trkidx().at(ipf);
+            if (cms2.pfcands_charge().at(ipf) != 0 && itrk >= 0 && itrk < (int)cms2.trks_trk_p4().size()) {
+                double pt = p4s[ipf].pt();
+                SigInputObj obj;
+                obj.set("track", pt, p4s[ipf].phi(), cms2.trks_ptErr().at(itrk), pt * cms2.trks_phiErr().at(itrk));
+                addToMETCovariance(cache.cands[ipf], obj);
+            }
+            else
+                addToMETCovariance(cache.cands[ipf], jetSmearer->evalPFCandidate(p4s[ipf], cms2.pfcands_particleId().at(ipf)));
+            cache.allCands.xx += cache.cands[ipf].xx;
+            cache.allCands.xy += cache.cands[ipf].xy;
+            cache.allCands.yy += cache.cands[ipf].yy;
+        }
+        return cache;
+    }
+
+    const metCovariance& jetConstituentCovariance(METSigCache& cache, int ijet)
+    {
+        if (!cache.jetConstituentsDone.at(ijet)) {
+            const std::vector<int> &cands = cms2.pfjets_pfcandIndicies().at(ijet);
+            metCovariance &cov = cache.jetConstituents[ijet];
+            for (unsigned int i = 0; i < cands.size(); i++) {
+                const metCovariance &c = cache.cands.at(cands[i]);
+                cov.xx += c.xx;
+                cov.xy += c.xy;
+                cov.yy += c.yy;
+            }
+            cache.jetConstituentsDone[ijet] = true;
+        }
+        return cache.jetConstituents[ijet];
+    }
+
+    const metCovariance& jetResolutionCovariance(METSigCache& cache, int ijet, float scale)
+    {
+        for (unsigned int i = 0; i < cache.jets.size(); i++) {
+            if (cache.jets[i].ijet == ijet && cache.jets[i].scale == scale)
+                return cache.jets[i].cov;
+        }
+        JetResolutionEntry entry;
+        entry.ijet  = ijet;
+        entry.scale = scale;
+        addToMETCovariance(entry.cov, cache.jetSmearer->evalPFJet(cms2.pfjets_p4().at(ijet) * scale));
+        cache.jets.push_back(entry);
+        return cache.jets.back().cov;
+    }
+}
+
+metCovariance getMETCovariance(JetSmearer* jetSmearer, const std::vector<int>& ijets, const std::vector<float>& scales)
+{
+    metCovariance cov;
+    if (jetSmearer == 0)
+        return cov;
+
+    METSigCache &cache = metSigCache(jetSmearer);
+    cov = cache.allCands;
+
+    std::vector<bool> used(cms2.pfjets_p4().size(), false);
+    for (unsigned int i = 0; i < ijets.size(); i++) {
+        int ijet = ijets[i];
+        if (used.at(ijet))
+            continue;
+        used[ijet] = true;
+
+        // the jet replaces its constituents
+        const metCovariance &constituents = jetConstituentCovariance(cache, ijet);
+        const metCovariance &jet = jetResolutionCovariance(cache, ijet, scales.empty() ? 1.f : scales.at(i));
+        cov.xx += jet.xx - constituents.xx;
+        cov.xy += jet.xy - constituents.xy;
+        cov.yy += jet.yy - constituents.yy;
+    }
+
+    return cov;
+}
+
+double getMETSignificance(float metx, float mety, const metCovariance& cov)
+{
+    double det = cov.xx * cov.yy - cov.xy * cov.xy;
+    if (det <= 0.)
+        return -1.;
+    return (cov.yy * metx * metx - 2. * cov.xy * metx * mety + cov.xx * mety * mety) / det;
+}
+
+double getMETSignificance(float metx, float mety, JetSmearer* jetSmearer, const std::vector<int>& ijets, const std::vector<float>& scales)
+{
+    return getMETSignificance(metx, mety, getMETCovariance(jetSmearer, ijets, scales));
+}
@@ -0,0 +1,46 @@
+#ifndef METSIGNIFICANCE_H
+#define METSIGNIFICANCE_H
+
+#include "CMS2.h"
+#include <vector>
+
+class JetSmearer;
+class SigInputObj;
+
+//---------------------------------------------------------
+// 2x2 MET covariance (GeV^2)
+//---------------------------------------------------------
+struct metCovariance {
+    metCovariance() : xx(0.), xy(0.), yy(0.) {}
+    double xx;
+    double xy;
+    double yy;
+};
+
+//---------------------------------------------------------
+// add the resolution of one object to the covariance
+//---------------------------------------------------------
+void addToMETCovariance(metCovariance& cov, const SigInputObj& obj);
+
+//---------------------------------------------------------
+// MET covariance of an event from the pfjets ijets, with
+// p4 = pfjets_p4 * scales (scales empty: uncorrected), and
+// from all PF candidates that are not constituents of
+// those jets (this includes the leptons). Jets use the
+// JetSmearer jet resolutions, candidates with a track the
+// track errors, other candidates the JetSmearer PF
+// resolutions. Candidate terms and jet resolutions are
+// cached per event, so calling this for every systematic
+// variation only evaluates the jets that changed.
+//---------------------------------------------------------
+metCovariance getMETCovariance(JetSmearer* jetSmearer, const std::vector<int>& ijets,
+                               const std::vector<float>& scales = std::vector<float>());
+
+//---------------------------------------------------------
+// MET significance, met^T V^-1 met; -1 if V is singular
+//---------------------------------------------------------
+double getMETSignificance(float metx, float mety, const metCovariance& cov);
+double getMETSignificance(float metx, float mety, JetSmearer* jetSmearer, const std::vector<int>& ijets,
+                          const std::vector<float>& scales = std::vector<float>());
+
+#endif
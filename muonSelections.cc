@@ -1,5 +1,6 @@
 // Header
 #include "muonSelections.h"
+#include "coreProfiler.h"
 #include "eventSelections.h"
 
 // C++ includes
@@ -21,6 +22,7 @@ using namespace std;
 ////////////////////
 
 bool muonId(unsigned int index, SelectionType type){
+    CORE_PROFILE_SCOPE("muonId");
 
     float isovalue;
     bool  truncated = true;
@@ -623,6 +625,7 @@ bool muonIdNotIsolated(unsigned int index, SelectionType type) {
 ////////////////////////////
 
 double muonIsoValue(unsigned int index, bool truncated ){
+    CORE_PROFILE_SCOPE("muonIsoValue");
     return ( muonIsoValue_TRK( index, truncated ) + muonIsoValue_ECAL( index, truncated ) + muonIsoValue_HCAL( index, truncated ) );
 }
 double muonIsoValue_FastJet(unsigned int index, bool truncated ){
@@ -659,6 +662,7 @@ double muonCorIsoValue (unsigned int index, bool truncated) {
 
 #ifdef PFISOFROMNTUPLE
 double muonIsoValuePF( unsigned int imu, unsigned int ivtx, float coner, float minptn, float dzcut, int filterId){
+    CORE_PROFILE_SCOPE("muonIsoValuePF");
     if (fabs(coner-0.3)<0.0001) {
         if (cms2.mus_iso03_pf().at(imu)<-99.) return 9999.;
         return cms2.mus_iso03_pf().at(imu)/cms2.mus_p4().at(imu).pt();
@@ -672,6 +676,7 @@ double muonIsoValuePF( unsigned int imu, unsigned int ivtx, float coner, float m
 }
 #else
 double muonIsoValuePF( unsigned int imu, unsigned int ivtx, float coner, float minptn, float dzcut, int filterId){
+    CORE_PROFILE_SCOPE("muonIsoValuePF");
     float pfciso = 0;
     float pfniso = 0;
     int mutkid = cms2.mus_trkidx().at(imu);
@@ -844,13 +849,22 @@ bool isPFMuon( int index , bool requireSamePt , float dpt_max ){
 
 }
 
-void muonIsoValuePF2012 (float &pfiso_ch, float &pfiso_em, float &pfiso_nh, const float R, const unsigned int imu, const int ivtx, float neutral_et_threshold)
+// Sums the PF isolation of muon imu in ncones cones from a single pass
+// over the PF candidates. The inner-cone vetoes apply to the cones
+// flagged in vetoes, or to all cones if no flags are given.
+static void muonIsoValuePF2012_cones(float *pfiso_ch, float *pfiso_em, float *pfiso_nh, const float *R, const float *neutral_et_threshold, const std::vector<bool> *vetoes,
+                                     const unsigned int ncones, const unsigned int imu, const int ivtx)
 {
+    CORE_PROFILE_SCOPE("muonIsoValuePF2012");
 
     // isolation sums
-    pfiso_ch = 0.0;
-    pfiso_em = 0.0; 
-    pfiso_nh = 0.0;
+    float maxR = 0.0;
+    for (unsigned int icone = 0; icone < ncones; ++icone) {
+        pfiso_ch[icone] = 0.0;
+        pfiso_em[icone] = 0.0;
+        pfiso_nh[icone] = 0.0;
+        maxR = std::max(maxR, R[icone]);
+    }
        
     // loop on pfcandidates
     for (unsigned int ipf = 0; ipf < cms2.pfcands_p4().size(); ++ipf) {
@@ -862,27 +876,70 @@ void muonIsoValuePF2012 (float &pfiso_ch, float &pfiso_em, float &pfiso_nh, cons
     
         // deltaR between electron and cadidate
         const float dR = ROOT::Math::VectorUtil::DeltaR(cms2.pfcands_p4()[ipf], cms2.mus_p4()[imu]);
-        if (dR > R)              continue;
+        if (dR > maxR)           continue;
+
+        const bool isCharged = (particleId == 211 || particleId == 321 || particleId == 2212 || particleId == 999211);
+        const bool isNeutral = (particleId == 22 || particleId == 130 || particleId == 111 || particleId == 310 || particleId == 2112);
 
         // charged hadrons closest vertex
         // should be the primary vertex
-        if (particleId == 211 || particleId == 321 || particleId == 2212 || particleId == 999211) {
+        if (isCharged) {
             if (cms2.pfcands_vtxidx().at(ipf) != ivtx) continue;
-            if (dR < 0.0001)
-                continue;
         }
-        if (particleId == 22 || particleId == 130 || particleId == 111 || particleId == 310 || particleId == 2112) {
-            if (cms2.pfcands_p4().at(ipf).pt() < neutral_et_threshold)
+
+        // inner-cone vetoes
+        const bool inVetoCone = (isCharged && dR < 0.0001) || (isNeutral && dR < 0.01);
+        if (inVetoCone && vetoes == 0)
+            continue;
+
+        const float pt = cms2.pfcands_p4()[ipf].pt();
+        for (unsigned int icone = 0; icone < ncones; ++icone) {
+
+            if (dR > R[icone])   continue;
+            if (inVetoCone && (*vetoes)[icone])
                 continue;
-            if (dR < 0.01)
+            if (isNeutral && pt < neutral_et_threshold[icone])
                 continue;
+
+            // add to isolation sum
+            if (isCharged)                 pfiso_ch[icone] += pt;
+            if (particleId == 22)          pfiso_em[icone] += pt;
+            else if (isNeutral)            pfiso_nh[icone] += pt;
         }
+    }
+}
+
+void muonIsoValuePF2012 (float &pfiso_ch, float &pfiso_em, float &pfiso_nh, const float R, const unsigned int imu, const int ivtx, float neutral_et_threshold)
+{
+    muonIsoValuePF2012_cones(&pfiso_ch, &pfiso_em, &pfiso_nh, &R, &neutral_et_threshold, 0, 1, imu, ivtx);
+}
 
-        // add to isolation sum
-        if (particleId == 211 || particleId == 321 || particleId == 2212 || particleId == 999211)      pfiso_ch += cms2.pfcands_p4()[ipf].pt();
-        if (particleId == 22)                                                                          pfiso_em += cms2.pfcands_p4()[ipf].pt();
-        if (particleId == 130 || particleId == 111 || particleId == 310 || particleId == 2112)         pfiso_nh += cms2.pfcands_p4()[ipf].pt();
+void muonIsoValuePF2012 (std::vector<float> &pfiso_ch, std::vector<float> &pfiso_em, std::vector<float> &pfiso_nh, const std::vector<float> &R, const unsigned int imu, const int ivtx, const std::vector<float> &neutral_et_threshold)
+{
+    if (neutral_et_threshold.size() != R.size()) {
+        cout << "muonIsoValuePF2012: need one neutral threshold per cone" << endl;
+        return;
+    }
+    pfiso_ch.resize(R.size());
+    pfiso_em.resize(R.size());
+    pfiso_nh.resize(R.size());
+    if (R.empty())
+        return;
+    muonIsoValuePF2012_cones(&pfiso_ch[0], &pfiso_em[0], &pfiso_nh[0], &R[0], &neutral_et_threshold[0], 0, R.size(), imu, ivtx);
+}
+
+void muonIsoValuePF2012 (std::vector<float> &pfiso_ch, std::vector<float> &pfiso_em, std::vector<float> &pfiso_nh, const std::vector<float> &R, const std::vector<float> &neutral_et_threshold, const std::vector<bool> &vetoes, const unsigned int imu, const int ivtx)
+{
+    if (neutral_et_threshold.size() != R.size() || vetoes.size() != R.size()) {
+        cout << "muonIsoValuePF2012: need one neutral threshold and veto flag per cone" << endl;
+        return;
     }
+    pfiso_ch.resize(R.size());
+    pfiso_em.resize(R.size());
+    pfiso_nh.resize(R.size());
+    if (R.empty())
+        return;
+    muonIsoValuePF2012_cones(&pfiso_ch[0], &pfiso_em[0], &pfiso_nh[0], &R[0], &neutral_et_threshold[0], &vetoes, R.size(), imu, ivtx);
 }
 
 float muonIsoValuePF2012_FastJetEffArea(int index, float conesize, float effective_area, int ivtx)
@@ -1,6 +1,8 @@
 #ifndef MUON_SELECTIONS_H
 #define MUON_SELECTIONS_H
 
+#include <vector>
+
 ///////////////
 // Selectors //
 ///////////////
@@ -107,6 +109,10 @@ double mu_fastjet_rel_offset ( unsigned int , bool = true );
 
 double muonIsoValuePF        ( unsigned int imu, unsigned int ivtx, float coner=0.4, float minptn=1.0, float dzcut=0.1, int filterId = 0);
 void muonIsoValuePF2012  (float &pfiso_ch, float &pfiso_em, float &pfiso_nh, const float R, const unsigned int imu, const int ivtx, float neutral_et_threshold = 0.5);
+// several cone sizes (and neutral thresholds) from a single pass over the PF candidates
+void muonIsoValuePF2012  (std::vector<float> &pfiso_ch, std::vector<float> &pfiso_em, std::vector<float> &pfiso_nh, const std::vector<float> &R, const unsigned int imu, const int ivtx, const std::vector<float> &neutral_et_threshold);
+// and with each cone's own inner-cone veto flag
+void muonIsoValuePF2012  (std::vector<float> &pfiso_ch, std::vector<float> &pfiso_em, std::vector<float> &pfiso_nh, const std::vector<float> &R, const std::vector<float> &neutral_et_threshold, const std::vector<bool> &vetoes, const unsigned int imu, const int ivtx);
 float muonIsoValuePF2012_FastJetEffArea( int index , float conesize, float effective_area, int ivtx);
 double muonCorIsoValue (unsigned int , bool = true);
 float muonRadialIsolation (unsigned int imu, float &chiso, float &nhiso, float &emiso, float neutral_et_threshold = 1.0, float cone_size = 0.3, bool verbose = false);
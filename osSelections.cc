@@ -381,32 +381,14 @@ std::vector<LorentzVector> os2012::getJets(int idx, FactorizedJetCorrector* jet_
     return final_jets;
 }
 
-// JEC uncertainty applied otf
+// JEC uncertainty applied otf, on top of the ntuple JEC with the residual on data
 std::vector<LorentzVector> os2012::getJets(int idx, JetCorrectionUncertainty *jet_unc, enum JetScaleType scale_type, enum JetType type, float deltaR, float min_pt, float max_eta, float min_lep_pt, bool sort_by_pt)
 {    
-    std::vector<bool> tmp_jet_flags = os2012::getJetFlags(idx, type, deltaR, /*min_pt=*/0.0, max_eta, min_lep_pt);
-
-    // now impose the pt requirement after applying the extra corrections
-    std::vector<LorentzVector> final_jets;
-    for (unsigned int jidx = 0; jidx < tmp_jet_flags.size(); jidx++) {
-
-        if (!tmp_jet_flags.at(jidx))
-            continue;
-
-        const float jet_cor = (cms2.evt_isRealData() ? cms2.pfjets_corL1FastL2L3residual().at(jidx) :  cms2.pfjets_corL1FastL2L3().at(jidx));
-        LorentzVector vjet  = cms2.pfjets_p4().at(jidx) * jet_cor; 
-        jet_unc->setJetPt(vjet.pt());    
-        jet_unc->setJetEta(vjet.eta());  
-        const float jet_cor_unc = jet_unc->getUncertainty(true);     
-        vjet *= (1.0 + jet_cor_unc * scale_type);    
-        if (vjet.pt() < min_pt)
-        {
-            continue;
-        }
-
-        final_jets.push_back(vjet);
-    }
+    const enum JetType jes_type = cms2.evt_isRealData() ? JETS_TYPE_PF_FAST_CORR_RESIDUAL : JETS_TYPE_PF_FAST_CORR;
+    JetVariations tmp_jets;
+    os2012::getJetVariations(tmp_jets, std::vector<JetVariation>(1, JetVariation(JETS_VAR_JES, scale_type)), idx, jes_type, deltaR, min_pt, max_eta, min_lep_pt, jet_unc);
 
+    std::vector<LorentzVector> final_jets = tmp_jets.getJets(0);
     if (sort_by_pt)
         sort(final_jets.begin(), final_jets.end(), SortByPt());
     return final_jets;
@@ -448,6 +430,23 @@ std::vector<LorentzVector> os2012::getJets(int idx, FactorizedJetCorrector* jet_
 }    
      
 
+////////////////////////////////////////////////////////////////////////////////////////////////
+// 2012 jets for several JES/JER variations at once
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+// The lepton overlap removal uses the uncorrected jet direction,
+// which the corrections do not change
+void os2012::getJetVariations(JetVariations& result, const std::vector<JetVariation>& variations, int idx, enum JetType type, float deltaR, float min_pt, float max_eta, float min_lep_pt, JetCorrectionUncertainty *jet_unc, JetSmearer *jet_smearer)
+{
+    ::getJetVariations(result, variations, (unsigned int)idx, type, JETS_CLEAN_HYP_E_MU, (double)deltaR, (double)min_pt, (double)max_eta, jet_unc, jet_smearer);
+
+    // jets within deltaR (inclusive) of a good e/mu
+    JetMask overlaps;
+    addJetOverlaps(overlaps, type, os2012::getGoodElectrons(min_lep_pt), deltaR, /*inclusive=*/true);
+    addJetOverlaps(overlaps, type, os2012::getGoodMuons(min_lep_pt), deltaR, /*inclusive=*/true);
+    result.removeOverlaps(overlaps);
+}
+
 ////////////////////////////////////////////////////////////////////////////////////////////////
 // 2012 get all the jets with corrected energy 
 ////////////////////////////////////////////////////////////////////////////////////////////////
@@ -1364,82 +1363,16 @@ std::vector<float> os2012::getJetBtagDiscriminators(int idx, FactorizedJetCorrec
 ///////////////////////////////////////////////////////////////////////////////////////////
 float os2012::getErrPt(const float pt, const float eta)
 {
-    float InvPerr2;
-    float N = 0.0;
-    float S = 0.0;
-    float C = 0.0;
-    float m = 0.0;
-    if(fabs(eta) < 0.5)
-    {
-        N = 3.96859;
-        S = 0.18348;
-        C = 0.;
-        m = 0.62627;
-    } 
-    else if(fabs(eta) < 1.0)
-    {
-        N = 3.55226;
-        S = 0.24026;
-        C = 0.;
-        m = 0.52571;
-    } 
-    else if(fabs(eta) < 1.5) 
-    {
-        N = 4.54826;
-        S = 0.22652;
-        C = 0.;
-        m = 0.58963;
-    }
-    else if(fabs(eta) < 2.0)
-    {
-        N = 4.62622;
-        S = 0.23664;
-        C = 0.;
-        m = 0.48738;
-    }
-    else if(fabs(eta) < 2.5)
-    {
-        N = 2.53324;
-        S = 0.34306;
-        C = 0.;
-        m = 0.28662;
-    }
-    else if(fabs(eta) < 3.0)
-    {
-        N = -3.33814;
-        S = 0.73360;
-        C = 0.;
-        m = 0.08264;
-    }
-    else if(fabs(eta) < 5.0)
-    {
-        N = 2.95397;
-        S = 0.11619;
-        C = 0.;
-        m = 0.96086;
-    }
-    
-    // this is the absolute resolution (squared), not sigma(pt)/pt
-    // so have to multiply by pt^2, thats why m+1 instead of m-1
-    InvPerr2 = (N * fabs(N) ) + (S * S) * pow(pt, m+1) + (C * C) * pt * pt;
-
-    return sqrt(InvPerr2);
+    return jetResolutionErrPt(pt, eta);
 }
 
-
 ///////////////////////////////////////////////////////////////////////////////////////////
 // function to get the jer scale factors. values taken from the twiki: 
 // https://twiki.cern.ch/twiki/bin/view/CMS/JetResolution
 ///////////////////////////////////////////////////////////////////////////////////////////
 float os2012::getJERScale(const float jet_eta)
 {
-    const float aeta = fabs(jet_eta);
-    if      (aeta < 0.5) {return 1.052;}
-    else if (aeta < 1.1) {return 1.057;}
-    else if (aeta < 1.7) {return 1.096;}
-    else if (aeta < 2.3) {return 1.134;}
-    else                 {return 1.288;}
-
+    return jetResolutionScale(jet_eta);
 }
 
 // rescaled the jet p4s, met, met_phi and ht scaling up the JER
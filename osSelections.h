@@ -104,6 +104,15 @@ namespace os2012
     std::vector<LorentzVector> getJets(int idx, FactorizedJetCorrector* jet_corrector, JetCorrectionUncertainty *jet_unc, enum JetScaleType scale_type,  enum JetType type, float deltaR = 0.4, float min_pt = 30.0, float max_eta = 2.4, float min_lep_pt = 20.0, bool sort_by_pt = true);	 
 
 
+    ///////////////////////////////////////////////////////////////////////////////////////////
+    // 2012 jets for several JES/JER variations at once (see getJetVariations in jetSelections.h),
+    // with the overlap removal with good e/mu with pt > x done once for all variations.
+    // The correction follows type: pass JETS_TYPE_PF_FAST_CORR_RESIDUAL on data, JETS_TYPE_PF_FAST_CORR on MC
+    ///////////////////////////////////////////////////////////////////////////////////////////
+
+    void getJetVariations(JetVariations& result, const std::vector<JetVariation>& variations, int idx, enum JetType type, float deltaR = 0.4, float min_pt = 30.0, float max_eta = 2.4, float min_lep_pt = 20.0, JetCorrectionUncertainty *jet_unc = 0, JetSmearer *jet_smearer = 0);
+
+
     ///////////////////////////////////////////////////////////////////////////////////////////
     // 2012 get all the jets with corrected energy 
     ///////////////////////////////////////////////////////////////////////////////////////////
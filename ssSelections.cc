@@ -25,6 +25,7 @@
 #include "triggerUtils.h"
 #include "eventSelections.h"
 #include "utilities.h"
+#include "coreProfiler.h"
 #include "susySelections.h"
 #include "jetcorr/FactorizedJetCorrector.h"
 #include "jetcorr/JetCorrectionUncertainty.h"
@@ -584,132 +585,124 @@ bool samesign::passesTriggerVeryLowPt(int hyp_type)
 
 
 ///////////////////////////////////////////////////////////////////////////////////////////
-// extra Z veto for b-tagged same sign analysis
+// per-event table of the leptons entering the extra Z and gamma* vetoes
 ///////////////////////////////////////////////////////////////////////////////////////////
-bool samesign::makesExtraZ(int idx, bool apply_id_iso) {
+namespace {
 
-    std::vector<unsigned int> ele_idx;
-    std::vector<unsigned int> mu_idx;
+    // lepton with |eta| < 2.4 and pt > 5 GeV; the veto id/iso is evaluated once per event
+    struct VetoLepton {
+        unsigned int  idx;
+        int           charge;
+        LorentzVector p4;
+        bool          passes_id_iso;
+    };
 
-    int lt_id           = cms2.hyp_lt_id().at(idx);
-    int ll_id           = cms2.hyp_ll_id().at(idx);
-    unsigned int lt_idx = cms2.hyp_lt_index().at(idx);
-    unsigned int ll_idx = cms2.hyp_ll_index().at(idx);
+    struct VetoLeptonTable {
+        EventTag tag;
+        std::vector<VetoLepton> els;
+        std::vector<VetoLepton> mus;
+    };
 
-    (abs(lt_id) == 11) ? ele_idx.push_back(lt_idx) : mu_idx.push_back(lt_idx);
-    (abs(ll_id) == 11) ? ele_idx.push_back(ll_idx) : mu_idx.push_back(ll_idx);
+    const VetoLeptonTable& vetoLeptonTable() {
+        static VetoLeptonTable table;
+        bool cached = !isNewEvent(table.tag);
+        CORE_PROFILE_CACHE("vetoLeptonTable", cached);
+        if (cached)
+            return table;
 
-    if (ele_idx.size() + mu_idx.size() != 2) {
-        std::cout << "ERROR: don't have 2 leptons in hypothesis!!!  Exiting" << std::endl;
-        return false;
-    }
-        
-    if (ele_idx.size() > 0) {
+        table.els.clear();
         for (unsigned int eidx = 0; eidx < cms2.els_p4().size(); eidx++) {
 
-            bool is_hyp_lep = false;
-            for (unsigned int vidx = 0; vidx < ele_idx.size(); vidx++) {
-                if (eidx == ele_idx.at(vidx))
-                    is_hyp_lep = true;                
-            }
-            if (is_hyp_lep)
-                continue;
-
             if (fabs(cms2.els_p4().at(eidx).eta()) > 2.4)
-            {
                 continue;
-            }
 
-            if (cms2.els_p4().at(eidx).pt() < 10.)
-            {
+            if (cms2.els_p4().at(eidx).pt() < 5.0)
                 continue;
-            }
 
+            VetoLepton lep;
+            lep.idx    = eidx;
+            lep.charge = cms2.els_charge().at(eidx);
+            lep.p4     = cms2.els_p4().at(eidx);
 
-            if (apply_id_iso) {
-                float iso_val = samesign::electronIsolationPF2012(eidx);
-                if (iso_val > 0.2)
-                {
-                    continue;
-                }
-                
-                electronIdComponent_t passAllVetoCuts = DETAIN | DPHIIN | SIGMAIETAIETA | HOE | D0VTX | DZVTX;
-                electronIdComponent_t vetoid = electronId_WP2012(eidx, VETO);
-                if ((passAllVetoCuts & vetoid) != passAllVetoCuts)
-                {
-                    continue;
-                }
-            }
+            float iso_val = samesign::electronIsolationPF2012(eidx);
+            electronIdComponent_t passAllVetoCuts = DETAIN | DPHIIN | SIGMAIETAIETA | HOE | D0VTX | DZVTX;
+            lep.passes_id_iso = (!(iso_val > 0.2) &&
+                                 (passAllVetoCuts & electronId_WP2012(eidx, VETO)) == passAllVetoCuts);
+            table.els.push_back(lep);
+        }
 
-            for (unsigned int vidx = 0; vidx < ele_idx.size(); vidx++) {
+        table.mus.clear();
+        for (unsigned int midx = 0; midx < cms2.mus_p4().size(); midx++) {
 
-                if (cms2.els_charge().at(eidx) * cms2.els_charge().at(ele_idx.at(vidx)) > 0)
-                {
-                    continue;
-                }
+            if (fabs(cms2.mus_p4().at(midx).eta()) > 2.4)
+                continue;
 
-                LorentzVector zp4 = cms2.els_p4().at(eidx) + cms2.els_p4().at(ele_idx.at(vidx));
-                float zcandmass = sqrt(fabs(zp4.mass2()));
-                if (fabs(zcandmass-91.) < 15.)
-                {
-                    return true;
-                }
-            }
-        }        
+            if (cms2.mus_p4().at(midx).pt() < 5.0)
+                continue;
+
+            VetoLepton lep;
+            lep.idx    = midx;
+            lep.charge = cms2.mus_charge().at(midx);
+            lep.p4     = cms2.mus_p4().at(midx);
+
+            bool is_global  = ((cms2.mus_type().at(midx) & (1<<1)) == (1<<1));
+            bool is_tracker = ((cms2.mus_type().at(midx) & (1<<2)) == (1<<2));
+            float iso_val = muonIsoValuePF2012_deltaBeta(midx);
+            lep.passes_id_iso = (!(iso_val > 0.2) &&
+                                 cms2.mus_pid_PFMuon().at(midx) &&
+                                 (is_global || is_tracker));
+            table.mus.push_back(lep);
+        }
+
+        return table;
     }
 
-    if (mu_idx.size() > 0) {
-        for (unsigned int midx = 0; midx < cms2.mus_p4().size(); midx++) {
+    enum VetoMassWindow { Z_WINDOW, GAMMASTAR_WINDOW };
 
-            bool is_hyp_lep = false;
-            for (unsigned int vidx = 0; vidx < mu_idx.size(); vidx++) {
-                if (midx == mu_idx.at(vidx))
-                    is_hyp_lep = true;                
-            }
-            if (is_hyp_lep)
+    // does any table lepton (not in the hypothesis) make an opposite
+    // charge pair in the mass window with one of the hypothesis leptons
+    bool makesVetoPair(const std::vector<VetoLepton> &leps, const std::vector<unsigned int> &hyp_indices,
+                       const std::vector<LorentzVector> &hyp_p4s, const std::vector<int> &hyp_charges,
+                       float min_pt, bool apply_id_iso, VetoMassWindow window)
+    {
+        if (hyp_indices.empty())
+            return false;
+
+        for (unsigned int lidx = 0; lidx < leps.size(); lidx++) {
+            const VetoLepton &lep = leps[lidx];
+
+            if (std::find(hyp_indices.begin(), hyp_indices.end(), lep.idx) != hyp_indices.end())
                 continue;
 
-            if (fabs(cms2.mus_p4().at(midx).eta()) > 2.4)
+            if (lep.p4.pt() < min_pt)
                 continue;
 
-            if (cms2.mus_p4().at(midx).pt() < 10.)
+            if (apply_id_iso && !lep.passes_id_iso)
                 continue;
 
-            if (apply_id_iso) {
-                float iso_val = muonIsoValuePF2012_deltaBeta(midx);
-                if (iso_val > 0.2)
-                    continue;
-                
-                if (!cms2.mus_pid_PFMuon().at(midx))
-                    continue;
+            for (unsigned int vidx = 0; vidx < hyp_indices.size(); vidx++) {
 
-                bool is_global  = ((cms2.mus_type().at(midx) & (1<<1)) == (1<<1));
-                bool is_tracker = ((cms2.mus_type().at(midx) & (1<<2)) == (1<<2));
-                if (!is_global && !is_tracker)
+                if (lep.charge * hyp_charges.at(hyp_indices.at(vidx)) > 0)
                     continue;
-            }
 
-            for (unsigned int vidx = 0; vidx < mu_idx.size(); vidx++) {
-
-                if (cms2.mus_charge().at(midx) * cms2.mus_charge().at(mu_idx.at(vidx)) > 0)
-                    continue;
-
-                LorentzVector zp4 = cms2.mus_p4().at(midx) + cms2.mus_p4().at(mu_idx.at(vidx));
-                float zcandmass = sqrt(fabs(zp4.mass2()));
-                if (fabs(zcandmass-91.) < 15.)
+                LorentzVector pair_p4 = lep.p4 + hyp_p4s.at(hyp_indices.at(vidx));
+                float pair_mass = sqrt(fabs(pair_p4.mass2()));
+                if (window == Z_WINDOW && fabs(pair_mass-91.) < 15.)
+                    return true;
+                if (window == GAMMASTAR_WINDOW && pair_mass < 12.0)
                     return true;
             }
         }
-    }
 
-    return false;
-}
+        return false;
+    }
 
+} // anonymous namespace
 
 ///////////////////////////////////////////////////////////////////////////////////////////
-// Gamma* veto for b-tagged same sign analysis
+// extra Z veto for b-tagged same sign analysis
 ///////////////////////////////////////////////////////////////////////////////////////////
-bool samesign::makesExtraGammaStar(int idx, bool apply_id_iso) {
+bool samesign::makesExtraZ(int idx, bool apply_id_iso) {
 
     std::vector<unsigned int> ele_idx;
     std::vector<unsigned int> mu_idx;
@@ -726,106 +719,43 @@ bool samesign::makesExtraGammaStar(int idx, bool apply_id_iso) {
         std::cout << "ERROR: don't have 2 leptons in hypothesis!!!  Exiting" << std::endl;
         return false;
     }
-        
-    if (ele_idx.size() > 0) {
-        for (unsigned int eidx = 0; eidx < cms2.els_p4().size(); eidx++) {
 
-            bool is_hyp_lep = false;
-            for (unsigned int vidx = 0; vidx < ele_idx.size(); vidx++) {
-                if (eidx == ele_idx.at(vidx))
-                    is_hyp_lep = true;                
-            }
-            if (is_hyp_lep)
-                continue;
+    const VetoLeptonTable &table = vetoLeptonTable();
+    if (makesVetoPair(table.els, ele_idx, cms2.els_p4(), cms2.els_charge(), 10., apply_id_iso, Z_WINDOW))
+        return true;
+    if (makesVetoPair(table.mus, mu_idx, cms2.mus_p4(), cms2.mus_charge(), 10., apply_id_iso, Z_WINDOW))
+        return true;
 
-            if (fabs(cms2.els_p4().at(eidx).eta()) > 2.4)
-            {
-                continue;
-            }
+    return false;
+}
 
-            if (cms2.els_p4().at(eidx).pt() < 5.0)
-            {
-                continue;
-            }
 
+///////////////////////////////////////////////////////////////////////////////////////////
+// Gamma* veto for b-tagged same sign analysis
+///////////////////////////////////////////////////////////////////////////////////////////
+bool samesign::makesExtraGammaStar(int idx, bool apply_id_iso) {
 
-            if (apply_id_iso) {
-                float iso_val = samesign::electronIsolationPF2012(eidx);
-                if (iso_val > 0.2)
-                {
-                    continue;
-                }
-                
-                electronIdComponent_t passAllVetoCuts = DETAIN | DPHIIN | SIGMAIETAIETA | HOE | D0VTX | DZVTX;
-                electronIdComponent_t vetoid = electronId_WP2012(eidx, VETO);
-                if ((passAllVetoCuts & vetoid) != passAllVetoCuts)
-                {
-                    continue;
-                }
-            }
+    std::vector<unsigned int> ele_idx;
+    std::vector<unsigned int> mu_idx;
 
-            for (unsigned int vidx = 0; vidx < ele_idx.size(); vidx++) {
+    int lt_id           = cms2.hyp_lt_id().at(idx);
+    int ll_id           = cms2.hyp_ll_id().at(idx);
+    unsigned int lt_idx = cms2.hyp_lt_index().at(idx);
+    unsigned int ll_idx = cms2.hyp_ll_index().at(idx);
 
-                if (cms2.els_charge().at(eidx) * cms2.els_charge().at(ele_idx.at(vidx)) > 0)
-                {
-                    continue;
-                }
+    (abs(lt_id) == 11) ? ele_idx.push_back(lt_idx) : mu_idx.push_back(lt_idx);
+    (abs(ll_id) == 11) ? ele_idx.push_back(ll_idx) : mu_idx.push_back(ll_idx);
 
-                LorentzVector gamma_p4 = cms2.els_p4().at(eidx) + cms2.els_p4().at(ele_idx.at(vidx));
-                float gammacandmass = sqrt(fabs(gamma_p4.mass2()));
-                if (gammacandmass < 12.0)
-                {
-                    return true;
-                }
-            }
-        }        
+    if (ele_idx.size() + mu_idx.size() != 2) {
+        std::cout << "ERROR: don't have 2 leptons in hypothesis!!!  Exiting" << std::endl;
+        return false;
     }
 
-    if (mu_idx.size() > 0) {
-        for (unsigned int midx = 0; midx < cms2.mus_p4().size(); midx++) {
-
-            bool is_hyp_lep = false;
-            for (unsigned int vidx = 0; vidx < mu_idx.size(); vidx++) {
-                if (midx == mu_idx.at(vidx))
-                    is_hyp_lep = true;                
-            }
-            if (is_hyp_lep)
-                continue;
-
-            if (fabs(cms2.mus_p4().at(midx).eta()) > 2.4)
-                continue;
-
-            if (cms2.mus_p4().at(midx).pt() < 5.0)
-                continue;
-
-            if (apply_id_iso) {
-                float iso_val = muonIsoValuePF2012_deltaBeta(midx);
-                if (iso_val > 0.2)
-                    continue;
-                
-                if (!cms2.mus_pid_PFMuon().at(midx))
-                    continue;
-
-                bool is_global  = ((cms2.mus_type().at(midx) & (1<<1)) == (1<<1));
-                bool is_tracker = ((cms2.mus_type().at(midx) & (1<<2)) == (1<<2));
-                if (!is_global && !is_tracker)
-                    continue;
-            }
-
-            for (unsigned int vidx = 0; vidx < mu_idx.size(); vidx++) {
-
-                if (cms2.mus_charge().at(midx) * cms2.mus_charge().at(mu_idx.at(vidx)) > 0)
-                    continue;
-
-                LorentzVector gamma_p4 = cms2.mus_p4().at(midx) + cms2.mus_p4().at(mu_idx.at(vidx));
-                float gammacandmass = sqrt(fabs(gamma_p4.mass2()));
-                if (gammacandmass < 12.0)
-                {
-                    return true;
-                }
-            }
-        }
-    }
+    const VetoLeptonTable &table = vetoLeptonTable();
+    if (makesVetoPair(table.els, ele_idx, cms2.els_p4(), cms2.els_charge(), 5.0, apply_id_iso, GAMMASTAR_WINDOW))
+        return true;
+    if (makesVetoPair(table.mus, mu_idx, cms2.mus_p4(), cms2.mus_charge(), 5.0, apply_id_iso, GAMMASTAR_WINDOW))
+        return true;
 
     return false;
 }
@@ -934,6 +864,50 @@ bool passes3rdLeptonSelection(const int lep_id, const int lep_idx, const float m
     return true;
 }
 
+// per-event table of the hypothesis independent parts of passes3rdLeptonSelection
+namespace {
+
+    struct ThirdLeptonTable {
+        EventTag tag;
+        std::vector<bool> els_pass;                              // passes3rdElectronSelectionNoOverlapRemoval without the pt cut
+        std::vector<std::vector<unsigned int> > els_overlap_mus; // 3rd selection muons (pt > 10) within dR 0.1 of the electron
+        std::vector<bool> mus_pass;                              // passes3rdMuonSelection without the pt cut
+    };
+
+    const ThirdLeptonTable& thirdLeptonTable() {
+        using namespace tas;
+
+        static ThirdLeptonTable table;
+        bool cached = !isNewEvent(table.tag);
+        CORE_PROFILE_CACHE("thirdLeptonTable", cached);
+        if (cached)
+            return table;
+
+        // a negative min_lep_pt disables the pt cut
+        table.mus_pass.resize(mus_p4().size());
+        for (size_t midx = 0; midx != mus_p4().size(); midx++)
+            table.mus_pass[midx] = passes3rdMuonSelection(midx, /*min_pt=*/-1.);
+
+        table.els_pass.resize(els_p4().size());
+        table.els_overlap_mus.resize(els_p4().size());
+        for (size_t eidx = 0; eidx != els_p4().size(); eidx++)
+        {
+            table.els_pass[eidx] = passes3rdElectronSelectionNoOverlapRemoval(eidx, /*min_pt=*/-1., /*use_el_eta=*/false);
+            table.els_overlap_mus[eidx].clear();
+            if (not table.els_pass[eidx]) {continue;}
+
+            for (size_t midx = 0; midx != mus_p4().size(); midx++)
+            {
+                if (not table.mus_pass[midx] || fabs(mus_p4().at(midx).pt()) < 10.0) {continue;}
+                if (DeltaR(els_p4().at(eidx), mus_p4().at(midx)) < 0.1)             {table.els_overlap_mus[eidx].push_back(midx);}
+            }
+        }
+
+        return table;
+    }
+
+} // anonymous namespace
+
 // additional selected leptons 
 std::vector<std::pair<int, int> > samesign::additionalLeptons(const int hyp_idx, const float min_lep_pt)
 {
@@ -957,17 +931,28 @@ std::vector<std::pair<int, int> > samesign::additionalLeptons(const int hyp_idx,
     // selected leptons 
     std::vector<std::pair<int, int> > selected_leps;
 
+    // same as passes3rdLeptonSelection, using the per-event table
+    const ThirdLeptonTable& table = thirdLeptonTable();
+
     // loop over electrons
     for (size_t eidx = 0; eidx != els_p4().size(); eidx++)
     {
         // skip hyp electrons
         if (std::find(el_indices.begin(), el_indices.end(), eidx) != el_indices.end()) {continue;}
 
-        // return true if this electron passes the 3rd lepton selection
-        if (passes3rdLeptonSelection(11, eidx, min_lep_pt, mu_indices))
+        if (not table.els_pass[eidx])                        {continue;}
+        if (fabs(els_p4().at(eidx).pt()) < min_lep_pt)       {continue;}
+
+        // overlap with a selection muon that is not in the hypothesis
+        bool overlaps = false;
+        const std::vector<unsigned int>& overlap_mus = table.els_overlap_mus[eidx];
+        for (size_t oidx = 0; oidx != overlap_mus.size(); oidx++)
         {
-            selected_leps.push_back(std::make_pair(-11 * els_charge().at(eidx), eidx));
+            if (std::find(mu_indices.begin(), mu_indices.end(), overlap_mus[oidx]) == mu_indices.end()) {overlaps = true;}
         }
+        if (overlaps) {continue;}
+
+        selected_leps.push_back(std::make_pair(-11 * els_charge().at(eidx), eidx));
     }
         
     // loop over muons
@@ -976,11 +961,10 @@ std::vector<std::pair<int, int> > samesign::additionalLeptons(const int hyp_idx,
         // skip hyp muons
         if (std::find(mu_indices.begin(), mu_indices.end(), midx) != mu_indices.end()) {continue;}
 
-        // return true if this muons passes the 3rd lepton selection
-        if (passes3rdLeptonSelection(13, midx, min_lep_pt, mu_indices))
-        {
-            selected_leps.push_back(std::make_pair(-13 * mus_charge().at(midx), midx));
-        }
+        if (not table.mus_pass[midx])                        {continue;}
+        if (fabs(mus_p4().at(midx).pt()) < min_lep_pt)       {continue;}
+
+        selected_leps.push_back(std::make_pair(-13 * mus_charge().at(midx), midx));
     }
 
     // sort by pt
@@ -1011,56 +995,82 @@ bool samesign::has3rdLepton(const int idx, const float min_lep_pt)
 }
 
 
-////////////////////////////////////////////////////////////////////////////////////////////////
-// 2012 get jets and perform overlap removal with numerator e/mu with pt > x (defaults are 20/20 GeV)
-////////////////////////////////////////////////////////////////////////////////////////////////
-    
-// JEC taken from ntuple
-std::vector<LorentzVector> samesign::getJets(int idx, enum JetType type, float deltaR, float min_pt, float max_eta, float mu_minpt, float ele_minpt, float rescale, int systFlag, bool sort_by_pt) {
-
-    std::vector<LorentzVector> tmp_jets = getJets(idx, /*sort=*/sort_by_pt, type, JETS_CLEAN_HYP_E_MU, deltaR, 0.0, max_eta, (double) rescale, systFlag);
-
-    // ok, now perform the rest of the lepton overlap removal
-    // and the impose the pt requirement after applying the
-    // extra corrections
-    std::vector<LorentzVector> final_jets;
-    for (unsigned int jidx = 0; jidx < tmp_jets.size(); jidx++) {
-
-        bool jetIsLep = false;
+///////////////////////////////////////////////////////////////////////////////////////////
+// jets within deltaR of a numerator e/mu (2012 or 2011), from the per-lepton masks of jetLeptonOverlapMask
+///////////////////////////////////////////////////////////////////////////////////////////
+namespace {
 
-        LorentzVector vjet = tmp_jets.at(jidx);
-        if (vjet.pt() < min_pt)
-            continue;
+    // or the jets within deltaR (inclusive) of the lepton into overlaps
+    void addJetOverlaps(JetMask& overlaps, enum JetType type, int id, unsigned int idx, double deltaR) {
+        ::addJetOverlaps(overlaps, jetLeptonOverlapMask(type, id, idx, deltaR, /*inclusive=*/true));
+    }
 
+    // jets of type overlapping with a numerator e/mu above the pt thresholds;
+    // the masks use the uncorrected jet direction
+    JetMask numeratorJetOverlaps(enum JetType type, float deltaR, float mu_minpt, float ele_minpt) {
+        JetMask overlaps;
         for (unsigned int eidx = 0; eidx < cms2.els_p4().size(); eidx++) {
             if (cms2.els_p4().at(eidx).pt() < ele_minpt)
                 continue;
             if (!samesign::isNumeratorLepton(11, eidx))
                 continue;
-
-            if (ROOT::Math::VectorUtil::DeltaR(vjet, cms2.els_p4().at(eidx)) > deltaR)
+            addJetOverlaps(overlaps, type, 11, eidx, deltaR);
+        }
+        for (unsigned int midx = 0; midx < cms2.mus_p4().size(); midx++) {
+            if (cms2.mus_p4().at(midx).pt() < mu_minpt)
                 continue;
-
-            jetIsLep = true;
-            break;
+            if (!samesign::isNumeratorLepton(13, midx))
+                continue;
+            addJetOverlaps(overlaps, type, 13, midx, deltaR);
         }
+        return overlaps;
+    }
 
-        if (jetIsLep) continue;
-
+    // the same for the 2011 numerator definition
+    JetMask numeratorJetOverlaps(enum JetType type, double deltaR, double mu_minpt, double ele_minpt, enum samesign2011::IsolationType iso_type) {
+        JetMask overlaps;
+        for (unsigned int eidx = 0; eidx < cms2.els_p4().size(); eidx++) {
+            if (cms2.els_p4().at(eidx).pt() < ele_minpt)
+                continue;
+            if (!samesign2011::isNumeratorLepton(11, eidx, iso_type))
+                continue;
+            addJetOverlaps(overlaps, type, 11, eidx, deltaR);
+        }
         for (unsigned int midx = 0; midx < cms2.mus_p4().size(); midx++) {
             if (cms2.mus_p4().at(midx).pt() < mu_minpt)
                 continue;
-            if (!samesign::isNumeratorLepton(13, midx))
+            if (!samesign2011::isNumeratorLepton(13, midx, iso_type))
                 continue;
+            addJetOverlaps(overlaps, type, 13, midx, deltaR);
+        }
+        return overlaps;
+    }
+}
 
-            if (ROOT::Math::VectorUtil::DeltaR(vjet, cms2.mus_p4().at(midx)) > deltaR)
-                continue;                
 
-            jetIsLep = true;
-            break;
-        }            
+////////////////////////////////////////////////////////////////////////////////////////////////
+// 2012 get jets and perform overlap removal with numerator e/mu with pt > x (defaults are 20/20 GeV)
+////////////////////////////////////////////////////////////////////////////////////////////////
+    
+// JEC taken from ntuple
+std::vector<LorentzVector> samesign::getJets(int idx, enum JetType type, float deltaR, float min_pt, float max_eta, float mu_minpt, float ele_minpt, float rescale, int systFlag, bool sort_by_pt) {
 
-        if (jetIsLep) continue;
+    SelectedJets tmp_jets;
+    selectJets(tmp_jets, idx, type, JETS_CLEAN_HYP_E_MU, deltaR, 0.0, max_eta, (double) rescale, systFlag);
+    const JetMask overlaps = numeratorJetOverlaps(type, deltaR, mu_minpt, ele_minpt);
+
+    // ok, now perform the rest of the lepton overlap removal
+    // and the impose the pt requirement after applying the
+    // extra corrections
+    std::vector<LorentzVector> final_jets;
+    for (unsigned int jidx = 0; jidx < tmp_jets.size(); jidx++) {
+
+        LorentzVector vjet = tmp_jets.p4(jidx);
+        if (vjet.pt() < min_pt)
+            continue;
+
+        if (jetOverlaps(overlaps, tmp_jets.index(jidx)))
+            continue;
 
         final_jets.push_back(vjet);
     }
@@ -1279,6 +1289,7 @@ std::vector<LorentzVector> samesign::getAllCorrectedJets(enum JetType type, Fact
 std::vector<bool> samesign::getJetFlags(int idx, enum JetType type, float deltaR, float min_pt, float max_eta, float mu_minpt, float ele_minpt, float rescale, int systFlag)
 {
     std::vector<bool> tmp_jet_flags = getJetFlags((unsigned int)idx, type, JETS_CLEAN_HYP_E_MU, (double)deltaR, 0.0, (double)max_eta, (double)rescale, systFlag);
+    const JetMask overlaps = numeratorJetOverlaps(type, deltaR, mu_minpt, ele_minpt);
 
     // ok, now perform the rest of the lepton overlap removal
     // and the impose the pt requirement after applying the
@@ -1302,43 +1313,10 @@ std::vector<bool> samesign::getJetFlags(int idx, enum JetType type, float deltaR
             continue;
         }
 
-        bool jetIsLep = false;
-
-        for (unsigned int eidx = 0; eidx < cms2.els_p4().size(); eidx++) {
-            if (cms2.els_p4().at(eidx).pt() < ele_minpt)
-                continue;
-            if (!samesign::isNumeratorLepton(11, eidx))
-                continue;
-
-            if (ROOT::Math::VectorUtil::DeltaR(vjet, cms2.els_p4().at(eidx)) > deltaR)
-                continue;
-
-            jetIsLep = true;
-            break;
-        }
-
-        if (jetIsLep) {
+        if (jetOverlaps(overlaps, jidx)) {
             final_jets.push_back(false);
             continue;
         }
-
-        for (unsigned int midx = 0; midx < cms2.mus_p4().size(); midx++) {
-            if (cms2.mus_p4().at(midx).pt() < mu_minpt)
-                continue;
-            if (!samesign::isNumeratorLepton(13, midx))
-                continue;
-
-            if (ROOT::Math::VectorUtil::DeltaR(vjet, cms2.mus_p4().at(midx)) > deltaR)
-                continue;                
-
-            jetIsLep = true;
-            break;
-        }            
-
-        if (jetIsLep) {
-            final_jets.push_back(false);
-            continue;   
-        }
         final_jets.push_back(true);
     }
 
@@ -1455,6 +1433,20 @@ std::vector<bool> samesign::getJetFlags(int idx, FactorizedJetCorrector* jet_cor
 }
 
 
+///////////////////////////////////////////////////////////////////////////////////////////
+// 2012 jets for several JES/JER variations at once
+///////////////////////////////////////////////////////////////////////////////////////////
+
+// The lepton overlap removal uses the uncorrected jet direction,
+// which the corrections do not change
+void samesign::getJetVariations(JetVariations& result, const std::vector<JetVariation>& variations, int idx, enum JetType type, float deltaR, float min_pt, float max_eta, float mu_minpt, float ele_minpt, JetCorrectionUncertainty *jet_unc, JetSmearer *jet_smearer)
+{
+    ::getJetVariations(result, variations, (unsigned int)idx, type, JETS_CLEAN_HYP_E_MU, (double)deltaR, (double)min_pt, (double)max_eta, jet_unc, jet_smearer);
+
+    // jets within deltaR of a numerator lepton
+    result.removeOverlaps(numeratorJetOverlaps(type, deltaR, mu_minpt, ele_minpt));
+}
+
 ///////////////////////////////////////////////////////////////////////////////////////////
 // 2012 get sumpt, skip jets overlapping with numerator e/mu with pt>x (defaults are 20/20 GeV)
 ///////////////////////////////////////////////////////////////////////////////////////////
@@ -1556,7 +1548,10 @@ int samesign::nJets(int idx, FactorizedJetCorrector* jet_corrector, JetCorrectio
 // JEC taken from ntuple
 std::vector<LorentzVector> samesign::getBtaggedJets(int idx, enum JetType type, enum BtagType btag_type, float deltaR, float min_pt, float max_eta, float mu_minpt, float ele_minpt, float rescale, int systFlag, bool sort_by_pt)
 {
-    std::vector<LorentzVector> tmp_jets = getBtaggedJets(idx, true, type, JETS_CLEAN_HYP_E_MU, btag_type, deltaR, 0.0, max_eta, (double) rescale, systFlag);
+    SelectedJets tmp_jets;
+    selectBtaggedJets(tmp_jets, idx, type, JETS_CLEAN_HYP_E_MU, btag_type, deltaR, 0.0, max_eta, (double) rescale, systFlag);
+    tmp_jets.sortByPt();
+    const JetMask overlaps = numeratorJetOverlaps(type, deltaR, mu_minpt, ele_minpt);
 
     // ok, now perform the rest of the lepton overlap removal
     // and the impose the pt requirement after applying the
@@ -1564,41 +1559,12 @@ std::vector<LorentzVector> samesign::getBtaggedJets(int idx, enum JetType type,
     std::vector<LorentzVector> final_jets;
     for (unsigned int jidx = 0; jidx < tmp_jets.size(); jidx++) {
 
-        bool jetIsLep = false;
-
-        LorentzVector vjet = tmp_jets.at(jidx);
+        LorentzVector vjet = tmp_jets.p4(jidx);
         if (vjet.pt() < min_pt)
             continue;
 
-        for (unsigned int eidx = 0; eidx < cms2.els_p4().size(); eidx++) {
-            if (cms2.els_p4().at(eidx).pt() < ele_minpt)
-                continue;
-            if (!samesign::isNumeratorLepton(11, eidx))
-                continue;
-
-            if (ROOT::Math::VectorUtil::DeltaR(vjet, cms2.els_p4().at(eidx)) > deltaR)
-                continue;
-
-            jetIsLep = true;
-            break;
-        }
-
-        if (jetIsLep) continue;
-
-        for (unsigned int midx = 0; midx < cms2.mus_p4().size(); midx++) {
-            if (cms2.mus_p4().at(midx).pt() < mu_minpt)
-                continue;
-            if (!samesign::isNumeratorLepton(13, midx))
-                continue;
-
-            if (ROOT::Math::VectorUtil::DeltaR(vjet, cms2.mus_p4().at(midx)) > deltaR)
-                continue;                
-
-            jetIsLep = true;
-            break;
-        }            
-
-        if (jetIsLep) continue;
+        if (jetOverlaps(overlaps, tmp_jets.index(jidx)))
+            continue;
 
         final_jets.push_back(vjet);
     }
@@ -1716,6 +1682,7 @@ std::vector<LorentzVector> samesign::getBtaggedJets(int idx, FactorizedJetCorrec
 std::vector<bool> samesign::getBtaggedJetFlags(int idx, enum JetType type, enum BtagType btag_type, float deltaR, float min_pt, float max_eta, float mu_minpt, float ele_minpt, float rescale, int systFlag)
 {
     std::vector<bool> tmp_jet_flags = getBtaggedJetFlags(idx, type, JETS_CLEAN_HYP_E_MU, btag_type, deltaR, 0.0, max_eta, (double) rescale, systFlag);
+    const JetMask overlaps = numeratorJetOverlaps(type, deltaR, mu_minpt, ele_minpt);
 
     // ok, now perform the rest of the lepton overlap removal
     // and the impose the pt requirement after applying the
@@ -1739,44 +1706,11 @@ std::vector<bool> samesign::getBtaggedJetFlags(int idx, enum JetType type, enum
             continue;
         }
 
-        bool jetIsLep = false;
-
-        for (unsigned int eidx = 0; eidx < cms2.els_p4().size(); eidx++) {
-            if (cms2.els_p4().at(eidx).pt() < ele_minpt)
-                continue;
-            if (!samesign::isNumeratorLepton(11, eidx))
-                continue;
-
-            if (ROOT::Math::VectorUtil::DeltaR(vjet, cms2.els_p4().at(eidx)) > deltaR)
-                continue;
-
-            jetIsLep = true;
-            break;
-        }
-
-        if (jetIsLep) {
+        if (jetOverlaps(overlaps, jidx)) {
             final_jets.push_back(false);
             continue;
         }
 
-        for (unsigned int midx = 0; midx < cms2.mus_p4().size(); midx++) {
-            if (cms2.mus_p4().at(midx).pt() < mu_minpt)
-                continue;
-            if (!samesign::isNumeratorLepton(13, midx))
-                continue;
-
-            if (ROOT::Math::VectorUtil::DeltaR(vjet, cms2.mus_p4().at(midx)) > deltaR)
-                continue;                
-
-            jetIsLep = true;
-            break;
-        }            
-
-        if (jetIsLep) {
-            final_jets.push_back(false);
-            continue;   
-        }
-
         final_jets.push_back(true);
     }
 
@@ -2316,66 +2250,7 @@ std::vector<bool> samesign::getSortedBtaggedFlags(int idx, FactorizedJetCorrecto
 // -----------------------------------------------------------------------------
 float getErrPt(const float pt, const float eta)
 {
-    float InvPerr2;
-    float N = 0.0;
-    float S = 0.0;
-    float C = 0.0;
-    float m = 0.0;
-    if(fabs(eta) < 0.5)
-    {
-        N = 3.96859;
-        S = 0.18348;
-        C = 0.;
-        m = 0.62627;
-    } 
-    else if(fabs(eta) < 1.0)
-    {
-        N = 3.55226;
-        S = 0.24026;
-        C = 0.;
-        m = 0.52571;
-    } 
-    else if(fabs(eta) < 1.5) 
-    {
-        N = 4.54826;
-        S = 0.22652;
-        C = 0.;
-        m = 0.58963;
-    }
-    else if(fabs(eta) < 2.0)
-    {
-        N = 4.62622;
-        S = 0.23664;
-        C = 0.;
-        m = 0.48738;
-    }
-    else if(fabs(eta) < 2.5)
-    {
-        N = 2.53324;
-        S = 0.34306;
-        C = 0.;
-        m = 0.28662;
-    }
-    else if(fabs(eta) < 3.0)
-    {
-        N = -3.33814;
-        S = 0.73360;
-        C = 0.;
-        m = 0.08264;
-    }
-    else if(fabs(eta) < 5.0)
-    {
-        N = 2.95397;
-        S = 0.11619;
-        C = 0.;
-        m = 0.96086;
-    }
-    
-    // this is the absolute resolution (squared), not sigma(pt)/pt
-    // so have to multiply by pt^2, thats why m+1 instead of m-1
-    InvPerr2 = (N * fabs(N) ) + (S * S) * pow(pt, m+1) + (C * C) * pt * pt;
-
-    return sqrt(InvPerr2);
+    return jetResolutionErrPt(pt, eta);
 }
 
 // function to get the jer scale factors. values taken from the twiki: 
@@ -2383,13 +2258,7 @@ float getErrPt(const float pt, const float eta)
 // -------------------------------------------------------------------
 float getJERScale(const float jet_eta)
 {
-    const float aeta = fabs(jet_eta);
-    if      (aeta < 0.5) {return 1.052;}
-    else if (aeta < 1.1) {return 1.057;}
-    else if (aeta < 1.7) {return 1.096;}
-    else if (aeta < 2.3) {return 1.134;}
-    else                 {return 1.288;}
-
+    return jetResolutionScale(jet_eta);
 }
 
 // rescaled the jet p4s, met, met_phi and ht scaling up the JER
@@ -2819,7 +2688,9 @@ bool samesign2011::passThreeChargeRequirement(int elIdx)
 ///////////////////////////////////////////////////////////////////////////////////////////
 std::vector<LorentzVector> samesign2011::getJets(int idx, enum JetType type, double deltaR, double min_pt, double max_eta, double mu_minpt, double ele_minpt, enum IsolationType iso_type, double rescale) {
 
-    std::vector<LorentzVector> tmp_jets = getJets(idx, true, type, JETS_CLEAN_HYP_E_MU, deltaR, 0., max_eta, rescale);
+    SelectedJets tmp_jets;
+    selectJets(tmp_jets, idx, type, JETS_CLEAN_HYP_E_MU, deltaR, 0., max_eta, rescale);
+    const JetMask overlaps = numeratorJetOverlaps(type, deltaR, mu_minpt, ele_minpt, iso_type);
 
     // ok, now perform the rest of the lepton overlap removal
     // and the impose the pt requirement after applying the
@@ -2827,41 +2698,12 @@ std::vector<LorentzVector> samesign2011::getJets(int idx, enum JetType type, dou
     std::vector<LorentzVector> final_jets;
     for (unsigned int jidx = 0; jidx < tmp_jets.size(); jidx++) {
 
-        bool jetIsLep = false;
-
-        LorentzVector vjet = tmp_jets.at(jidx);
+        LorentzVector vjet = tmp_jets.p4(jidx);
         if (vjet.pt() < min_pt)
             continue;
 
-        for (unsigned int eidx = 0; eidx < cms2.els_p4().size(); eidx++) {
-            if (cms2.els_p4().at(eidx).pt() < ele_minpt)
-                continue;
-            if (!samesign2011::isNumeratorLepton(11, eidx, iso_type))
-                continue;
-
-            if (ROOT::Math::VectorUtil::DeltaR(vjet, cms2.els_p4().at(eidx)) > deltaR)
-                continue;
-
-            jetIsLep = true;
-            break;
-        }
-
-        if (jetIsLep) continue;
-
-        for (unsigned int midx = 0; midx < cms2.mus_p4().size(); midx++) {
-            if (cms2.mus_p4().at(midx).pt() < mu_minpt)
-                continue;
-            if (!samesign2011::isNumeratorLepton(13, midx, iso_type))
-                continue;
-
-            if (ROOT::Math::VectorUtil::DeltaR(vjet, cms2.mus_p4().at(midx)) > deltaR)
-                continue;                
-
-            jetIsLep = true;
-            break;
-        }            
-
-        if (jetIsLep) continue;
+        if (jetOverlaps(overlaps, tmp_jets.index(jidx)))
+            continue;
 
         final_jets.push_back(vjet);
     }
@@ -2901,6 +2743,7 @@ std::vector<LorentzVector> samesign2011::getJets(int idx, FactorizedJetCorrector
 std::vector<bool> samesign2011::getJetFlags(int idx, enum JetType type, double deltaR, double min_pt, double max_eta, double mu_minpt, double ele_minpt, enum IsolationType iso_type, double rescale) {
 
     std::vector<bool> tmp_jet_flags = getJetFlags((unsigned int)idx, type, JETS_CLEAN_HYP_E_MU, deltaR, 0., max_eta, rescale);
+    const JetMask overlaps = numeratorJetOverlaps(type, deltaR, mu_minpt, ele_minpt, iso_type);
 
     // ok, now perform the rest of the lepton overlap removal
     // and the impose the pt requirement after applying the
@@ -2919,44 +2762,11 @@ std::vector<bool> samesign2011::getJetFlags(int idx, enum JetType type, double d
             continue;
         }
 
-        bool jetIsLep = false;
-
-        for (unsigned int eidx = 0; eidx < cms2.els_p4().size(); eidx++) {
-            if (cms2.els_p4().at(eidx).pt() < ele_minpt)
-                continue;
-            if (!samesign2011::isNumeratorLepton(11, eidx, iso_type))
-                continue;
-
-            if (ROOT::Math::VectorUtil::DeltaR(vjet, cms2.els_p4().at(eidx)) > deltaR)
-                continue;
-
-            jetIsLep = true;
-            break;
-        }
-
-        if (jetIsLep) {
+        if (jetOverlaps(overlaps, jidx)) {
             final_jets.push_back(false);
             continue;
         }
 
-        for (unsigned int midx = 0; midx < cms2.mus_p4().size(); midx++) {
-            if (cms2.mus_p4().at(midx).pt() < mu_minpt)
-                continue;
-            if (!samesign2011::isNumeratorLepton(13, midx, iso_type))
-                continue;
-
-            if (ROOT::Math::VectorUtil::DeltaR(vjet, cms2.mus_p4().at(midx)) > deltaR)
-                continue;                
-
-            jetIsLep = true;
-            break;
-        }            
-
-        if (jetIsLep) {
-            final_jets.push_back(false);
-            continue;   
-        }
-
         final_jets.push_back(true);
     }
 
@@ -3140,7 +2950,9 @@ bool samesign2011::passesTrigger(bool is_data, int hyp_type, bool is_high_pt) {
 ///////////////////////////////////////////////////////////////////////////////////////////
 std::vector<LorentzVector> samesign2011::getBtaggedJets(int idx, enum JetType type, enum BtagType btag_type, double deltaR, double min_pt, double max_eta, double mu_minpt, double ele_minpt, enum IsolationType iso_type, double rescale) {
 
-    std::vector<LorentzVector> tmp_jets = getBtaggedJets(idx, true, type, JETS_CLEAN_HYP_E_MU, btag_type, deltaR, 0., max_eta, rescale);
+    SelectedJets tmp_jets;
+    selectBtaggedJets(tmp_jets, idx, type, JETS_CLEAN_HYP_E_MU, btag_type, deltaR, 0., max_eta, rescale);
+    const JetMask overlaps = numeratorJetOverlaps(type, deltaR, mu_minpt, ele_minpt, iso_type);
 
     // ok, now perform the rest of the lepton overlap removal
     // and the impose the pt requirement after applying the
@@ -3148,41 +2960,12 @@ std::vector<LorentzVector> samesign2011::getBtaggedJets(int idx, enum JetType ty
     std::vector<LorentzVector> final_jets;
     for (unsigned int jidx = 0; jidx < tmp_jets.size(); jidx++) {
 
-        bool jetIsLep = false;
-
-        LorentzVector vjet = tmp_jets.at(jidx);
+        LorentzVector vjet = tmp_jets.p4(jidx);
         if (vjet.pt() < min_pt)
             continue;
 
-        for (unsigned int eidx = 0; eidx < cms2.els_p4().size(); eidx++) {
-            if (cms2.els_p4().at(eidx).pt() < ele_minpt)
-                continue;
-            if (!samesign2011::isNumeratorLepton(11, eidx, iso_type))
-                continue;
-
-            if (ROOT::Math::VectorUtil::DeltaR(vjet, cms2.els_p4().at(eidx)) > deltaR)
-                continue;
-
-            jetIsLep = true;
-            break;
-        }
-
-        if (jetIsLep) continue;
-
-        for (unsigned int midx = 0; midx < cms2.mus_p4().size(); midx++) {
-            if (cms2.mus_p4().at(midx).pt() < mu_minpt)
-                continue;
-            if (!samesign2011::isNumeratorLepton(13, midx, iso_type))
-                continue;
-
-            if (ROOT::Math::VectorUtil::DeltaR(vjet, cms2.mus_p4().at(midx)) > deltaR)
-                continue;                
-
-            jetIsLep = true;
-            break;
-        }            
-
-        if (jetIsLep) continue;
+        if (jetOverlaps(overlaps, tmp_jets.index(jidx)))
+            continue;
 
         final_jets.push_back(vjet);
     }
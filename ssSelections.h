@@ -190,6 +190,16 @@ namespace samesign
     std::vector<bool> getJetFlags(int idx, FactorizedJetCorrector* jet_corrector, JetCorrectionUncertainty *jet_unc, enum JetScaleType scale_type,  enum JetType type, float deltaR = 0.4, float min_pt = 40.0, float max_eta = 2.4, float mu_minpt = 20.0, float ele_minpt = 20.0);	 
 
 
+    ///////////////////////////////////////////////////////////////////////////////////////////
+    // 2012 jets for several JES/JER variations at once (see getJetVariations in jetSelections.h),
+    // with the overlap removal with numerator e/mu with pt > x done once for all variations.
+    // Unlike the JEC uncertainty versions of getJets, the correction follows type and not
+    // evt_isRealData(): pass JETS_TYPE_PF_FAST_CORR_RESIDUAL on data, JETS_TYPE_PF_FAST_CORR on MC
+    ///////////////////////////////////////////////////////////////////////////////////////////
+
+    void getJetVariations(JetVariations& result, const std::vector<JetVariation>& variations, int idx, enum JetType type, float deltaR = 0.4, float min_pt = 40.0, float max_eta = 2.4, float mu_minpt = 20.0, float ele_minpt = 20.0, JetCorrectionUncertainty *jet_unc = 0, JetSmearer *jet_smearer = 0);
+
+
     ///////////////////////////////////////////////////////////////////////////////////////////
     // 2012 get sumpt, skip jets overlapping with numerator e/mu with pt>x (defaults are 20/20 GeV)
     ///////////////////////////////////////////////////////////////////////////////////////////
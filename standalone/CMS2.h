@@ -0,0 +1,68 @@
+#ifndef CMS2_H
+#define CMS2_H
+
+//---------------------------------------------------------
+// Mock of the CMS2 class that makeCMS2ClassFiles writes,
+// for the standalone programs. It has the same accessors
+// and the tas:: functions for the branches the CORE code
+// reads ( mock/CMS2Branches.h ), but each branch is a plain
+// member, filled by the caller instead of read from a
+// TTree; mock/mockEvents.h fills them from the synthetic
+// events.
+//
+// The CORE files include CMS2.h and ../CMS2.h, so the
+// programs are built with -I. -Imock to find this one.
+//---------------------------------------------------------
+
+#include "Math/LorentzVector.h"
+#include "TString.h"
+#include <vector>
+
+typedef ROOT::Math::LorentzVector<ROOT::Math::PxPyPzE4D<float> > LorentzVector;
+
+using namespace std;
+
+class CMS2 {
+public:
+    CMS2() { Clear(); }
+
+    // empties the vectors and zeroes the scalars, before
+    // an event is filled
+    void Clear();
+
+#define CMS2_BRANCH(type, name) \
+    type &name() { return name##_; }
+#include "mock/CMS2Branches.h"
+#undef CMS2_BRANCH
+
+    // a TBits and four ints in the ntuples; here one flag
+    // per name in hlt_trigNames and l1_trigNames
+    std::vector<bool> &hlt_bits() { return hlt_bits_; }
+    std::vector<bool> &l1_bits() { return l1_bits_; }
+
+    bool passHLTTrigger(TString trigName);
+    bool passL1Trigger(TString trigName);
+
+private:
+#define CMS2_BRANCH(type, name) \
+    type name##_;
+#include "mock/CMS2Branches.h"
+#undef CMS2_BRANCH
+    std::vector<bool> hlt_bits_;
+    std::vector<bool> l1_bits_;
+};
+
+#ifndef __CINT__
+extern CMS2 cms2;
+#endif
+
+namespace tas {
+#define CMS2_BRANCH(type, name) \
+    inline type &name() { return cms2.name(); }
+#include "mock/CMS2Branches.h"
+#undef CMS2_BRANCH
+    inline bool passHLTTrigger(TString trigName) { return cms2.passHLTTrigger(trigName); }
+    inline bool passL1Trigger(TString trigName) { return cms2.passL1Trigger(trigName); }
+}
+
+#endif
@@ -0,0 +1,659 @@
+//---------------------------------------------------------
+// Times CORE paths on synthetic events: MT2, MT2min, MT2J,
+// TMt2, Thrust, EventShape, the factorized jet corrections,
+// the QG likelihood and the effective area and jet
+// resolution lookups ( next to copies of the if/else
+// ladders they replaced ) on the events themselves, and the
+// PF isolation, electronSelection, isMITConversion, the jet
+// getters, randomConeEventDensity ( next to a copy of the 80
+// cell scan it replaced ) and the trigger matching on the
+// mock cms2 filled from them ( mock/mockEvents.h ). Needs
+// no ntuple; the corrections are read from the text files
+// in the CORE tree. MT2J also runs on dilepton ttbar events,
+// and the share of its pairings that MT2min had to bisect is
+// printed for both samples.
+//
+// Each path is run over all events --repeat times and the
+// fastest pass is reported; for the cms2 paths only the
+// calls are timed, not the filling of the mock. Built with
+// -DCORE_PROFILE the coreprofile report is printed as well.
+//---------------------------------------------------------
+
+#include "syntheticEvents.h"
+#include "CMS2.h"
+#include "mock/mockEvents.h"
+#include "../MT2/MT2.h"
+#include "../Thrust.h"
+#include "../EventShape.h"
+#include "../jetcorr/JetCorrectorParameters.h"
+#include "../jetcorr/FactorizedJetCorrector.h"
+#include "../QuarkGluonTagger/QGLikelihoodCalculator.h"
+#include "../electronSelections.h"
+#include "../jetSelections.h"
+#include "../MITConversionUtilities.h"
+#include "../triggerUtils.h"
+#include "../utilities.h"
+#include "../coreProfiler.h"
+
+#include "TMath.h"
+
+#include <time.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+namespace {
+
+    double now() {
+        timespec t;
+        clock_gettime(CLOCK_MONOTONIC, &t);
+        return t.tv_sec + 1e-9 * t.tv_nsec;
+    }
+
+    // results are summed into here so that no call can be optimized away
+    volatile double sink = 0;
+
+    // inputs shared by the paths, built before any timing
+    struct Inputs {
+        vector<SyntheticEvent>                 events;
+        vector<vector<LorentzVector> >         jets;       // jet p4s
+        vector<SyntheticEvent>                 ttbar;      // dilepton ttbar events
+        vector<vector<LorentzVector> >         ttbarJets;
+        vector<vector<LorentzVector> >         objects;    // leptons and jets
+        vector<vector<LorentzVector> >         mt2minV1;   // lepton 1 + jet i
+        vector<vector<LorentzVector> >         mt2minV2;   // lepton 2 + jet k, k != i
+        vector<float>                          lookupPt;   // jets and leptons of all events
+        vector<float>                          lookupEta;
+        FactorizedJetCorrector*                jec;
+        QGLikelihoodCalculator*                qgl;
+    };
+
+    // MT2min pairings of each lepton with a different one of
+    // the first four jets, as for MT2bl
+    void fillPairs(const SyntheticEvent& evt, vector<LorentzVector>& v1, vector<LorentzVector>& v2) {
+        unsigned int njets = evt.jets.size() < 4 ? evt.jets.size() : 4;
+        for (unsigned int i = 0; i < njets; i++) {
+            for (unsigned int k = 0; k < njets; k++) {
+                if (i == k)
+                    continue;
+                v1.push_back(evt.leptons[0] + evt.jets[i].p4);
+                v2.push_back(evt.leptons[1] + evt.jets[k].p4);
+            }
+        }
+    }
+
+    typedef unsigned long (*Path)(const Inputs&);
+
+    unsigned long runMT2(const Inputs& in) {
+        double sum = 0;
+        for (unsigned int i = 0; i < in.events.size(); i++) {
+            const SyntheticEvent& evt = in.events[i];
+            sum += MT2(evt.met, evt.metPhi, evt.leptons[0], evt.leptons[1]);
+        }
+        sink += sum;
+        return in.events.size();
+    }
+
+    unsigned long runMT2Massive(const Inputs& in) {
+        double sum = 0;
+        for (unsigned int i = 0; i < in.events.size(); i++) {
+            const SyntheticEvent& evt = in.events[i];
+            sum += MT2(evt.met, evt.metPhi, evt.leptons[0], evt.leptons[1], 50.);
+        }
+        sink += sum;
+        return in.events.size();
+    }
+
+    unsigned long runMT2min(const Inputs& in) {
+        double sum = 0;
+        unsigned long calls = 0;
+        for (unsigned int i = 0; i < in.events.size(); i++) {
+            if (in.mt2minV1[i].empty())
+                continue;
+            const SyntheticEvent& evt = in.events[i];
+            sum += MT2min(evt.met, evt.metPhi, in.mt2minV1[i], in.mt2minV2[i]);
+            calls++;
+        }
+        sink += sum;
+        return calls;
+    }
+
+    unsigned long runMT2J(const vector<SyntheticEvent>& events, const vector<vector<LorentzVector> >& jets) {
+        double sum = 0;
+        unsigned long calls = 0;
+        for (unsigned int i = 0; i < events.size(); i++) {
+            if (jets[i].size() < 2)
+                continue;
+            const SyntheticEvent& evt = events[i];
+            sum += MT2J(evt.met, evt.metPhi, evt.leptons[0], evt.leptons[1], jets[i]);
+            calls++;
+        }
+        sink += sum;
+        return calls;
+    }
+
+    unsigned long runMT2J(const Inputs& in) {
+        return runMT2J(in.events, in.jets);
+    }
+
+    unsigned long runMT2JTTbar(const Inputs& in) {
+        return runMT2J(in.ttbar, in.ttbarJets);
+    }
+
+    // share of the MT2J pairings that MT2min bisected, the rest
+    // was skipped on the lower bound
+    void reportMT2JPruning(const char* name, const vector<SyntheticEvent>& events, const vector<vector<LorentzVector> >& jets) {
+        unsigned long npairs = 0, nbisections = 0;
+        resetMT2minCounters();
+        runMT2J(events, jets);
+        getMT2minCounters(npairs, nbisections);
+        printf("MT2J %-8s %10lu pairings, %10lu bisected (%.1f%%)\n", name, npairs, nbisections,
+               npairs ? 100. * nbisections / npairs : 0.);
+    }
+
+    unsigned long runTMt2(const Inputs& in) {
+        double sum = 0;
+        TMt2 tmt2;
+        for (unsigned int i = 0; i < in.events.size(); i++) {
+            const SyntheticEvent& evt = in.events[i];
+            sum += tmt2.GetMt2(evt.met, evt.metPhi, evt.leptons[0], evt.leptons[1]);
+            sum += tmt2.Nu1p4().px();
+        }
+        sink += sum;
+        return in.events.size();
+    }
+
+    unsigned long runThrust(const Inputs& in) {
+        double sum = 0;
+        for (unsigned int i = 0; i < in.events.size(); i++) {
+            Thrust thrust(in.objects[i]);
+            sum += thrust.thrust();
+        }
+        sink += sum;
+        return in.events.size();
+    }
+
+    unsigned long runThrustTransverse(const Inputs& in) {
+        double sum = 0;
+        for (unsigned int i = 0; i < in.events.size(); i++) {
+            Thrust thrust(in.objects[i], true);
+            sum += thrust.thrust();
+        }
+        sink += sum;
+        return in.events.size();
+    }
+
+    unsigned long runEventShape(const Inputs& in) {
+        double sum = 0;
+        for (unsigned int i = 0; i < in.events.size(); i++) {
+            EventShape shape(in.objects[i]);
+            sum += shape.sphericity() + shape.aplanarity() + shape.circularity();
+        }
+        sink += sum;
+        return in.events.size();
+    }
+
+    unsigned long runJEC(const Inputs& in) {
+        double sum = 0;
+        unsigned long calls = 0;
+        for (unsigned int i = 0; i < in.events.size(); i++) {
+            const SyntheticEvent& evt = in.events[i];
+            for (unsigned int ijet = 0; ijet < evt.jets.size(); ijet++) {
+                in.jec->setRho(evt.rho);
+                in.jec->setJetA(evt.jets[ijet].area);
+                in.jec->setJetPt(evt.jets[ijet].pt);
+                in.jec->setJetEta(evt.jets[ijet].eta);
+                sum += in.jec->getCorrection();
+                calls++;
+            }
+        }
+        sink += sum;
+        return calls;
+    }
+
+    unsigned long runQGL(const Inputs& in) {
+        double sum = 0;
+        unsigned long calls = 0;
+        for (unsigned int i = 0; i < in.events.size(); i++) {
+            const SyntheticEvent& evt = in.events[i];
+            for (unsigned int ijet = 0; ijet < evt.jets.size(); ijet++) {
+                const SyntheticJet& jet = evt.jets[ijet];
+                sum += in.qgl->computeQGLikelihood(jet.pt, evt.rho, jet.nCharged, jet.nNeutral, jet.ptD);
+                calls++;
+            }
+        }
+        sink += sum;
+        return calls;
+    }
+
+    // the binned lookups of user code: the effective areas of
+    // the PF isolation and the MC jet resolution and JER scale
+    // factor, on the jet and lepton etas
+    unsigned long runEffAreaLookup(const Inputs& in) {
+        double sum = 0;
+        for (unsigned int i = 0; i < in.lookupEta.size(); i++)
+            sum += fastJetEffArea03_v2(in.lookupEta[i]) + fastJetEffArea04_v2(in.lookupEta[i]);
+        sink += sum;
+        return 2 * in.lookupEta.size();
+    }
+
+    unsigned long runJetResolutionLookup(const Inputs& in) {
+        double sum = 0;
+        for (unsigned int i = 0; i < in.lookupEta.size(); i++)
+            sum += jetResolutionErrPt(in.lookupPt[i], in.lookupEta[i]) + jetResolutionScale(in.lookupEta[i]);
+        sink += sum;
+        return 2 * in.lookupEta.size();
+    }
+
+    // the if/else ladders that the lookups replaced, kept out of
+    // line like the CORE functions so that neither side is inlined
+    __attribute__((noinline)) float fastJetEffArea03_v2Ladder(const float eta)
+    {
+        const float etaAbs = fabs(eta);
+        if      (etaAbs <= 1.0                  ) {return 0.13;}
+        else if (etaAbs > 1.0 && etaAbs <= 1.479) {return 0.14;}
+        else if (etaAbs > 1.479 && etaAbs <= 2.0) {return 0.07;}
+        else if (etaAbs > 2.0 && etaAbs <= 2.2  ) {return 0.09;}
+        else if (etaAbs > 2.2 && etaAbs <= 2.3  ) {return 0.11;}
+        else if (etaAbs > 2.3 && etaAbs <= 2.4  ) {return 0.11;}
+        else if (etaAbs > 2.4                   ) {return 0.14;}
+        return -9999.0f;
+    }
+
+    __attribute__((noinline)) float fastJetEffArea04_v2Ladder(const float eta)
+    {
+        const float etaAbs = fabs(eta);
+        if      (etaAbs <= 1.0                  ) {return 0.21;}
+        else if (etaAbs > 1.0 && etaAbs <= 1.479) {return 0.21;}
+        else if (etaAbs > 1.479 && etaAbs <= 2.0) {return 0.11;}
+        else if (etaAbs > 2.0 && etaAbs <= 2.2  ) {return 0.14;}
+        else if (etaAbs > 2.2 && etaAbs <= 2.3  ) {return 0.18;}
+        else if (etaAbs > 2.3 && etaAbs <= 2.4  ) {return 0.19;}
+        else if (etaAbs > 2.4                   ) {return 0.26;}
+        return -9999.0f;
+    }
+
+    __attribute__((noinline)) float getErrPtLadder(const float pt, const float eta)
+    {
+        float N = 0.0, S = 0.0, C = 0.0, m = 0.0;
+        if      (fabs(eta) < 0.5) { N =  3.96859; S = 0.18348; C = 0.; m = 0.62627; }
+        else if (fabs(eta) < 1.0) { N =  3.55226; S = 0.24026; C = 0.; m = 0.52571; }
+        else if (fabs(eta) < 1.5) { N =  4.54826; S = 0.22652; C = 0.; m = 0.58963; }
+        else if (fabs(eta) < 2.0) { N =  4.62622; S = 0.23664; C = 0.; m = 0.48738; }
+        else if (fabs(eta) < 2.5) { N =  2.53324; S = 0.34306; C = 0.; m = 0.28662; }
+        else if (fabs(eta) < 3.0) { N = -3.33814; S = 0.73360; C = 0.; m = 0.08264; }
+        else if (fabs(eta) < 5.0) { N =  2.95397; S = 0.11619; C = 0.; m = 0.96086; }
+        float InvPerr2 = (N * fabs(N) ) + (S * S) * pow(pt, m+1) + (C * C) * pt * pt;
+        return sqrt(InvPerr2);
+    }
+
+    __attribute__((noinline)) float getJERScaleLadder(const float jet_eta)
+    {
+        const float aeta = fabs(jet_eta);
+        if      (aeta < 0.5) {return 1.052;}
+        else if (aeta < 1.1) {return 1.057;}
+        else if (aeta < 1.7) {return 1.096;}
+        else if (aeta < 2.3) {return 1.134;}
+        else                 {return 1.288;}
+    }
+
+    unsigned long runEffAreaLadder(const Inputs& in) {
+        double sum = 0;
+        for (unsigned int i = 0; i < in.lookupEta.size(); i++)
+            sum += fastJetEffArea03_v2Ladder(in.lookupEta[i]) + fastJetEffArea04_v2Ladder(in.lookupEta[i]);
+        sink += sum;
+        return 2 * in.lookupEta.size();
+    }
+
+    unsigned long runJetResolutionLadder(const Inputs& in) {
+        double sum = 0;
+        for (unsigned int i = 0; i < in.lookupEta.size(); i++)
+            sum += getErrPtLadder(in.lookupPt[i], in.lookupEta[i]) + getJERScaleLadder(in.lookupEta[i]);
+        sink += sum;
+        return 2 * in.lookupEta.size();
+    }
+
+    // the paths that read cms2 work on the event that fillCMS2
+    // put into the mock, and return the number of calls made
+    typedef unsigned long (*EventPath)();
+
+    unsigned long runElectronIsoPF() {
+        double sum = 0;
+        float ch, em, nh;
+        for (unsigned int iel = 0; iel < cms2.els_p4().size(); iel++) {
+            electronIsoValuePF2012(ch, em, nh, 0.3, iel, 0);
+            sum += ch + em + nh;
+        }
+        sink += sum;
+        return cms2.els_p4().size();
+    }
+
+    unsigned long runElectronIsoPFCones() {
+        double sum = 0;
+        vector<float> cones, ch, em, nh;
+        cones.push_back(0.2);
+        cones.push_back(0.3);
+        cones.push_back(0.4);
+        for (unsigned int iel = 0; iel < cms2.els_p4().size(); iel++) {
+            electronIsoValuePF2012(ch, em, nh, cones, iel, 0, true);
+            for (unsigned int icone = 0; icone < cones.size(); icone++)
+                sum += ch[icone] + em[icone] + nh[icone];
+        }
+        sink += sum;
+        return cms2.els_p4().size();
+    }
+
+    unsigned long runElectronSelection() {
+        cuts_t bits = 0;
+        for (unsigned int iel = 0; iel < cms2.els_p4().size(); iel++)
+            bits ^= electronSelection(iel);
+        sink += bits;
+        return cms2.els_p4().size();
+    }
+
+    unsigned long runMITConversion() {
+        unsigned int nconv = 0;
+        for (unsigned int iel = 0; iel < cms2.els_p4().size(); iel++)
+            nconv += isMITConversion(iel, 0, 1e-6, 2.0, true, false);
+        sink += nconv;
+        return cms2.els_p4().size();
+    }
+
+    unsigned long runGetJets() {
+        double sum = 0;
+        for (unsigned int ihyp = 0; ihyp < cms2.hyp_type().size(); ihyp++) {
+            vector<LorentzVector> jets = getJets(ihyp, true, JETS_TYPE_PF_FAST_CORR, JETS_CLEAN_HYP_E_MU, 0.4, 30., 2.5);
+            for (unsigned int ijet = 0; ijet < jets.size(); ijet++)
+                sum += jets[ijet].pt();
+        }
+        sink += sum;
+        return cms2.hyp_type().size();
+    }
+
+    unsigned long runSelectJets() {
+        double sum = 0;
+        SelectedJets jets;
+        for (unsigned int ihyp = 0; ihyp < cms2.hyp_type().size(); ihyp++) {
+            selectJets(jets, ihyp, JETS_TYPE_PF_FAST_CORR, JETS_CLEAN_HYP_E_MU, 0.4, 30., 2.5);
+            jets.sortByPt();
+            for (unsigned int ijet = 0; ijet < jets.size(); ijet++)
+                sum += jets.pt(ijet);
+        }
+        sink += sum;
+        return cms2.hyp_type().size();
+    }
+
+    // nominal jets and the getJetMetSyst shifts, as the analyses
+    // loop over them
+    unsigned long runJetVariations() {
+        double sum = 0;
+        vector<JetVariation> variations;
+        variations.push_back(JetVariation());
+        variations.push_back(JetVariation(JETS_VAR_SYST, 1));
+        variations.push_back(JetVariation(JETS_VAR_SYST, -1));
+        JetVariations jets;
+        for (unsigned int ihyp = 0; ihyp < cms2.hyp_type().size(); ihyp++) {
+            getJetVariations(jets, variations, ihyp, JETS_TYPE_PF_FAST_CORR, JETS_CLEAN_HYP_E_MU, 0.4, 30., 2.5);
+            for (unsigned int ivar = 0; ivar < jets.nVariations(); ivar++)
+                sum += jets.sumPt(ivar);
+        }
+        sink += sum;
+        return cms2.hyp_type().size();
+    }
+
+    unsigned long runRandomConeDensity() {
+        sink += randomConeEventDensity();
+        return 1;
+    }
+
+    // randomConeEventDensity as it was before the single pass:
+    // every PF candidate is tested against each of the 80 cells
+    float randomConeDensityGrid() {
+        vector<float> etabins;
+        for (int i=0;i<8;++i) etabins.push_back(-2.1+0.6*i);
+        vector<float> phibins;
+        for (int i=0;i<10;i++) phibins.push_back(-TMath::Pi()+(2*i+1)*TMath::TwoPi()/20.);
+
+        float etadist = etabins[1]-etabins[0];
+        float phidist = phibins[1]-phibins[0];
+        float etahalfdist = (etabins[1]-etabins[0])/2.;
+        float phihalfdist = (phibins[1]-phibins[0])/2.;
+
+        vector<float> sumPFNallSMDQ;
+        sumPFNallSMDQ.reserve(80);
+        for (unsigned int ieta=0;ieta<etabins.size();++ieta) {
+            for (unsigned int iphi=0;iphi<phibins.size();++iphi) {
+                float pfniso_ieta_iphi = 0;
+                for (unsigned int ipf=0; ipf<cms2.pfcands_p4().size(); ++ipf){
+                    if (fabs(etabins[ieta]-cms2.pfcands_p4().at(ipf).eta())>etahalfdist) continue;
+                    if (fabs(deltaPhi(phibins[iphi],cms2.pfcands_p4().at(ipf).phi()))>phihalfdist) continue;
+                    pfniso_ieta_iphi+=cms2.pfcands_p4().at(ipf).pt();
+                }
+                sumPFNallSMDQ.push_back(pfniso_ieta_iphi);
+            }
+        }
+
+        float evt_smdq = 0;
+        sort(sumPFNallSMDQ.begin(),sumPFNallSMDQ.end());
+        if (sumPFNallSMDQ.size()%2) evt_smdq = sumPFNallSMDQ[(sumPFNallSMDQ.size()-1)/2];
+        else evt_smdq = (sumPFNallSMDQ[sumPFNallSMDQ.size()/2]+sumPFNallSMDQ[(sumPFNallSMDQ.size()-2)/2])/2.;
+        return evt_smdq/(etadist*phidist);
+    }
+
+    unsigned long runRandomConeDensityGrid() {
+        sink += randomConeDensityGrid();
+        return 1;
+    }
+
+    // each lepton against its single lepton path
+    unsigned long runHLTMatch() {
+        unsigned int nmatch = 0;
+        for (unsigned int iel = 0; iel < cms2.els_p4().size(); iel++)
+            nmatch += passUnprescaledHLTTrigger("HLT_Ele27_WP80_v11", cms2.els_p4()[iel]);
+        for (unsigned int imu = 0; imu < cms2.mus_p4().size(); imu++)
+            nmatch += passUnprescaledHLTTrigger("HLT_IsoMu24_eta2p1_v13", cms2.mus_p4()[imu]);
+        sink += nmatch;
+        return cms2.els_p4().size() + cms2.mus_p4().size();
+    }
+
+    // all objects of all paths of the mock menu
+    unsigned long runHLTObjects() {
+        double sum = 0;
+        unsigned long calls = 0;
+        for (unsigned int itrg = 0; itrg < nMockHLT; itrg++) {
+            int nobjects = nHLTObjects(mockHLTNames[itrg]);
+            for (int iobj = 0; iobj < nobjects; iobj++) {
+                sum += p4HLTObject(mockHLTNames[itrg], iobj).pt() + idHLTObject(mockHLTNames[itrg], iobj);
+                calls += 2;
+            }
+            calls++;
+        }
+        sink += sum;
+        return calls;
+    }
+
+    struct Benchmark {
+        const char* name;
+        Path        path;
+    };
+
+    struct EventBenchmark {
+        const char* name;
+        EventPath   path;
+    };
+
+    const Benchmark benchmarks[] = {
+        { "MT2",                    runMT2                 },
+        { "MT2 (mn = 50)",          runMT2Massive          },
+        { "MT2min",                 runMT2min              },
+        { "MT2J",                   runMT2J                },
+        { "MT2J (ttbar)",           runMT2JTTbar           },
+        { "TMt2",                   runTMt2                },
+        { "Thrust",                 runThrust              },
+        { "Thrust transverse",      runThrustTransverse    },
+        { "EventShape",             runEventShape          },
+        { "FactorizedJetCorrector", runJEC                 },
+        { "QGLikelihood",           runQGL                 },
+        { "fastJetEffArea",         runEffAreaLookup       },
+        { "  (if/else ladder)",     runEffAreaLadder       },
+        { "jetResolution",          runJetResolutionLookup },
+        { "  (if/else ladder)",     runJetResolutionLadder }
+    };
+
+    const EventBenchmark eventBenchmarks[] = {
+        { "electronIsoValuePF2012", runElectronIsoPF         },
+        { "  (3 cones)",            runElectronIsoPFCones    },
+        { "electronSelection",      runElectronSelection     },
+        { "isMITConversion",        runMITConversion         },
+        { "getJets",                runGetJets               },
+        { "selectJets",             runSelectJets            },
+        { "getJetVariations",       runJetVariations         },
+        { "randomConeEventDensity", runRandomConeDensity     },
+        { "  (80 cell scan)",       runRandomConeDensityGrid },
+        { "HLT object match",       runHLTMatch              },
+        { "HLT objects",            runHLTObjects            }
+    };
+    const unsigned int nEventBenchmarks = sizeof(eventBenchmarks) / sizeof(eventBenchmarks[0]);
+
+    void printTiming(const char* name, unsigned long calls, double seconds) {
+        printf("%-24s %10lu %12.1f %12.3f\n", name, calls,
+               calls ? 1e9 * seconds / calls : 0., 1e3 * seconds);
+    }
+}
+
+//______________________________________________________________________________
+int main(int argc, char** argv)
+{
+    SyntheticConfig config;
+    string   core("..");
+    unsigned repeat(3);
+
+    for (int i = 1; i < argc; i++) {
+        string arg(argv[i]);
+        if (arg == "--help") {
+            cout << "USAGE: coreBenchmark --nevts <n> --seed <s> --pileup <mean nvtx> --njets <mean njets> --repeat <n> --core <CORE dir>" << endl;
+            return 0;
+        }
+        if (i + 1 >= argc) {
+            cerr << "ERROR: option '" << arg << "' needs a value" << endl;
+            return 1;
+        }
+        stringstream ss(argv[++i]);
+        if      (arg == "--nevts")  ss >> config.nEvents;
+        else if (arg == "--seed")   ss >> config.seed;
+        else if (arg == "--pileup") ss >> config.pileup;
+        else if (arg == "--njets")  ss >> config.nJets;
+        else if (arg == "--repeat") ss >> repeat;
+        else if (arg == "--core")   ss >> core;
+        else {
+            cerr << "ERROR: unknown option '" << arg << "'" << endl;
+            return 1;
+        }
+    }
+    if (repeat == 0)
+        repeat = 1;
+
+    Inputs in;
+    generateEvents(in.events, config);
+    unsigned int nevts = in.events.size();
+    in.jets.resize(nevts);
+    in.objects.resize(nevts);
+    in.mt2minV1.resize(nevts);
+    in.mt2minV2.resize(nevts);
+    for (unsigned int i = 0; i < nevts; i++) {
+        const SyntheticEvent& evt = in.events[i];
+        in.objects[i] = evt.leptons;
+        for (unsigned int ijet = 0; ijet < evt.jets.size(); ijet++) {
+            in.jets[i].push_back(evt.jets[ijet].p4);
+            in.objects[i].push_back(evt.jets[ijet].p4);
+        }
+        fillPairs(evt, in.mt2minV1[i], in.mt2minV2[i]);
+        for (unsigned int ilep = 0; ilep < evt.leptons.size(); ilep++) {
+            in.lookupPt.push_back(evt.leptons[ilep].pt());
+            in.lookupEta.push_back(evt.leptons[ilep].eta());
+        }
+        for (unsigned int ijet = 0; ijet < evt.jets.size(); ijet++) {
+            in.lookupPt.push_back(evt.jets[ijet].pt);
+            in.lookupEta.push_back(evt.jets[ijet].eta);
+        }
+    }
+    generateTTbarEvents(in.ttbar, config);
+    in.ttbarJets.resize(in.ttbar.size());
+    for (unsigned int i = 0; i < in.ttbar.size(); i++) {
+        for (unsigned int ijet = 0; ijet < in.ttbar[i].jets.size(); ijet++)
+            in.ttbarJets[i].push_back(in.ttbar[i].jets[ijet].p4);
+    }
+
+    vector<JetCorrectorParameters> jecParameters;
+    jecParameters.push_back(JetCorrectorParameters(core + "/jetcorr/data/FT_53_V10_AN1_L1FastJet_AK5PF.txt"));
+    jecParameters.push_back(JetCorrectorParameters(core + "/jetcorr/data/FT_53_V10_AN1_L2Relative_AK5PF.txt"));
+    jecParameters.push_back(JetCorrectorParameters(core + "/jetcorr/data/FT_53_V10_AN1_L3Absolute_AK5PF.txt"));
+    in.jec = new FactorizedJetCorrector(jecParameters);
+    in.qgl = new QGLikelihoodCalculator(core + "/QuarkGluonTagger/QGTaggerConfig_nCharged_AK5PF.txt",
+                                        core + "/QuarkGluonTagger/QGTaggerConfig_nNeutral_AK5PF.txt",
+                                        core + "/QuarkGluonTagger/QGTaggerConfig_ptD_AK5PF.txt");
+
+    cout << "events: " << nevts << ", seed: " << config.seed << ", pileup: " << config.pileup
+         << ", njets: " << config.nJets << ", best of " << repeat << endl << endl;
+
+    printf("%-24s %10s %12s %12s\n", "path", "calls", "ns/call", "ms/pass");
+    for (unsigned int ib = 0; ib < sizeof(benchmarks) / sizeof(benchmarks[0]); ib++) {
+        double best = -1;
+        unsigned long calls = 0;
+        for (unsigned int ir = 0; ir < repeat; ir++) {
+            double start = now();
+            calls = benchmarks[ib].path(in);
+            double seconds = now() - start;
+            if (best < 0 || seconds < best)
+                best = seconds;
+        }
+        printTiming(benchmarks[ib].name, calls, best);
+    }
+
+    // the cms2 paths: each pass fills the mock event by event,
+    // which is not timed, and times each path on it. Every path
+    // of every pass has its own run number, so that the per-event
+    // caches are built inside the timed call
+    vector<double> best(nEventBenchmarks, -1);
+    vector<double> seconds(nEventBenchmarks);
+    vector<unsigned long> calls(nEventBenchmarks);
+    for (unsigned int ir = 0; ir < repeat; ir++) {
+        seconds.assign(nEventBenchmarks, 0.);
+        calls.assign(nEventBenchmarks, 0);
+        for (unsigned int i = 0; i < nevts; i++) {
+            fillCMS2(in.events[i], 1, i);
+            for (unsigned int ib = 0; ib < nEventBenchmarks; ib++) {
+                cms2.evt_run() = 1 + ir * nEventBenchmarks + ib;
+                double start = now();
+                calls[ib] += eventBenchmarks[ib].path();
+                seconds[ib] += now() - start;
+            }
+        }
+        for (unsigned int ib = 0; ib < nEventBenchmarks; ib++) {
+            if (best[ib] < 0 || seconds[ib] < best[ib])
+                best[ib] = seconds[ib];
+        }
+    }
+    for (unsigned int ib = 0; ib < nEventBenchmarks; ib++)
+        printTiming(eventBenchmarks[ib].name, calls[ib], best[ib]);
+
+    cout << endl;
+    reportMT2JPruning("generic", in.events, in.jets);
+    reportMT2JPruning("ttbar", in.ttbar, in.ttbarJets);
+
+#ifdef CORE_PROFILE
+    cout << endl;
+    coreprofile::report();
+#endif
+
+    delete in.jec;
+    delete in.qgl;
+    return 0;
+}
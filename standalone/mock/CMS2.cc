@@ -0,0 +1,37 @@
+#include "CMS2.h"
+
+#include <algorithm>
+
+CMS2 cms2;
+
+namespace {
+
+    template <class T> void clearBranch(T &branch) {
+        branch = T();
+    }
+
+    bool passTrigger(const std::vector<TString> &names, const std::vector<bool> &bits, const TString &trigName) {
+        std::vector<TString>::const_iterator found = std::find(names.begin(), names.end(), trigName);
+        if (found == names.end())
+            return false;
+        unsigned int index = found - names.begin();
+        return index < bits.size() && bits[index];
+    }
+}
+
+void CMS2::Clear() {
+#define CMS2_BRANCH(type, name) \
+    clearBranch(name##_);
+#include "mock/CMS2Branches.h"
+#undef CMS2_BRANCH
+    hlt_bits_.clear();
+    l1_bits_.clear();
+}
+
+bool CMS2::passHLTTrigger(TString trigName) {
+    return passTrigger(hlt_trigNames_, hlt_bits_, trigName);
+}
+
+bool CMS2::passL1Trigger(TString trigName) {
+    return passTrigger(l1_trigNames_, l1_bits_, trigName);
+}
@@ -0,0 +1,282 @@
+// The cms2 branches read by the CORE code, as CMS2_BRANCH( type, name ),
+// for the mock CMS2 class of the standalone programs ( ../CMS2.h ).
+// The types are the ones in the ntuples. Add a branch here when a
+// new selection reads one; the fill functions in mockEvents.cc leave
+// the branches they do not know about empty.
+
+CMS2_BRANCH( std::vector<float>, convs_chi2 )
+CMS2_BRANCH( std::vector<float>, convs_dl )
+CMS2_BRANCH( std::vector<int>, convs_isConverted )
+CMS2_BRANCH( std::vector<std::vector<int> >, convs_nHitsBeforeVtx )
+CMS2_BRANCH( std::vector<float>, convs_ndof )
+CMS2_BRANCH( std::vector<int>, convs_quality )
+CMS2_BRANCH( std::vector<std::vector<int> >, convs_tkalgo )
+CMS2_BRANCH( std::vector<std::vector<int> >, convs_tkidx )
+CMS2_BRANCH( std::vector<int>, els_charge )
+CMS2_BRANCH( std::vector<int>, els_closestMuon )
+CMS2_BRANCH( std::vector<float>, els_conv_dcot )
+CMS2_BRANCH( std::vector<float>, els_conv_dist )
+CMS2_BRANCH( std::vector<float>, els_conv_old_dcot )
+CMS2_BRANCH( std::vector<float>, els_conv_old_dist )
+CMS2_BRANCH( std::vector<float>, els_d0 )
+CMS2_BRANCH( std::vector<float>, els_d0corr )
+CMS2_BRANCH( std::vector<float>, els_dEtaIn )
+CMS2_BRANCH( std::vector<float>, els_dPhiIn )
+CMS2_BRANCH( std::vector<float>, els_e2x5Max )
+CMS2_BRANCH( std::vector<float>, els_e5x5 )
+CMS2_BRANCH( std::vector<float>, els_eOverPIn )
+CMS2_BRANCH( std::vector<float>, els_eSC )
+CMS2_BRANCH( std::vector<float>, els_eSeedOverPIn )
+CMS2_BRANCH( std::vector<float>, els_ecalEnergy )
+CMS2_BRANCH( std::vector<float>, els_ecalIso )
+CMS2_BRANCH( std::vector<float>, els_ecalIso04 )
+CMS2_BRANCH( std::vector<float>, els_etaSC )
+CMS2_BRANCH( std::vector<int>, els_exp_innerlayers )
+CMS2_BRANCH( std::vector<float>, els_fbrem )
+CMS2_BRANCH( std::vector<int>, els_fiduciality )
+CMS2_BRANCH( std::vector<int>, els_gsftrkidx )
+CMS2_BRANCH( std::vector<float>, els_hOverE )
+CMS2_BRANCH( std::vector<float>, els_hcalIso )
+CMS2_BRANCH( std::vector<float>, els_hcalIso04 )
+CMS2_BRANCH( std::vector<float>, els_iso03_pf )
+CMS2_BRANCH( std::vector<float>, els_iso03_pf2012_ch )
+CMS2_BRANCH( std::vector<float>, els_iso03_pf2012_em )
+CMS2_BRANCH( std::vector<float>, els_iso03_pf2012_nh )
+CMS2_BRANCH( std::vector<float>, els_iso03_pf2012ext_ch )
+CMS2_BRANCH( std::vector<float>, els_iso03_pf2012ext_em )
+CMS2_BRANCH( std::vector<float>, els_iso03_pf2012ext_nh )
+CMS2_BRANCH( std::vector<float>, els_iso04_pf )
+CMS2_BRANCH( std::vector<float>, els_iso04_pf2012_ch )
+CMS2_BRANCH( std::vector<float>, els_iso04_pf2012_em )
+CMS2_BRANCH( std::vector<float>, els_iso04_pf2012_nh )
+CMS2_BRANCH( std::vector<float>, els_iso04_pf2012ext_ch )
+CMS2_BRANCH( std::vector<float>, els_iso04_pf2012ext_em )
+CMS2_BRANCH( std::vector<float>, els_iso04_pf2012ext_nh )
+CMS2_BRANCH( std::vector<int>, els_mc3_id )
+CMS2_BRANCH( std::vector<int>, els_mc3_motherid )
+CMS2_BRANCH( std::vector<int>, els_mc_id )
+CMS2_BRANCH( std::vector<int>, els_mc_motherid )
+CMS2_BRANCH( std::vector<LorentzVector>, els_mc_p4 )
+CMS2_BRANCH( std::vector<float>, els_mva )
+CMS2_BRANCH( std::vector<int>, els_nSeed )
+CMS2_BRANCH( std::vector<LorentzVector>, els_p4 )
+CMS2_BRANCH( std::vector<int>, els_sccharge )
+CMS2_BRANCH( std::vector<int>, els_scindex )
+CMS2_BRANCH( std::vector<float>, els_sigmaIEtaIEta )
+CMS2_BRANCH( std::vector<float>, els_tkIso )
+CMS2_BRANCH( std::vector<int>, els_trk_charge )
+CMS2_BRANCH( std::vector<LorentzVector>, els_trk_p4 )
+CMS2_BRANCH( std::vector<int>, els_trkidx )
+CMS2_BRANCH( std::vector<float>, els_trkshFrac )
+CMS2_BRANCH( std::vector<int>, els_type )
+CMS2_BRANCH( std::vector<LorentzVector>, els_vertex_p4 )
+CMS2_BRANCH( std::vector<float>, evt35X_mus_tcmet_deltax )
+CMS2_BRANCH( std::vector<float>, evt35X_mus_tcmet_deltay )
+CMS2_BRANCH( std::vector<int>, evt35X_mus_tcmet_flag )
+CMS2_BRANCH( int, evt_cscTightHaloId )
+CMS2_BRANCH( std::vector<TString>, evt_dataset )
+CMS2_BRANCH( unsigned int, evt_event )
+CMS2_BRANCH( int, evt_hbheFilter )
+CMS2_BRANCH( int, evt_isRealData )
+CMS2_BRANCH( float, evt_kt6pf_foregiso_rho )
+CMS2_BRANCH( unsigned int, evt_lumiBlock )
+CMS2_BRANCH( float, evt_met )
+CMS2_BRANCH( float, evt_metPhi )
+CMS2_BRANCH( float, evt_pfmet )
+CMS2_BRANCH( float, evt_pfmetPhi )
+CMS2_BRANCH( float, evt_rho )
+CMS2_BRANCH( unsigned int, evt_run )
+CMS2_BRANCH( float, evt_sumet )
+CMS2_BRANCH( float, evt_ww_rho )
+CMS2_BRANCH( float, evt_ww_rho_vor )
+CMS2_BRANCH( bool, filt_ecalLaser )
+CMS2_BRANCH( bool, filt_ecalTP )
+CMS2_BRANCH( bool, filt_eeBadSc )
+CMS2_BRANCH( bool, filt_hcalLaser )
+CMS2_BRANCH( bool, filt_trackingFailure )
+CMS2_BRANCH( std::vector<LorentzVector>, genjets_p4 )
+CMS2_BRANCH( std::vector<int>, genps_id )
+CMS2_BRANCH( std::vector<int>, genps_id_mother )
+CMS2_BRANCH( std::vector<std::vector<int> >, genps_lepdaughter_id )
+CMS2_BRANCH( std::vector<std::vector<LorentzVector> >, genps_lepdaughter_p4 )
+CMS2_BRANCH( std::vector<LorentzVector>, genps_p4 )
+CMS2_BRANCH( std::vector<int>, genps_status )
+CMS2_BRANCH( std::vector<int>, gsftrks_charge )
+CMS2_BRANCH( std::vector<float>, gsftrks_d0 )
+CMS2_BRANCH( std::vector<float>, gsftrks_d0Err )
+CMS2_BRANCH( std::vector<float>, gsftrks_d0phiCov )
+CMS2_BRANCH( std::vector<float>, gsftrks_etaErr )
+CMS2_BRANCH( std::vector<int>, gsftrks_exp_innerlayers )
+CMS2_BRANCH( std::vector<LorentzVector>, gsftrks_p4 )
+CMS2_BRANCH( std::vector<float>, gsftrks_phiErr )
+CMS2_BRANCH( std::vector<float>, gsftrks_ptErr )
+CMS2_BRANCH( std::vector<int>, gsftrks_validHits )
+CMS2_BRANCH( std::vector<LorentzVector>, gsftrks_vertex_p4 )
+CMS2_BRANCH( std::vector<float>, gsftrks_z0 )
+CMS2_BRANCH( std::vector<float>, gsftrks_z0Err )
+CMS2_BRANCH( float, hcalnoise_isolatedNoiseSumE )
+CMS2_BRANCH( float, hcalnoise_isolatedNoiseSumEt )
+CMS2_BRANCH( float, hcalnoise_max25GeVHitTime )
+CMS2_BRANCH( float, hcalnoise_maxE2Over10TS )
+CMS2_BRANCH( int, hcalnoise_maxHPDHits )
+CMS2_BRANCH( int, hcalnoise_maxHPDNoOtherHits )
+CMS2_BRANCH( int, hcalnoise_maxRBXHits )
+CMS2_BRANCH( int, hcalnoise_maxZeros )
+CMS2_BRANCH( float, hcalnoise_min25GeVHitTime )
+CMS2_BRANCH( float, hcalnoise_minE2Over10TS )
+CMS2_BRANCH( float, hcalnoise_minRBXEMF )
+CMS2_BRANCH( int, hcalnoise_numIsolatedNoiseChannels )
+CMS2_BRANCH( std::vector<unsigned int>, hlt_prescales )
+CMS2_BRANCH( std::vector<TString>, hlt_trigNames )
+CMS2_BRANCH( std::vector<std::vector<int> >, hlt_trigObjs_id )
+CMS2_BRANCH( std::vector<std::vector<LorentzVector> >, hlt_trigObjs_p4 )
+CMS2_BRANCH( std::vector<int>, hyp_ll_id )
+CMS2_BRANCH( std::vector<int>, hyp_ll_index )
+CMS2_BRANCH( std::vector<LorentzVector>, hyp_ll_p4 )
+CMS2_BRANCH( std::vector<int>, hyp_lt_id )
+CMS2_BRANCH( std::vector<int>, hyp_lt_index )
+CMS2_BRANCH( std::vector<LorentzVector>, hyp_lt_p4 )
+CMS2_BRANCH( std::vector<LorentzVector>, hyp_p4 )
+CMS2_BRANCH( std::vector<int>, hyp_type )
+CMS2_BRANCH( std::vector<float>, jets_combinedSecondaryVertexBJetTag )
+CMS2_BRANCH( std::vector<float>, jets_cor )
+CMS2_BRANCH( std::vector<float>, jets_emFrac )
+CMS2_BRANCH( std::vector<float>, jets_fHPD )
+CMS2_BRANCH( std::vector<int>, jets_n90Hits )
+CMS2_BRANCH( std::vector<LorentzVector>, jets_p4 )
+CMS2_BRANCH( std::vector<float>, jets_simpleSecondaryVertexHighEffBJetTag )
+CMS2_BRANCH( std::vector<float>, jets_simpleSecondaryVertexHighPurBJetTags )
+CMS2_BRANCH( std::vector<float>, jets_trackCountingHighEffBJetTag )
+CMS2_BRANCH( std::vector<float>, jets_trackCountingHighPurBJetTag )
+CMS2_BRANCH( std::vector<unsigned int>, l1_prescales )
+CMS2_BRANCH( unsigned int, l1_techbits1 )
+CMS2_BRANCH( unsigned int, l1_techbits2 )
+CMS2_BRANCH( std::vector<TString>, l1_trigNames )
+CMS2_BRANCH( std::vector<int>, mus_charge )
+CMS2_BRANCH( std::vector<float>, mus_d0 )
+CMS2_BRANCH( std::vector<float>, mus_d0corr )
+CMS2_BRANCH( std::vector<float>, mus_gfit_chi2 )
+CMS2_BRANCH( std::vector<float>, mus_gfit_ndof )
+CMS2_BRANCH( std::vector<LorentzVector>, mus_gfit_p4 )
+CMS2_BRANCH( std::vector<int>, mus_gfit_validSTAHits )
+CMS2_BRANCH( std::vector<float>, mus_iso03_emEt )
+CMS2_BRANCH( std::vector<float>, mus_iso03_hadEt )
+CMS2_BRANCH( std::vector<float>, mus_iso03_pf )
+CMS2_BRANCH( std::vector<float>, mus_iso03_sumPt )
+CMS2_BRANCH( std::vector<float>, mus_iso04_pf )
+CMS2_BRANCH( std::vector<float>, mus_isoR03_pf_ChargedHadronPt )
+CMS2_BRANCH( std::vector<float>, mus_isoR03_pf_NeutralHadronEt )
+CMS2_BRANCH( std::vector<float>, mus_isoR03_pf_PUPt )
+CMS2_BRANCH( std::vector<float>, mus_isoR03_pf_PhotonEt )
+CMS2_BRANCH( std::vector<float>, mus_iso_ecalvetoDep )
+CMS2_BRANCH( std::vector<float>, mus_iso_hcalvetoDep )
+CMS2_BRANCH( std::vector<int>, mus_mc3_id )
+CMS2_BRANCH( std::vector<int>, mus_mc3_motherid )
+CMS2_BRANCH( std::vector<int>, mus_mc_id )
+CMS2_BRANCH( std::vector<int>, mus_mc_motherid )
+CMS2_BRANCH( std::vector<LorentzVector>, mus_mc_p4 )
+CMS2_BRANCH( std::vector<float>, mus_met_deltax )
+CMS2_BRANCH( std::vector<float>, mus_met_deltay )
+CMS2_BRANCH( std::vector<int>, mus_met_flag )
+CMS2_BRANCH( std::vector<int>, mus_nmatches )
+CMS2_BRANCH( std::vector<int>, mus_numberOfMatchedStations )
+CMS2_BRANCH( std::vector<LorentzVector>, mus_p4 )
+CMS2_BRANCH( std::vector<int>, mus_pfmusidx )
+CMS2_BRANCH( std::vector<int>, mus_pid_PFMuon )
+CMS2_BRANCH( std::vector<int>, mus_pid_TMLastStationTight )
+CMS2_BRANCH( std::vector<float>, mus_ptErr )
+CMS2_BRANCH( std::vector<LorentzVector>, mus_sta_p4 )
+CMS2_BRANCH( std::vector<float>, mus_sta_z0corr )
+CMS2_BRANCH( std::vector<float>, mus_tcmet_deltax )
+CMS2_BRANCH( std::vector<float>, mus_tcmet_deltay )
+CMS2_BRANCH( std::vector<int>, mus_tcmet_flag )
+CMS2_BRANCH( std::vector<LorentzVector>, mus_trk_p4 )
+CMS2_BRANCH( std::vector<int>, mus_trkidx )
+CMS2_BRANCH( std::vector<int>, mus_type )
+CMS2_BRANCH( std::vector<int>, mus_validHits )
+CMS2_BRANCH( std::vector<LorentzVector>, mus_vertex_p4 )
+CMS2_BRANCH( std::vector<float>, mus_z0corr )
+CMS2_BRANCH( std::vector<int>, pfcands_charge )
+CMS2_BRANCH( std::vector<LorentzVector>, pfcands_p4 )
+CMS2_BRANCH( std::vector<int>, pfcands_particleId )
+CMS2_BRANCH( std::vector<int>, pfcands_pfelsidx )
+CMS2_BRANCH( std::vector<int>, pfcands_pfmusidx )
+CMS2_BRANCH( std::vector<int>, pfcands_trkidx )
+CMS2_BRANCH( std::vector<int>, pfcands_vtxidx )
+CMS2_BRANCH( std::vector<int>, pfels_elsidx )
+CMS2_BRANCH( std::vector<float>, pfjets_area )
+CMS2_BRANCH( std::vector<float>, pfjets_chargedEmE )
+CMS2_BRANCH( std::vector<float>, pfjets_chargedHadronE )
+CMS2_BRANCH( std::vector<int>, pfjets_chargedHadronMultiplicity )
+CMS2_BRANCH( std::vector<int>, pfjets_chargedMultiplicity )
+CMS2_BRANCH( std::vector<float>, pfjets_combinedSecondaryVertexBJetTag )
+CMS2_BRANCH( std::vector<float>, pfjets_cor )
+CMS2_BRANCH( std::vector<float>, pfjets_corL1FastL2L3 )
+CMS2_BRANCH( std::vector<float>, pfjets_corL1FastL2L3residual )
+CMS2_BRANCH( std::vector<int>, pfjets_mcflavorAlgo )
+CMS2_BRANCH( std::vector<int>, pfjets_mcflavorPhys )
+CMS2_BRANCH( std::vector<float>, pfjets_neutralEmE )
+CMS2_BRANCH( std::vector<float>, pfjets_neutralHadronE )
+CMS2_BRANCH( std::vector<int>, pfjets_neutralHadronMultiplicity )
+CMS2_BRANCH( std::vector<int>, pfjets_neutralMultiplicity )
+CMS2_BRANCH( std::vector<LorentzVector>, pfjets_p4 )
+CMS2_BRANCH( std::vector<std::vector<int> >, pfjets_pfcandIndicies )
+CMS2_BRANCH( std::vector<int>, pfjets_photonMultiplicity )
+CMS2_BRANCH( std::vector<float>, pfjets_simpleSecondaryVertexHighEffBJetTag )
+CMS2_BRANCH( std::vector<float>, pfjets_simpleSecondaryVertexHighPurBJetTags )
+CMS2_BRANCH( std::vector<float>, pfjets_trackCountingHighEffBJetTag )
+CMS2_BRANCH( std::vector<float>, pfjets_trackCountingHighPurBJetTag )
+CMS2_BRANCH( std::vector<int>, pfmus_musidx )
+CMS2_BRANCH( std::vector<LorentzVector>, pfmus_p4 )
+CMS2_BRANCH( std::vector<float>, photons_ecalIso03 )
+CMS2_BRANCH( std::vector<float>, photons_ecalIso04 )
+CMS2_BRANCH( std::vector<float>, photons_hOverE )
+CMS2_BRANCH( std::vector<int>, photons_haspixelSeed )
+CMS2_BRANCH( std::vector<float>, photons_hcalIso03 )
+CMS2_BRANCH( std::vector<float>, photons_hcalIso04 )
+CMS2_BRANCH( std::vector<LorentzVector>, photons_p4 )
+CMS2_BRANCH( std::vector<int>, photons_scindex )
+CMS2_BRANCH( std::vector<float>, photons_sigmaIEtaIEta )
+CMS2_BRANCH( std::vector<float>, photons_tkIsoHollow )
+CMS2_BRANCH( std::vector<float>, photons_tkIsoHollow04 )
+CMS2_BRANCH( std::vector<float>, scs_e1x3 )
+CMS2_BRANCH( std::vector<float>, scs_e3x1 )
+CMS2_BRANCH( std::vector<float>, scs_eMax )
+CMS2_BRANCH( std::vector<LorentzVector>, scs_pos_p4 )
+CMS2_BRANCH( std::vector<float>, scs_sigmaIPhiIPhi )
+CMS2_BRANCH( std::vector<int>, trks_algo )
+CMS2_BRANCH( std::vector<int>, trks_charge )
+CMS2_BRANCH( std::vector<float>, trks_chi2 )
+CMS2_BRANCH( std::vector<float>, trks_d0 )
+CMS2_BRANCH( std::vector<float>, trks_d0Err )
+CMS2_BRANCH( std::vector<float>, trks_d0corr )
+CMS2_BRANCH( std::vector<float>, trks_d0phiCov )
+CMS2_BRANCH( std::vector<float>, trks_d0vtx )
+CMS2_BRANCH( std::vector<float>, trks_etaErr )
+CMS2_BRANCH( std::vector<int>, trks_exp_innerlayers )
+CMS2_BRANCH( std::vector<float>, trks_ndof )
+CMS2_BRANCH( std::vector<int>, trks_nlayers )
+CMS2_BRANCH( std::vector<LorentzVector>, trks_outer_p4 )
+CMS2_BRANCH( std::vector<float>, trks_phiErr )
+CMS2_BRANCH( std::vector<float>, trks_ptErr )
+CMS2_BRANCH( std::vector<int>, trks_qualityMask )
+CMS2_BRANCH( std::vector<LorentzVector>, trks_trk_p4 )
+CMS2_BRANCH( std::vector<int>, trks_validHits )
+CMS2_BRANCH( std::vector<int>, trks_valid_pixelhits )
+CMS2_BRANCH( std::vector<LorentzVector>, trks_vertex_p4 )
+CMS2_BRANCH( std::vector<float>, trks_z0 )
+CMS2_BRANCH( std::vector<float>, trks_z0Err )
+CMS2_BRANCH( std::vector<float>, twrs_emEnergy )
+CMS2_BRANCH( std::vector<float>, twrs_emEt )
+CMS2_BRANCH( std::vector<float>, twrs_emThresh )
+CMS2_BRANCH( std::vector<float>, twrs_eta )
+CMS2_BRANCH( std::vector<float>, twrs_hadEt )
+CMS2_BRANCH( std::vector<float>, twrs_phi )
+CMS2_BRANCH( std::vector<std::vector<float> >, vtxs_covMatrix )
+CMS2_BRANCH( std::vector<int>, vtxs_isFake )
+CMS2_BRANCH( std::vector<float>, vtxs_ndof )
+CMS2_BRANCH( std::vector<LorentzVector>, vtxs_position )
+CMS2_BRANCH( std::vector<float>, vtxs_sumpt )
+CMS2_BRANCH( std::vector<float>, vtxs_xError )
+CMS2_BRANCH( std::vector<float>, vtxs_yError )
+CMS2_BRANCH( std::vector<float>, vtxs_zError )
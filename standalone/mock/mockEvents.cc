@@ -0,0 +1,724 @@
+#include "mockEvents.h"
+#include "CMS2.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+const char* const mockHLTNames[] = {
+    "HLT_Mu17_Mu8_v16",
+    "HLT_Mu17_TkMu8_v9",
+    "HLT_Ele17_CaloIdT_CaloIsoVL_TrkIdVL_TrkIsoVL_Ele8_CaloIdT_CaloIsoVL_TrkIdVL_TrkIsoVL_v17",
+    "HLT_Mu17_Ele8_CaloIdT_CaloIsoVL_TrkIdVL_TrkIsoVL_v7",
+    "HLT_Mu8_Ele17_CaloIdT_CaloIsoVL_TrkIdVL_TrkIsoVL_v7",
+    "HLT_IsoMu24_eta2p1_v13",
+    "HLT_Ele27_WP80_v11",
+    "HLT_Mu8_v16",
+    "HLT_Ele8_CaloIdT_TrkIdVL_v5",
+    "HLT_PFJet40_v5"
+};
+const unsigned int nMockHLT = sizeof(mockHLTNames) / sizeof(mockHLTNames[0]);
+const unsigned int nUnprescaledMockHLT = 7;
+
+namespace {
+
+    const double pi = 3.14159265358979323846;
+
+    const char* const l1Names[] = {
+        "L1_DoubleMu_10_Open",
+        "L1_SingleEG22",
+        "L1_Mu12_EG7",
+        "L1_SingleJet16"
+    };
+    const unsigned int nL1 = sizeof(l1Names) / sizeof(l1Names[0]);
+
+    // trigger object ids, as in the ntuples
+    const int TRIGGER_ELECTRON = 82;
+    const int TRIGGER_MUON     = 83;
+    const int TRIGGER_JET      = 85;
+
+    LorentzVector makeP4(double pt, double eta, double phi, double mass) {
+        double px = pt * cos(phi);
+        double py = pt * sin(phi);
+        double pz = pt * sinh(eta);
+        return LorentzVector(px, py, pz, sqrt(px*px + py*py + pz*pz + mass*mass));
+    }
+
+    LorentzVector position(double x, double y, double z) {
+        return LorentzVector(x, y, z, 0.);
+    }
+
+    // transverse impact parameter, with respect to the origin, of a
+    // track of direction phi from (x, y)
+    float impact(const LorentzVector& vtx, double phi) {
+        return vtx.x() * sin(phi) - vtx.y() * cos(phi);
+    }
+
+    struct Lepton {
+        LorentzVector p4;
+        int  id;        // signed pdg id
+        bool prompt;    // from a W, else from a jet
+        bool fromTau;
+    };
+
+    struct Jet {
+        LorentzVector p4;   // corrected
+        float cor;
+        float area;
+        int   nCharged;
+        int   nNeutral;
+        int   vtx;
+        int   flavor;
+        std::vector<int> cands;
+    };
+
+    struct HypLepton {
+        int id;
+        int index;
+    };
+
+    bool jetRawPtGreater(const Jet& a, const Jet& b) {
+        return a.p4.pt() / a.cor > b.p4.pt() / b.cor;
+    }
+
+    // sizes of the collections, by the branch prefix
+    struct Sizes {
+        unsigned int els, mus, trks, gsftrks, pfcands, pfjets, vtxs, convs, genps, hyp;
+
+        unsigned int of(const char* branch) const {
+            struct Prefix { const char* name; unsigned int size; };
+            const Prefix prefixes[] = {
+                { "els_", els }, { "pfels_", els }, { "scs_", els },
+                { "mus_", mus }, { "pfmus_", mus }, { "evt35X_mus_", mus },
+                { "trks_", trks }, { "gsftrks_", gsftrks }, { "pfcands_", pfcands },
+                { "pfjets_", pfjets }, { "jets_", pfjets }, { "genjets_", pfjets },
+                { "vtxs_", vtxs }, { "convs_", convs }, { "genps_", genps },
+                { "hyp_", hyp }, { "hlt_", nMockHLT }, { "l1_", nL1 }
+            };
+            for (unsigned int i = 0; i < sizeof(prefixes) / sizeof(prefixes[0]); i++) {
+                if (strncmp(branch, prefixes[i].name, strlen(prefixes[i].name)) == 0)
+                    return prefixes[i].size;
+            }
+            return 0;
+        }
+    };
+
+    // sizes the branches left empty by fillCMS2
+    void sizeBranch(std::vector<float>& branch, unsigned int n, SyntheticRandom& rnd) {
+        if (!branch.empty())
+            return;
+        branch.resize(n);
+        for (unsigned int i = 0; i < n; i++)
+            branch[i] = rnd.uniform();
+    }
+
+    template <class T> void sizeBranch(std::vector<T>& branch, unsigned int n, SyntheticRandom&) {
+        if (branch.empty())
+            branch.resize(n);
+    }
+
+    template <class T> void sizeBranch(T&, unsigned int, SyntheticRandom&) {}
+
+    void addTrack(const LorentzVector& p4, int charge, const LorentzVector& vtx, SyntheticRandom& rnd) {
+        float phi = p4.phi();
+        cms2.trks_trk_p4().push_back(p4);
+        cms2.trks_vertex_p4().push_back(position(vtx.x(), vtx.y(), vtx.z() + rnd.gaussian(0., 0.01)));
+        cms2.trks_outer_p4().push_back(p4);
+        cms2.trks_charge().push_back(charge);
+        cms2.trks_d0().push_back(impact(vtx, phi) + rnd.gaussian(0., 0.002));
+        cms2.trks_d0corr().push_back(rnd.gaussian(0., 0.002));
+        cms2.trks_d0vtx().push_back(rnd.gaussian(0., 0.002));
+        cms2.trks_z0().push_back(vtx.z() + rnd.gaussian(0., 0.01));
+        cms2.trks_d0Err().push_back(0.002 + 0.01 / p4.pt());
+        cms2.trks_z0Err().push_back(0.003 + 0.01 / p4.pt());
+        cms2.trks_ptErr().push_back(p4.pt() * (0.01 + 0.0002 * p4.pt()));
+        cms2.trks_etaErr().push_back(0.001);
+        cms2.trks_phiErr().push_back(0.001);
+        cms2.trks_d0phiCov().push_back(-1e-6);
+        cms2.trks_qualityMask().push_back(rnd.uniform() < 0.9 ? 4 : 0);    // highPurity
+        cms2.trks_validHits().push_back(8 + rnd.poisson(6.));
+        cms2.trks_valid_pixelhits().push_back(1 + rnd.poisson(2.));
+        cms2.trks_exp_innerlayers().push_back(rnd.uniform() < 0.05 ? 1 : 0);
+        cms2.trks_nlayers().push_back(6 + rnd.poisson(4.));
+        cms2.trks_ndof().push_back(10 + rnd.poisson(8.));
+        cms2.trks_chi2().push_back(cms2.trks_ndof().back() * rnd.uniform(0.5, 2.));
+        cms2.trks_algo().push_back(4 + rnd.poisson(1.5));
+    }
+
+    // a PF candidate; charged ones get a track unless given one
+    void addCandidate(const LorentzVector& p4, int particleId, int charge, int vtx, SyntheticRandom& rnd, int trkidx = -1) {
+        cms2.pfcands_p4().push_back(p4);
+        cms2.pfcands_particleId().push_back(particleId);
+        cms2.pfcands_charge().push_back(charge);
+        cms2.pfcands_pfelsidx().push_back(-1);
+        cms2.pfcands_pfmusidx().push_back(-1);
+        if (charge != 0) {
+            if (trkidx < 0) {
+                trkidx = cms2.trks_trk_p4().size();
+                addTrack(p4, charge, cms2.vtxs_position()[vtx], rnd);
+            }
+            cms2.pfcands_trkidx().push_back(trkidx);
+            cms2.pfcands_vtxidx().push_back(vtx);
+        } else {
+            cms2.pfcands_trkidx().push_back(-1);
+            cms2.pfcands_vtxidx().push_back(-9999);
+        }
+    }
+
+    void fillVertices(const SyntheticEvent& evt, SyntheticRandom& rnd) {
+        for (int ivtx = 0; ivtx < evt.nvtx; ivtx++) {
+            // a few fail the vertex selection
+            double rho = rnd.uniform() < 0.02 ? 2.5 : fabs(rnd.gaussian(0., 0.02));
+            double phi = rnd.uniform(-pi, pi);
+            cms2.vtxs_position().push_back(position(0.07 + rho * cos(phi), 0.06 + rho * sin(phi), rnd.gaussian(0., 5.)));
+            cms2.vtxs_isFake().push_back(0);
+            cms2.vtxs_ndof().push_back(ivtx == 0 ? 60. + rnd.exponential(40.) : rnd.exponential(20.));
+            cms2.vtxs_sumpt().push_back(ivtx == 0 ? 200. + rnd.exponential(100.) : rnd.exponential(20.));
+            cms2.vtxs_xError().push_back(0.002);
+            cms2.vtxs_yError().push_back(0.002);
+            cms2.vtxs_zError().push_back(0.004);
+            std::vector<float> cov(9, 0.);
+            cov[0] = cov[4] = 4e-6;
+            cov[8] = 1.6e-5;
+            cov[1] = cov[3] = 1e-7;
+            cms2.vtxs_covMatrix().push_back(cov);
+        }
+    }
+
+    // the leptons of the event are prompt; jets give some more
+    void makeLeptons(const SyntheticEvent& evt, std::vector<Lepton>& leptons, SyntheticRandom& rnd) {
+        for (unsigned int i = 0; i < evt.leptons.size(); i++) {
+            Lepton lep;
+            lep.p4      = evt.leptons[i];
+            lep.id      = (fabs(lep.p4.M() - 0.105658) < 0.01 ? 13 : 11) * (rnd.uniform() < 0.5 ? 1 : -1);
+            lep.prompt  = true;
+            lep.fromTau = rnd.uniform() < 0.1;
+            leptons.push_back(lep);
+        }
+        for (unsigned int i = 0; i < evt.jets.size(); i++) {
+            const SyntheticJet& jet = evt.jets[i];
+            if (jet.pt < 20. || fabs(jet.eta) > 2.4 || rnd.uniform() > 0.1)
+                continue;
+            Lepton lep;
+            bool muon   = rnd.uniform() < 0.5;
+            lep.p4      = makeP4(jet.pt * rnd.uniform(0.1, 0.4), jet.eta + rnd.gaussian(0., 0.05), jet.phi + rnd.gaussian(0., 0.05), muon ? 0.105658 : 0.000511);
+            lep.id      = (muon ? 13 : 11) * (rnd.uniform() < 0.5 ? 1 : -1);
+            lep.prompt  = false;
+            lep.fromTau = false;
+            leptons.push_back(lep);
+        }
+    }
+
+    void fillElectron(const Lepton& lep, unsigned int iel, SyntheticRandom& rnd) {
+        const LorentzVector& p4 = lep.p4;
+        const LorentzVector& pv = cms2.vtxs_position()[0];
+        int charge = lep.id > 0 ? -1 : 1;
+        float eta = p4.eta(), phi = p4.phi();
+        float etaSC = eta + rnd.gaussian(0., 0.01);
+        bool barrel = fabs(etaSC) < 1.479;
+        float iso = lep.prompt ? 1. : 0.3 * p4.pt();
+
+        cms2.els_p4().push_back(p4);
+        cms2.els_trk_p4().push_back(p4 * rnd.gaussian(1., 0.03));
+        cms2.els_vertex_p4().push_back(position(pv.x(), pv.y(), pv.z() + rnd.gaussian(0., 0.01)));
+        cms2.els_charge().push_back(charge);
+        cms2.els_trk_charge().push_back(charge);
+        cms2.els_sccharge().push_back(rnd.uniform() < 0.97 ? charge : -charge);
+        cms2.els_etaSC().push_back(etaSC);
+        cms2.els_eSC().push_back(p4.E() * rnd.gaussian(1., 0.03));
+        cms2.els_ecalEnergy().push_back(cms2.els_eSC().back());
+        cms2.els_e5x5().push_back(cms2.els_eSC().back() * rnd.uniform(0.85, 1.));
+        cms2.els_e2x5Max().push_back(cms2.els_e5x5().back() * rnd.uniform(0.8, 1.));
+        cms2.els_eOverPIn().push_back(fabs(rnd.gaussian(1., 0.15)));
+        cms2.els_eSeedOverPIn().push_back(fabs(rnd.gaussian(0.9, 0.15)));
+        cms2.els_fbrem().push_back(rnd.uniform(-0.1, 0.7));
+        cms2.els_sigmaIEtaIEta().push_back(fabs(barrel ? rnd.gaussian(0.009, 0.002) : rnd.gaussian(0.026, 0.004)));
+        cms2.els_dEtaIn().push_back(rnd.gaussian(0., 0.004));
+        cms2.els_dPhiIn().push_back(rnd.gaussian(0., 0.03));
+        cms2.els_hOverE().push_back(rnd.exponential(0.03));
+        cms2.els_fiduciality().push_back(1 << (barrel ? 0 : 2));            // ISEB, ISEE
+        cms2.els_type().push_back((1 << 2) | (rnd.uniform() < 0.3 ? 1 << 3 : 0));  // ISECALDRIVEN, ISTRACKERDRIVEN
+        cms2.els_d0().push_back(impact(pv, phi) + rnd.gaussian(0., lep.prompt ? 0.003 : 0.02));
+        cms2.els_d0corr().push_back(rnd.gaussian(0., lep.prompt ? 0.003 : 0.02));
+        cms2.els_mva().push_back(rnd.uniform(-1., 1.));
+        cms2.els_nSeed().push_back(0);
+        cms2.els_closestMuon().push_back(-1);
+        cms2.els_exp_innerlayers().push_back(rnd.uniform() < 0.1 ? 1 : 0);
+        cms2.els_conv_dist().push_back(rnd.gaussian(0., 0.1));
+        cms2.els_conv_dcot().push_back(rnd.gaussian(0., 0.1));
+        cms2.els_conv_old_dist().push_back(cms2.els_conv_dist().back());
+        cms2.els_conv_old_dcot().push_back(cms2.els_conv_dcot().back());
+        cms2.els_trkshFrac().push_back(rnd.uniform(0.5, 1.));
+        cms2.els_scindex().push_back(iel);
+        cms2.scs_pos_p4().push_back(position(129. * cos(phi), 129. * sin(phi), 129. * sinh(etaSC)));
+
+        // detector isolation
+        cms2.els_tkIso().push_back(rnd.exponential(iso));
+        cms2.els_ecalIso().push_back(rnd.exponential(iso));
+        cms2.els_hcalIso().push_back(rnd.exponential(iso));
+        cms2.els_ecalIso04().push_back(cms2.els_ecalIso().back() + rnd.exponential(iso));
+        cms2.els_hcalIso04().push_back(cms2.els_hcalIso().back() + rnd.exponential(iso));
+        cms2.els_iso03_pf().push_back(rnd.exponential(iso));
+        cms2.els_iso04_pf().push_back(cms2.els_iso03_pf().back() + rnd.exponential(iso));
+
+        // the ntuple PF isolation
+        float ch = rnd.exponential(iso), em = rnd.exponential(0.5 * iso), nh = rnd.exponential(0.5 * iso);
+        cms2.els_iso03_pf2012_ch().push_back(ch);
+        cms2.els_iso03_pf2012_em().push_back(em);
+        cms2.els_iso03_pf2012_nh().push_back(nh);
+        cms2.els_iso03_pf2012ext_ch().push_back(ch);
+        cms2.els_iso03_pf2012ext_em().push_back(em);
+        cms2.els_iso03_pf2012ext_nh().push_back(nh);
+        cms2.els_iso04_pf2012_ch().push_back(ch + rnd.exponential(iso));
+        cms2.els_iso04_pf2012_em().push_back(em + rnd.exponential(0.5 * iso));
+        cms2.els_iso04_pf2012_nh().push_back(nh + rnd.exponential(0.5 * iso));
+        cms2.els_iso04_pf2012ext_ch().push_back(cms2.els_iso04_pf2012_ch().back());
+        cms2.els_iso04_pf2012ext_em().push_back(cms2.els_iso04_pf2012_em().back());
+        cms2.els_iso04_pf2012ext_nh().push_back(cms2.els_iso04_pf2012_nh().back());
+
+        // generator match
+        cms2.els_mc_id().push_back(lep.prompt ? lep.id : 211 * charge);
+        cms2.els_mc_motherid().push_back(lep.prompt ? (lep.fromTau ? -15 * charge : 24 * charge) : 511);
+        cms2.els_mc3_id().push_back(lep.prompt ? (lep.fromTau ? -15 * charge : lep.id) : -9999);
+        cms2.els_mc3_motherid().push_back(lep.prompt ? 24 * charge : -9999);
+        cms2.els_mc_p4().push_back(p4);
+
+        // its ctf and gsf tracks
+        cms2.els_trkidx().push_back(cms2.trks_trk_p4().size());
+        addTrack(cms2.els_trk_p4().back(), charge, cms2.els_vertex_p4().back(), rnd);
+        cms2.els_gsftrkidx().push_back(cms2.gsftrks_p4().size());
+        cms2.gsftrks_p4().push_back(cms2.els_trk_p4().back());
+        cms2.gsftrks_vertex_p4().push_back(cms2.els_vertex_p4().back());
+        cms2.gsftrks_charge().push_back(charge);
+        cms2.gsftrks_d0().push_back(cms2.els_d0().back());
+        cms2.gsftrks_z0().push_back(cms2.els_vertex_p4().back().z());
+        cms2.gsftrks_d0Err().push_back(0.003);
+        cms2.gsftrks_z0Err().push_back(0.004);
+        cms2.gsftrks_ptErr().push_back(0.05 * p4.pt());
+        cms2.gsftrks_etaErr().push_back(0.001);
+        cms2.gsftrks_phiErr().push_back(0.001);
+        cms2.gsftrks_d0phiCov().push_back(-1e-6);
+        cms2.gsftrks_validHits().push_back(8 + rnd.poisson(6.));
+        cms2.gsftrks_exp_innerlayers().push_back(cms2.els_exp_innerlayers().back());
+
+        // its PF electron
+        cms2.pfels_elsidx().push_back(iel);
+        addCandidate(p4, lep.id, charge, 0, rnd, cms2.els_trkidx().back());
+        cms2.pfcands_pfelsidx().back() = iel;
+    }
+
+    void fillMuon(const Lepton& lep, unsigned int imu, SyntheticRandom& rnd) {
+        const LorentzVector& p4 = lep.p4;
+        const LorentzVector& pv = cms2.vtxs_position()[0];
+        int charge = lep.id > 0 ? -1 : 1;
+        float iso = lep.prompt ? 1. : 0.3 * p4.pt();
+
+        cms2.mus_p4().push_back(p4);
+        cms2.mus_trk_p4().push_back(p4);
+        cms2.mus_gfit_p4().push_back(p4);
+        cms2.mus_sta_p4().push_back(p4 * rnd.gaussian(1., 0.05));
+        cms2.pfmus_p4().push_back(p4);
+        cms2.mus_vertex_p4().push_back(position(pv.x(), pv.y(), pv.z() + rnd.gaussian(0., 0.01)));
+        cms2.mus_charge().push_back(charge);
+        cms2.mus_type().push_back(rnd.uniform() < 0.95 ? (1 << 1) | (1 << 2) | (1 << 5) : (1 << 2));  // global, tracker, PF
+        cms2.mus_d0().push_back(impact(pv, p4.phi()) + rnd.gaussian(0., lep.prompt ? 0.002 : 0.02));
+        cms2.mus_d0corr().push_back(rnd.gaussian(0., lep.prompt ? 0.002 : 0.02));
+        cms2.mus_z0corr().push_back(rnd.gaussian(0., 0.01));
+        cms2.mus_sta_z0corr().push_back(rnd.gaussian(0., 1.));
+        cms2.mus_gfit_ndof().push_back(20 + rnd.poisson(10.));
+        cms2.mus_gfit_chi2().push_back(cms2.mus_gfit_ndof().back() * rnd.uniform(0.5, 2.));
+        cms2.mus_gfit_validSTAHits().push_back(rnd.poisson(15.));
+        cms2.mus_nmatches().push_back(1 + rnd.poisson(1.5));
+        cms2.mus_numberOfMatchedStations().push_back(1 + rnd.poisson(1.5));
+        cms2.mus_validHits().push_back(8 + rnd.poisson(8.));
+        cms2.mus_ptErr().push_back(0.01 * p4.pt());
+        cms2.mus_pid_PFMuon().push_back(1);
+        cms2.mus_pid_TMLastStationTight().push_back(1);
+        cms2.mus_pfmusidx().push_back(imu);
+        cms2.pfmus_musidx().push_back(imu);
+        cms2.mus_met_flag().push_back(0);
+        cms2.mus_tcmet_flag().push_back(0);
+
+        cms2.mus_iso03_sumPt().push_back(rnd.exponential(iso));
+        cms2.mus_iso03_emEt().push_back(rnd.exponential(iso));
+        cms2.mus_iso03_hadEt().push_back(rnd.exponential(iso));
+        cms2.mus_iso_ecalvetoDep().push_back(rnd.exponential(0.5));
+        cms2.mus_iso_hcalvetoDep().push_back(rnd.exponential(1.));
+        cms2.mus_iso03_pf().push_back(rnd.exponential(iso));
+        cms2.mus_iso04_pf().push_back(cms2.mus_iso03_pf().back() + rnd.exponential(iso));
+        cms2.mus_isoR03_pf_ChargedHadronPt().push_back(rnd.exponential(iso));
+        cms2.mus_isoR03_pf_NeutralHadronEt().push_back(rnd.exponential(0.5 * iso));
+        cms2.mus_isoR03_pf_PhotonEt().push_back(rnd.exponential(0.5 * iso));
+        cms2.mus_isoR03_pf_PUPt().push_back(rnd.exponential(2.));
+
+        cms2.mus_mc_id().push_back(lep.prompt ? lep.id : 211 * charge);
+        cms2.mus_mc_motherid().push_back(lep.prompt ? (lep.fromTau ? -15 * charge : 24 * charge) : 511);
+        cms2.mus_mc3_id().push_back(lep.prompt ? (lep.fromTau ? -15 * charge : lep.id) : -9999);
+        cms2.mus_mc3_motherid().push_back(lep.prompt ? 24 * charge : -9999);
+        cms2.mus_mc_p4().push_back(p4);
+
+        cms2.mus_trkidx().push_back(cms2.trks_trk_p4().size());
+        addCandidate(p4, lep.id, charge, 0, rnd);
+        cms2.pfcands_pfmusidx().back() = imu;
+    }
+
+    // dilepton hypotheses of the leptons above 10 GeV with one above 20
+    void fillHypotheses() {
+        std::vector<HypLepton> leps;
+        for (unsigned int i = 0; i < cms2.els_p4().size(); i++) {
+            HypLepton c = { -11 * cms2.els_charge()[i], (int)i };
+            leps.push_back(c);
+        }
+        for (unsigned int i = 0; i < cms2.mus_p4().size(); i++) {
+            HypLepton c = { -13 * cms2.mus_charge()[i], (int)i };
+            leps.push_back(c);
+        }
+        for (unsigned int i = 0; i < leps.size(); i++) {
+            for (unsigned int j = i + 1; j < leps.size(); j++) {
+                const LorentzVector& p4i = abs(leps[i].id) == 11 ? cms2.els_p4()[leps[i].index] : cms2.mus_p4()[leps[i].index];
+                const LorentzVector& p4j = abs(leps[j].id) == 11 ? cms2.els_p4()[leps[j].index] : cms2.mus_p4()[leps[j].index];
+                if (p4i.pt() < 10. || p4j.pt() < 10. || std::max(p4i.pt(), p4j.pt()) < 20.)
+                    continue;
+                bool ifirst = p4i.pt() > p4j.pt();
+                const HypLepton& lt = ifirst ? leps[i] : leps[j];
+                const HypLepton& ll = ifirst ? leps[j] : leps[i];
+                cms2.hyp_lt_id().push_back(lt.id);
+                cms2.hyp_lt_index().push_back(lt.index);
+                cms2.hyp_lt_p4().push_back(ifirst ? p4i : p4j);
+                cms2.hyp_ll_id().push_back(ll.id);
+                cms2.hyp_ll_index().push_back(ll.index);
+                cms2.hyp_ll_p4().push_back(ifirst ? p4j : p4i);
+                cms2.hyp_p4().push_back(p4i + p4j);
+                bool ltmu = abs(lt.id) == 13, llmu = abs(ll.id) == 13;
+                cms2.hyp_type().push_back(ltmu && llmu ? 0 : (ltmu ? 1 : (llmu ? 2 : 3)));
+            }
+        }
+    }
+
+    // the jets of the event, plus one for each prompt lepton, which
+    // the jet clustering picks up as well
+    void fillJets(const SyntheticEvent& evt, const std::vector<Lepton>& leptons, SyntheticRandom& rnd) {
+        std::vector<Jet> jets;
+        for (unsigned int i = 0; i < evt.jets.size(); i++) {
+            const SyntheticJet& sjet = evt.jets[i];
+            Jet jet;
+            jet.p4       = sjet.p4;
+            jet.cor      = rnd.uniform(1.0, 1.25);
+            jet.area     = sjet.area;
+            jet.nCharged = sjet.nCharged;
+            jet.nNeutral = sjet.nNeutral;
+            jet.vtx      = sjet.pt < 25. && evt.nvtx > 1 && rnd.uniform() < 0.5 ? 1 + (int)(rnd.uniform() * (evt.nvtx - 1)) : 0;
+            jet.flavor   = rnd.uniform() < 0.2 ? 5 : (rnd.uniform() < 0.5 ? 21 : 1 + (int)(rnd.uniform() * 3));
+            jets.push_back(jet);
+        }
+        for (unsigned int i = 0; i < leptons.size(); i++) {
+            if (!leptons[i].prompt || rnd.uniform() > 0.7)
+                continue;
+            Jet jet;
+            jet.p4       = leptons[i].p4 * rnd.uniform(1., 1.2);
+            jet.cor      = rnd.uniform(1.0, 1.1);
+            jet.area     = rnd.gaussian(0.8, 0.08);
+            jet.nCharged = 1 + rnd.poisson(1.);
+            jet.nNeutral = rnd.poisson(1.);
+            jet.vtx      = 0;
+            jet.flavor   = 0;
+            jets.push_back(jet);
+        }
+        std::sort(jets.begin(), jets.end(), jetRawPtGreater);
+
+        for (unsigned int ijet = 0; ijet < jets.size(); ijet++) {
+            Jet& jet = jets[ijet];
+            LorentzVector raw = jet.p4 * (1. / jet.cor);
+            float eta = raw.eta(), phi = raw.phi();
+
+            // constituents: charged hadrons, photons and neutral hadrons
+            // sharing 65%, 25% and 10% of the pt
+            double chpt = 0.65 * raw.pt() / std::max(1, jet.nCharged);
+            int nphotons = (jet.nNeutral + 1) / 2, nneutral = jet.nNeutral - nphotons;
+            for (int i = 0; i < jet.nCharged; i++) {
+                jet.cands.push_back(cms2.pfcands_p4().size());
+                int charge = rnd.uniform() < 0.5 ? 1 : -1;
+                addCandidate(makeP4(chpt * rnd.uniform(0.2, 1.8), eta + rnd.gaussian(0., 0.08), phi + rnd.gaussian(0., 0.08), 0.1396), 211 * charge, charge, jet.vtx, rnd);
+            }
+            for (int i = 0; i < nphotons; i++) {
+                jet.cands.push_back(cms2.pfcands_p4().size());
+                addCandidate(makeP4(0.25 * raw.pt() / nphotons * rnd.uniform(0.2, 1.8), eta + rnd.gaussian(0., 0.1), phi + rnd.gaussian(0., 0.1), 0.), 22, 0, 0, rnd);
+            }
+            for (int i = 0; i < nneutral; i++) {
+                jet.cands.push_back(cms2.pfcands_p4().size());
+                addCandidate(makeP4(0.1 * raw.pt() / nneutral * rnd.uniform(0.2, 1.8), eta + rnd.gaussian(0., 0.1), phi + rnd.gaussian(0., 0.1), 0.), 130, 0, 0, rnd);
+            }
+
+            float energy = raw.E();
+            float chf = rnd.uniform(0.4, 0.75), nef = rnd.uniform(0.1, 0.35), cef = rnd.uniform(0., 0.05);
+            if (fabs(eta) > 2.4 || jet.nCharged == 0)
+                chf = cef = 0.;
+            cms2.pfjets_p4().push_back(raw);
+            cms2.pfjets_cor().push_back(jet.cor);
+            cms2.pfjets_corL1FastL2L3().push_back(jet.cor);
+            cms2.pfjets_corL1FastL2L3residual().push_back(jet.cor * 1.01);
+            cms2.pfjets_area().push_back(jet.area);
+            cms2.pfjets_chargedHadronE().push_back(chf * energy);
+            cms2.pfjets_chargedEmE().push_back(cef * energy);
+            cms2.pfjets_neutralEmE().push_back(nef * energy);
+            cms2.pfjets_neutralHadronE().push_back(std::max(0.f, 1.f - chf - cef - nef) * energy);
+            cms2.pfjets_chargedMultiplicity().push_back(jet.nCharged);
+            cms2.pfjets_chargedHadronMultiplicity().push_back(jet.nCharged);
+            cms2.pfjets_neutralMultiplicity().push_back(jet.nNeutral);
+            cms2.pfjets_photonMultiplicity().push_back(nphotons);
+            cms2.pfjets_neutralHadronMultiplicity().push_back(nneutral);
+            cms2.pfjets_pfcandIndicies().push_back(jet.cands);
+            cms2.pfjets_mcflavorAlgo().push_back(jet.flavor);
+            cms2.pfjets_mcflavorPhys().push_back(jet.flavor);
+            float b = jet.flavor == 5 ? rnd.uniform(0.4, 1.) : rnd.uniform(0., 0.7);
+            cms2.pfjets_combinedSecondaryVertexBJetTag().push_back(b);
+            cms2.pfjets_simpleSecondaryVertexHighEffBJetTag().push_back(4. * b);
+            cms2.pfjets_simpleSecondaryVertexHighPurBJetTags().push_back(4. * b);
+            cms2.pfjets_trackCountingHighEffBJetTag().push_back(8. * b);
+            cms2.pfjets_trackCountingHighPurBJetTag().push_back(6. * b);
+
+            // calo and generator jets on top of the same jets
+            cms2.jets_p4().push_back(raw);
+            cms2.jets_cor().push_back(jet.cor);
+            cms2.jets_emFrac().push_back(rnd.uniform(0.1, 0.9));
+            cms2.jets_fHPD().push_back(rnd.uniform(0.1, 0.9));
+            cms2.jets_n90Hits().push_back(2 + rnd.poisson(8.));
+            cms2.jets_combinedSecondaryVertexBJetTag().push_back(b);
+            cms2.jets_simpleSecondaryVertexHighEffBJetTag().push_back(4. * b);
+            cms2.jets_simpleSecondaryVertexHighPurBJetTags().push_back(4. * b);
+            cms2.jets_trackCountingHighEffBJetTag().push_back(8. * b);
+            cms2.jets_trackCountingHighPurBJetTag().push_back(6. * b);
+            cms2.genjets_p4().push_back(jet.p4 * rnd.gaussian(1., 0.1));
+        }
+    }
+
+    // a conversion for some of the electrons, with the gsf or the
+    // ctf track, and a few from pairs of soft tracks
+    void fillConversions(SyntheticRandom& rnd) {
+        for (unsigned int iel = 0; iel < cms2.els_p4().size(); iel++) {
+            if (rnd.uniform() > 0.3)
+                continue;
+            std::vector<int> tkidx, tkalgo, hits;
+            if (rnd.uniform() < 0.5) {
+                tkidx.push_back(cms2.els_gsftrkidx()[iel]);
+                tkalgo.push_back(29);
+            } else {
+                tkidx.push_back(cms2.els_trkidx()[iel]);
+                tkalgo.push_back(4 + (int)(rnd.uniform() * 5));
+            }
+            tkidx.push_back((int)(rnd.uniform() * cms2.trks_trk_p4().size()));
+            tkalgo.push_back(4 + (int)(rnd.uniform() * 9));
+            hits.push_back(rnd.uniform() < 0.2 ? 1 : 0);
+            hits.push_back(0);
+            cms2.convs_tkidx().push_back(tkidx);
+            cms2.convs_tkalgo().push_back(tkalgo);
+            cms2.convs_nHitsBeforeVtx().push_back(hits);
+        }
+        unsigned int nsoft = rnd.poisson(1.);
+        for (unsigned int i = 0; i < nsoft && cms2.trks_trk_p4().size() > 1; i++) {
+            std::vector<int> tkidx, tkalgo, hits(2, 0);
+            for (unsigned int k = 0; k < 2; k++) {
+                tkidx.push_back((int)(rnd.uniform() * cms2.trks_trk_p4().size()));
+                tkalgo.push_back(4 + (int)(rnd.uniform() * 9));
+            }
+            cms2.convs_tkidx().push_back(tkidx);
+            cms2.convs_tkalgo().push_back(tkalgo);
+            cms2.convs_nHitsBeforeVtx().push_back(hits);
+        }
+        for (unsigned int i = 0; i < cms2.convs_tkidx().size(); i++) {
+            cms2.convs_isConverted().push_back(1);
+            cms2.convs_quality().push_back(rnd.uniform() < 0.6 ? 4 : 0);
+            cms2.convs_ndof().push_back(1 + (int)(rnd.uniform() * 3));
+            cms2.convs_chi2().push_back(rnd.exponential(2.));
+            cms2.convs_dl().push_back(rnd.uniform(-1., 5.));
+        }
+    }
+
+    // a prompt lepton of the mother motherId, through a tau for some,
+    // with its lepton daughters
+    void addGenLepton(const Lepton& lep, int motherId) {
+        const std::vector<LorentzVector> none;
+        int nu = (abs(lep.id) + 1) * (lep.id > 0 ? -1 : 1);
+        cms2.genps_id().push_back(lep.fromTau ? 15 * (lep.id > 0 ? 1 : -1) : lep.id);
+        cms2.genps_id_mother().push_back(motherId);
+        cms2.genps_p4().push_back(lep.p4 * (lep.fromTau ? 1.3 : 1.));
+
+        // the lepton daughters, of the tau for a tau
+        std::vector<int> ids;
+        std::vector<LorentzVector> p4s;
+        ids.push_back(lep.id);
+        p4s.push_back(lep.p4);
+        if (lep.fromTau) {
+            ids.push_back(nu);
+            p4s.push_back(lep.p4 * 0.2);
+        }
+        cms2.genps_lepdaughter_id().push_back(ids);
+        cms2.genps_lepdaughter_p4().push_back(p4s);
+    }
+
+    void addGenParticle(int id, int motherId, const LorentzVector& p4) {
+        cms2.genps_id().push_back(id);
+        cms2.genps_id_mother().push_back(motherId);
+        cms2.genps_p4().push_back(p4);
+        cms2.genps_lepdaughter_id().push_back(std::vector<int>());
+        cms2.genps_lepdaughter_p4().push_back(std::vector<LorentzVector>());
+    }
+
+    // the prompt leptons come from W -> l nu, except in a third of
+    // the events with an opposite-sign same-flavour pair of them,
+    // where the pair comes from a Z; and the b quarks of the b jets
+    void fillGenerator(const std::vector<Lepton>& leptons, SyntheticRandom& rnd) {
+        int z1 = -1, z2 = -1;
+        if (rnd.uniform() < 0.3) {
+            for (unsigned int i = 0; i < leptons.size() && z1 < 0; i++) {
+                for (unsigned int k = i + 1; k < leptons.size() && z1 < 0; k++) {
+                    if (leptons[i].prompt && leptons[k].prompt && leptons[i].id == -leptons[k].id) {
+                        z1 = i;
+                        z2 = k;
+                    }
+                }
+            }
+        }
+        if (z1 >= 0) {
+            addGenParticle(23, 21, leptons[z1].p4 + leptons[z2].p4);
+            addGenLepton(leptons[z1], 23);
+            addGenLepton(leptons[z2], 23);
+        }
+
+        for (unsigned int i = 0; i < leptons.size(); i++) {
+            const Lepton& lep = leptons[i];
+            if (!lep.prompt || int(i) == z1 || int(i) == z2)
+                continue;
+            int wid = lep.id > 0 ? -24 : 24;
+            int nu = (abs(lep.id) + 1) * (lep.id > 0 ? -1 : 1);
+            LorentzVector nup4 = makeP4(rnd.exponential(30.), rnd.gaussian(0., 1.5), rnd.uniform(-pi, pi), 0.);
+            addGenParticle(wid, 6 * (wid > 0 ? 1 : -1), lep.p4 + nup4);
+            addGenLepton(lep, wid);
+            addGenParticle(lep.fromTau ? 16 * (lep.id > 0 ? -1 : 1) : nu, wid, nup4);
+        }
+        for (unsigned int ijet = 0; ijet < cms2.pfjets_p4().size(); ijet++) {
+            if (cms2.pfjets_mcflavorAlgo()[ijet] != 5)
+                continue;
+            int id = rnd.uniform() < 0.5 ? 5 : -5;
+            addGenParticle(id, id > 0 ? 6 : -6, cms2.genjets_p4()[ijet]);
+        }
+        cms2.genps_status().assign(cms2.genps_id().size(), 3);
+    }
+
+    // unprescaled paths fire most of the time, prescaled ones rarely;
+    // the objects of a fired path are its leptons or jets
+    void fillTriggers(SyntheticRandom& rnd) {
+        for (unsigned int itrg = 0; itrg < nMockHLT; itrg++) {
+            TString name(mockHLTNames[itrg]);
+            bool prescaled = itrg >= nUnprescaledMockHLT;
+            bool fired = rnd.uniform() < (prescaled ? 0.1 : 0.6);
+            cms2.hlt_trigNames().push_back(name);
+            cms2.hlt_prescales().push_back(prescaled ? 20 * (itrg - nUnprescaledMockHLT + 1) : 1);
+            cms2.hlt_bits().push_back(fired);
+
+            std::vector<LorentzVector> p4s;
+            std::vector<int> ids;
+            if (fired) {
+                if (name.Contains("Mu")) {
+                    for (unsigned int i = 0; i < cms2.mus_p4().size(); i++) {
+                        p4s.push_back(cms2.mus_p4()[i] * rnd.gaussian(1., 0.02));
+                        ids.push_back(TRIGGER_MUON);
+                    }
+                }
+                if (name.Contains("Ele")) {
+                    for (unsigned int i = 0; i < cms2.els_p4().size(); i++) {
+                        const LorentzVector& p4 = cms2.els_p4()[i];
+                        p4s.push_back(makeP4(p4.pt() * rnd.gaussian(1., 0.03), p4.eta() + rnd.gaussian(0., 0.02), p4.phi() + rnd.gaussian(0., 0.02), 0.));
+                        ids.push_back(TRIGGER_ELECTRON);
+                    }
+                }
+                if (name.Contains("Jet")) {
+                    for (unsigned int i = 0; i < cms2.pfjets_p4().size() && i < 4; i++) {
+                        p4s.push_back(cms2.pfjets_p4()[i]);
+                        ids.push_back(TRIGGER_JET);
+                    }
+                }
+            }
+            cms2.hlt_trigObjs_p4().push_back(p4s);
+            cms2.hlt_trigObjs_id().push_back(ids);
+        }
+        for (unsigned int itrg = 0; itrg < nL1; itrg++) {
+            cms2.l1_trigNames().push_back(TString(l1Names[itrg]));
+            cms2.l1_prescales().push_back(1);
+            cms2.l1_bits().push_back(rnd.uniform() < 0.7);
+        }
+    }
+}
+
+void fillCMS2(const SyntheticEvent& evt, unsigned int run, unsigned int ievent) {
+
+    // seeded by the event number only, see mockEvents.h
+    SyntheticRandom rnd(0x636d733245767473ULL ^ (ievent + 1) * 0x9e3779b97f4a7c15ULL);
+
+    cms2.Clear();
+    cms2.evt_run()       = run;
+    cms2.evt_lumiBlock() = 1 + ievent / 1000;
+    cms2.evt_event()     = ievent;
+    cms2.evt_isRealData() = 0;
+    cms2.evt_dataset().push_back(TString("/Synthetic/CORE-standalone/USER"));
+
+    cms2.evt_rho()                = evt.rho;
+    cms2.evt_ww_rho()             = evt.rho;
+    cms2.evt_ww_rho_vor()         = evt.rho;
+    cms2.evt_kt6pf_foregiso_rho() = evt.rho;
+    cms2.evt_pfmet()    = evt.met;
+    cms2.evt_pfmetPhi() = evt.metPhi;
+    cms2.evt_met()      = evt.met * rnd.gaussian(1., 0.1);
+    cms2.evt_metPhi()   = evt.metPhi + rnd.gaussian(0., 0.05);
+    cms2.evt_sumet()    = 300. + 20. * evt.nvtx + rnd.exponential(200.);
+    cms2.evt_hbheFilter() = 1;
+    cms2.evt_cscTightHaloId() = 0;
+    cms2.filt_ecalLaser() = true;
+    cms2.filt_ecalTP() = true;
+    cms2.filt_eeBadSc() = true;
+    cms2.filt_hcalLaser() = true;
+    cms2.filt_trackingFailure() = true;
+
+    fillVertices(evt, rnd);
+
+    std::vector<Lepton> leptons;
+    makeLeptons(evt, leptons, rnd);
+    for (unsigned int i = 0; i < leptons.size(); i++) {
+        if (abs(leptons[i].id) == 11)
+            fillElectron(leptons[i], cms2.els_p4().size(), rnd);
+        else
+            fillMuon(leptons[i], cms2.mus_p4().size(), rnd);
+    }
+    fillHypotheses();
+    fillJets(evt, leptons, rnd);
+
+    // the soft tracks: as many from the pileup vertices as from the
+    // primary one
+    for (unsigned int i = 0; i < evt.tracks.size(); i++) {
+        const SyntheticTrack& trk = evt.tracks[i];
+        int vtx = rnd.uniform() < 0.5 || evt.nvtx < 2 ? 0 : 1 + (int)(rnd.uniform() * (evt.nvtx - 1));
+        int charge = rnd.uniform() < 0.5 ? 1 : -1;
+        addCandidate(makeP4(trk.pt, trk.eta, rnd.uniform(-pi, pi), 0.1396), 211 * charge, charge, vtx, rnd);
+    }
+
+    fillConversions(rnd);
+    fillGenerator(leptons, rnd);
+    fillTriggers(rnd);
+
+    // everything else gets its size
+    Sizes sizes;
+    sizes.els     = cms2.els_p4().size();
+    sizes.mus     = cms2.mus_p4().size();
+    sizes.trks    = cms2.trks_trk_p4().size();
+    sizes.gsftrks = cms2.gsftrks_p4().size();
+    sizes.pfcands = cms2.pfcands_p4().size();
+    sizes.pfjets  = cms2.pfjets_p4().size();
+    sizes.vtxs    = cms2.vtxs_position().size();
+    sizes.convs   = cms2.convs_tkidx().size();
+    sizes.genps   = cms2.genps_p4().size();
+    sizes.hyp     = cms2.hyp_p4().size();
+#define CMS2_BRANCH(type, name) \
+    sizeBranch(cms2.name(), sizes.of(#name), rnd);
+#include "CMS2Branches.h"
+#undef CMS2_BRANCH
+}
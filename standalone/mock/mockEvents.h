@@ -0,0 +1,33 @@
+#ifndef MOCKEVENTS_H
+#define MOCKEVENTS_H
+
+//---------------------------------------------------------
+// Fills the mock cms2 ( ../CMS2.h ) from a synthetic event,
+// for the CORE paths that read cms2: the leptons become
+// electrons or muons with their tracks, gsf tracks, PF
+// candidates, conversions, trigger objects and generator
+// record, the jets PF jets with their constituents, plus
+// the vertices, the soft tracks and the event variables.
+//
+// The branches that the code below does not set are sized
+// like their collection, with floats drawn in [0, 1) and
+// zero otherwise, so every index into them is valid. The
+// values do not depend on the run number, only on the
+// event and its number, so a regression reference can be
+// replayed with other run numbers.
+//---------------------------------------------------------
+
+#include "../syntheticEvents.h"
+
+// the HLT paths of the mock menu; the first nUnprescaledMockHLT
+// have prescale 1
+extern const char* const mockHLTNames[];
+extern const unsigned int nMockHLT;
+extern const unsigned int nUnprescaledMockHLT;
+
+// clears cms2 and fills it from evt as event number ievent of
+// run run; per-event caches in CORE are refreshed whenever the
+// (run, event) pair changes
+void fillCMS2(const SyntheticEvent& evt, unsigned int run, unsigned int ievent);
+
+#endif
@@ -0,0 +1,1001 @@
+//---------------------------------------------------------
+// Records the per-event outputs of the CORE code on
+// synthetic events into a binary reference file, and replays
+// the same events against a reference to report every value
+// that moved by more than a given number of ULPs ( units in
+// the last place, counted in the precision the value is
+// returned in ). The paths that read cms2 run on the mock
+// cms2 ( mock/mockEvents.h ): electronSelection, the PF
+// isolation, the conversion flags, the trigger matching, the
+// random cone density, the PF jet constituent variables,
+// the effective area and jet resolution lookups, the jet and
+// MET variations and the vetoes and generator truth of the
+// analyses.
+//
+//   coreRegression --record ref.bin [--nevts n --seed s ...]
+//   coreRegression --replay ref.bin [--tolerance name=ulps ...]
+//
+// MT2min and MT2J are also recorded on dilepton ttbar events.
+// The event settings are stored in the reference, so the
+// replay regenerates the same events, which is checked with
+// a hash of the inputs. The exit code is 0 if every channel
+// is within its tolerance, 1 if not and 2 on errors.
+//
+// Built with -DREGRESSION_BASELINE it only uses the interfaces
+// that predate the rewritten versions ( no transverse thrust,
+// no tcMET response table, MT2min as the smallest of the MT2,
+// one cone per isolation call, getJets per variation, the
+// per-hyp trackerMET, the pfjet_ functions ), so that a
+// reference can be recorded on an older checkout. The
+// channels without an older interface ( JetIndices, the JER
+// variations, METSignificance, PFJetMultiplicity ) are then
+// left out.
+//---------------------------------------------------------
+
+#include "syntheticEvents.h"
+#include "CMS2.h"
+#include "mock/mockEvents.h"
+#include "../MT2/MT2.h"
+#include "../Thrust.h"
+#include "../EventShape.h"
+#include "../jetcorr/JetCorrectorParameters.h"
+#include "../jetcorr/FactorizedJetCorrector.h"
+#include "../jetcorr/JetCorrectionUncertainty.h"
+#include "../QuarkGluonTagger/QGLikelihoodCalculator.h"
+#include "../QuarkGluonTagger/QuarkGluonTagger.h"
+#include "../electronSelections.h"
+#include "../muonSelections.h"
+#include "../MITConversionUtilities.h"
+#include "../triggerUtils.h"
+#include "../jetSelections.h"
+#include "../metSelections.h"
+#include "../JetMETUncertainty.h"
+#include "../ssSelections.h"
+#include "../osSelections.h"
+#include "../ttvSelections.h"
+#include "../mcSelections.h"
+#ifndef REGRESSION_BASELINE
+#include "../tcmet/getResponseFunction_fit.icc"
+#include "../metSignificance.h"
+#include "../jetSmearingTools.h"
+#endif
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+namespace {
+
+    const char         fileMagic[8] = { 'C', 'O', 'R', 'E', 'R', 'E', 'G', '1' };
+    const unsigned int maxReported  = 5;   // differences printed per channel
+
+    // the values one function gave, event by event
+    struct Channel {
+        Channel() : isFloat(false), filled(0) {}
+        bool                 isFloat;   // compared and stored as float
+        vector<unsigned int> counts;    // values per event
+        vector<double>       values;
+        unsigned int         filled;
+    };
+
+    class Outputs {
+    public:
+        Outputs() : nEvents_(0) {}
+        void add(const string& name, bool isFloat, double value) {
+            map<string, Channel>::iterator it = channels.find(name);
+            if (it == channels.end()) {
+                it = channels.insert(make_pair(name, Channel())).first;
+                it->second.isFloat = isFloat;
+                it->second.counts.assign(nEvents_, 0);
+            }
+            it->second.values.push_back(isFloat ? double(float(value)) : value);
+        }
+        void endEvent() {
+            for (map<string, Channel>::iterator it = channels.begin(); it != channels.end(); it++) {
+                it->second.counts.push_back(it->second.values.size() - it->second.filled);
+                it->second.filled = it->second.values.size();
+            }
+            nEvents_++;
+        }
+        map<string, Channel> channels;
+    private:
+        unsigned int nEvents_;
+    };
+
+    // FNV-1a over the generated inputs, to be sure that the replay
+    // sees the events the reference was recorded on
+    class InputHash {
+    public:
+        InputHash() : hash_(14695981039346656037ULL) {}
+        void add(float x) {
+            unsigned char bytes[sizeof(float)];
+            memcpy(bytes, &x, sizeof(float));
+            for (unsigned int i = 0; i < sizeof(float); i++) {
+                hash_ ^= bytes[i];
+                hash_ *= 1099511628211ULL;
+            }
+        }
+        void add(const LorentzVector& p4) {
+            add(p4.px()); add(p4.py()); add(p4.pz()); add(p4.E());
+        }
+        unsigned long long value() const { return hash_; }
+    private:
+        unsigned long long hash_;
+    };
+
+    void addHash(InputHash& hash, const vector<SyntheticEvent>& events) {
+        for (unsigned int i = 0; i < events.size(); i++) {
+            const SyntheticEvent& evt = events[i];
+            hash.add(evt.met); hash.add(evt.metPhi); hash.add(evt.rho); hash.add(float(evt.nvtx));
+            for (unsigned int ilep = 0; ilep < evt.leptons.size(); ilep++)
+                hash.add(evt.leptons[ilep]);
+            for (unsigned int ijet = 0; ijet < evt.jets.size(); ijet++) {
+                const SyntheticJet& jet = evt.jets[ijet];
+                hash.add(jet.p4); hash.add(jet.pt); hash.add(jet.eta); hash.add(jet.phi); hash.add(jet.area);
+                hash.add(float(jet.nCharged)); hash.add(float(jet.nNeutral)); hash.add(jet.ptD);
+            }
+            for (unsigned int itrk = 0; itrk < evt.tracks.size(); itrk++) {
+                hash.add(evt.tracks[itrk].pt);
+                hash.add(evt.tracks[itrk].eta);
+            }
+        }
+    }
+
+    unsigned long long inputHash(const vector<SyntheticEvent>& events, const vector<SyntheticEvent>& ttbar) {
+        InputHash hash;
+        addHash(hash, events);
+        addHash(hash, ttbar);
+        return hash.value();
+    }
+
+    //
+    // the functions under test
+    //
+
+    // MT2min over the pairings of each lepton with a different jet
+    double mt2min(const SyntheticEvent& evt, const vector<LorentzVector>& jets, unsigned int npaired) {
+        vector<LorentzVector> v1, v2;
+        for (unsigned int i = 0; i < npaired; i++) {
+            for (unsigned int k = 0; k < npaired; k++) {
+                if (i == k)
+                    continue;
+                v1.push_back(evt.leptons[0] + jets[i]);
+                v2.push_back(evt.leptons[1] + jets[k]);
+            }
+        }
+#ifdef REGRESSION_BASELINE
+        double result = MT2(evt.met, evt.metPhi, v1[0], v2[0]);
+        for (unsigned int i = 1; i < v1.size(); i++)
+            result = min(result, MT2(evt.met, evt.metPhi, v1[i], v2[i]));
+        return result;
+#else
+        return MT2min(evt.met, evt.metPhi, v1, v2);
+#endif
+    }
+
+    //
+    // the functions that read cms2, on the mock filled from each
+    // event. Where a rewrite added an interface, the channel is
+    // computed with it, and with the older one it replaces when
+    // built with -DREGRESSION_BASELINE, so that the replay compares
+    // the two
+    //
+
+    void addP4(Outputs& out, const string& name, const LorentzVector& p4) {
+        out.add(name, true, p4.px());
+        out.add(name, true, p4.py());
+        out.add(name, true, p4.pz());
+        out.add(name, true, p4.E());
+    }
+
+    void addJets(Outputs& out, const string& name, const vector<LorentzVector>& jets) {
+        out.add(name + "_n", false, jets.size());
+        for (unsigned int ijet = 0; ijet < jets.size(); ijet++)
+            addP4(out, name, jets[ijet]);
+    }
+
+    void addIso(Outputs& out, const string& name, const vector<float>& ch, const vector<float>& em, const vector<float>& nh) {
+        for (unsigned int icone = 0; icone < ch.size(); icone++) {
+            out.add(name, true, ch[icone]);
+            out.add(name, true, em[icone]);
+            out.add(name, true, nh[icone]);
+        }
+    }
+
+    void electronIsoPF(vector<float>& ch, vector<float>& em, vector<float>& nh, const vector<float>& cones,
+                       unsigned int iel, bool barrelVetoes) {
+#ifdef REGRESSION_BASELINE
+        ch.resize(cones.size());
+        em.resize(cones.size());
+        nh.resize(cones.size());
+        for (unsigned int icone = 0; icone < cones.size(); icone++)
+            electronIsoValuePF2012(ch[icone], em[icone], nh[icone], cones[icone], iel, 0, barrelVetoes);
+#else
+        electronIsoValuePF2012(ch, em, nh, cones, iel, 0, barrelVetoes);
+#endif
+    }
+
+    void electronIsoPFReco(vector<float>& ch, vector<float>& em, vector<float>& nh, const vector<float>& cones,
+                           const vector<float>& thresholds, unsigned int iel) {
+#ifdef REGRESSION_BASELINE
+        ch.resize(cones.size());
+        em.resize(cones.size());
+        nh.resize(cones.size());
+        for (unsigned int icone = 0; icone < cones.size(); icone++)
+            electronIsoValuePF2012reco(ch[icone], em[icone], nh[icone], cones[icone], iel, 0, thresholds[icone]);
+#else
+        electronIsoValuePF2012reco(ch, em, nh, cones, iel, 0, thresholds);
+#endif
+    }
+
+    void muonIsoPF(vector<float>& ch, vector<float>& em, vector<float>& nh, const vector<float>& cones,
+                   const vector<float>& thresholds, unsigned int imu) {
+#ifdef REGRESSION_BASELINE
+        ch.resize(cones.size());
+        em.resize(cones.size());
+        nh.resize(cones.size());
+        for (unsigned int icone = 0; icone < cones.size(); icone++)
+            muonIsoValuePF2012(ch[icone], em[icone], nh[icone], cones[icone], imu, 0, thresholds[icone]);
+#else
+        muonIsoValuePF2012(ch, em, nh, cones, imu, 0, thresholds);
+#endif
+    }
+
+    // ID bits, conversions and PF isolation of the leptons
+    void addLeptonOutputs(Outputs& out) {
+        vector<float> cones, thresholds, ch, em, nh;
+        cones.push_back(0.3);
+        cones.push_back(0.4);
+        thresholds.push_back(0.5);
+        thresholds.push_back(1.0);
+
+        for (unsigned int iel = 0; iel < cms2.els_p4().size(); iel++) {
+            cuts_t bits = electronSelection(iel);
+            out.add("ElectronSelection", false, (unsigned int)(bits >> 32));
+            out.add("ElectronSelection", false, (unsigned int)(bits & 0xffffffff));
+
+            out.add("MITConversion", false, isMITConversion(iel, 0, 1e-6, 2.0, true, false));
+            out.add("MITConversion", false, isMITConversion(iel, 1, 1e-6, 2.0, false, true));
+
+            electronIsoPF(ch, em, nh, cones, iel, false);
+            addIso(out, "ElectronIsoPF", ch, em, nh);
+            electronIsoPF(ch, em, nh, cones, iel, true);
+            addIso(out, "ElectronIsoPF_vetoes", ch, em, nh);
+            electronIsoPFReco(ch, em, nh, cones, thresholds, iel);
+            addIso(out, "ElectronIsoPFReco", ch, em, nh);
+        }
+
+        for (unsigned int imu = 0; imu < cms2.mus_p4().size(); imu++) {
+            muonIsoPF(ch, em, nh, cones, thresholds, imu);
+            addIso(out, "MuonIsoPF", ch, em, nh);
+        }
+    }
+
+    // the paths of the mock menu, their objects, and the match of
+    // every lepton to every path
+    void addTriggerOutputs(Outputs& out) {
+        for (unsigned int itrg = 0; itrg < nMockHLT; itrg++) {
+            const char* name = mockHLTNames[itrg];
+            out.add("HLTPass", false, passUnprescaledHLTTrigger(name));
+            out.add("HLTPass", false, HLT_prescale(name));
+            int nobjects = nHLTObjects(name);
+            out.add("HLTObjects_n", false, nobjects);
+            for (int iobj = 0; iobj < nobjects; iobj++) {
+                out.add("HLTObjects_id", false, idHLTObject(name, iobj));
+                addP4(out, "HLTObjects", p4HLTObject(name, iobj));
+            }
+            for (unsigned int iel = 0; iel < cms2.els_p4().size(); iel++)
+                out.add("HLTMatch", false, passUnprescaledHLTTrigger(name, cms2.els_p4()[iel]));
+            for (unsigned int imu = 0; imu < cms2.mus_p4().size(); imu++)
+                out.add("HLTMatch", false, passUnprescaledHLTTrigger(name, cms2.mus_p4()[imu]));
+        }
+    }
+
+    // the random cone pt density of the event, and the constituent
+    // statistics and the QG tagger of every PF jet
+    void addPFJetOutputs(Outputs& out, QGLikelihoodCalculator& qgl) {
+        out.add("RandomConeDensity", true, randomConeEventDensity());
+#ifndef REGRESSION_BASELINE
+        vector<int> powers;
+        vector<float> dzcuts;
+        powers.push_back(1);
+        powers.push_back(2);
+        dzcuts.push_back(0.05);
+        dzcuts.push_back(0.1);
+        PFJetConstituentInfo info;
+#endif
+        for (unsigned int ijet = 0; ijet < cms2.pfjets_p4().size(); ijet++) {
+#ifdef REGRESSION_BASELINE
+            out.add("PFJetBeta", true, pfjet_beta(ijet, 1, 0.05, 0));
+            out.add("PFJetBeta", true, pfjet_beta(ijet, 2, 0.1, 0));
+            out.add("PFJetDz", true, jetDz(ijet, 0));
+            out.add("PFJetPtD", true, constituentPtDistribution(ijet));
+            out.add("PFJetLRM", true, getLRM(ijet, 1));
+#else
+            pfjetConstituentInfo(info, ijet, 0, powers, dzcuts, 1);
+            out.add("PFJetBeta", true, info.beta[0]);
+            out.add("PFJetBeta", true, info.beta[1]);
+            out.add("PFJetDz", true, info.dz);
+            out.add("PFJetPtD", true, info.ptD);
+            out.add("PFJetLRM", true, info.lrm);
+            out.add("PFJetMultiplicity", false, info.nCharged);
+            out.add("PFJetMultiplicity", false, info.nNeutral);
+#endif
+            LorentzVector p4 = cms2.pfjets_p4()[ijet] * cms2.pfjets_corL1FastL2L3()[ijet];
+            out.add("QGTagger", true, QGtagger(p4, ijet, &qgl));
+        }
+    }
+
+    // the jets of each hypothesis: the generic getters for every
+    // cleaning, rescale and getJetMetSyst shift, and the same-sign,
+    // opposite-sign and ttV getters with their JES shifts
+    void addJetOutputs(Outputs& out, JetCorrectionUncertainty& jetUnc) {
+        const enum CleaningType cleanings[] = { JETS_CLEAN_HYP_E_MU, JETS_CLEAN_HYP_E, JETS_CLEAN_NONE };
+        const unsigned int ncleanings = sizeof(cleanings) / sizeof(cleanings[0]);
+        const double rescales[] = { 1.0, 1.05, 1.0, 1.0 };
+        const int systFlags[]   = { 0, 0, 1, -1 };
+        const unsigned int nvariations = sizeof(rescales) / sizeof(rescales[0]);
+#ifndef REGRESSION_BASELINE
+        vector<JetVariation> variations;
+        for (unsigned int ivar = 0; ivar < nvariations; ivar++)
+            variations.push_back(JetVariation(systFlags[ivar] ? JETS_VAR_SYST : JETS_VAR_NOMINAL, systFlags[ivar], rescales[ivar]));
+        vector<JetVariation> jes;
+        jes.push_back(JetVariation());
+        jes.push_back(JetVariation(JETS_VAR_JES, 1));
+        jes.push_back(JetVariation(JETS_VAR_JES, -1));
+        vector<JetVariation> ttvSyst;
+        ttvSyst.push_back(JetVariation());
+        ttvSyst.push_back(JetVariation(JETS_VAR_SYST, 1));
+        ttvSyst.push_back(JetVariation(JETS_VAR_SYST, -1));
+        JetVariations result;
+        SelectedJets selected;
+#endif
+
+        for (unsigned int ihyp = 0; ihyp < cms2.hyp_type().size(); ihyp++) {
+            for (unsigned int iclean = 0; iclean < ncleanings; iclean++) {
+#ifdef REGRESSION_BASELINE
+                for (unsigned int ivar = 0; ivar < nvariations; ivar++)
+                    addJets(out, "Jets", getJets(ihyp, true, JETS_TYPE_PF_FAST_CORR, cleanings[iclean], 0.4, 30., 2.5, rescales[ivar], systFlags[ivar]));
+#else
+                getJetVariations(result, variations, ihyp, JETS_TYPE_PF_FAST_CORR, cleanings[iclean], 0.4, 30., 2.5);
+                for (unsigned int ivar = 0; ivar < nvariations; ivar++)
+                    addJets(out, "Jets", result.getJets(ivar, true));
+
+                selectJets(selected, ihyp, JETS_TYPE_PF_FAST_CORR, cleanings[iclean], 0.4, 30., 2.5);
+                selected.sortByPt();
+                out.add("JetIndices_n", false, selected.size());
+                for (unsigned int ijet = 0; ijet < selected.size(); ijet++) {
+                    out.add("JetIndices", false, selected.index(ijet));
+                    out.add("JetIndices_corr", false, selected.corr(ijet));
+                }
+#endif
+            }
+
+            vector<LorentzVector> leptons;
+            leptons.push_back(cms2.hyp_lt_p4()[ihyp]);
+            leptons.push_back(cms2.hyp_ll_p4()[ihyp]);
+#ifdef REGRESSION_BASELINE
+            addJets(out, "SSJets", samesign::getJets(ihyp, JETS_TYPE_PF_FAST_CORR));
+            addJets(out, "SSJets", samesign::getJets(ihyp, &jetUnc, JETS_SCALE_UP, JETS_TYPE_PF_FAST_CORR));
+            addJets(out, "SSJets", samesign::getJets(ihyp, &jetUnc, JETS_SCALE_DOWN, JETS_TYPE_PF_FAST_CORR));
+            addJets(out, "OSJets", os2012::getJets(ihyp, JETS_TYPE_PF_FAST_CORR));
+            addJets(out, "OSJets", os2012::getJets(ihyp, &jetUnc, JETS_SCALE_UP, JETS_TYPE_PF_FAST_CORR));
+            addJets(out, "OSJets", os2012::getJets(ihyp, &jetUnc, JETS_SCALE_DOWN, JETS_TYPE_PF_FAST_CORR));
+            addJets(out, "TTVJets", ttv::getJets(leptons, JETS_TYPE_PF_FAST_CORR));
+            addJets(out, "TTVJets", ttv::getJets(leptons, JETS_TYPE_PF_FAST_CORR, 0.5, 15., 2.4, 1.0, 1));
+            addJets(out, "TTVJets", ttv::getJets(leptons, JETS_TYPE_PF_FAST_CORR, 0.5, 15., 2.4, 1.0, -1));
+#else
+            samesign::getJetVariations(result, jes, ihyp, JETS_TYPE_PF_FAST_CORR, 0.4, 40., 2.4, 20., 20., &jetUnc);
+            for (unsigned int ivar = 0; ivar < jes.size(); ivar++)
+                addJets(out, "SSJets", result.getJets(ivar, true));
+            os2012::getJetVariations(result, jes, ihyp, JETS_TYPE_PF_FAST_CORR, 0.4, 30., 2.4, 20., &jetUnc);
+            for (unsigned int ivar = 0; ivar < jes.size(); ivar++)
+                addJets(out, "OSJets", result.getJets(ivar, true));
+            ttv::getJetVariations(result, ttvSyst, leptons, JETS_TYPE_PF_FAST_CORR);
+            for (unsigned int ivar = 0; ivar < ttvSyst.size(); ivar++)
+                addJets(out, "TTVJets", result.getJets(ivar, true));
+#endif
+        }
+    }
+
+    // trackerMET of every hypothesis, the JetMET variations and the
+    // MET significance of the event
+    void addMETOutputs(Outputs& out, JetMETUncertainty& jetMET) {
+        vector<LorentzVector> jets, goodJets, goodEls, goodMus;
+        for (unsigned int ijet = 0; ijet < cms2.pfjets_p4().size(); ijet++) {
+            LorentzVector p4 = cms2.pfjets_p4()[ijet] * cms2.pfjets_corL1FastL2L3()[ijet];
+            if (p4.pt() > 30. && fabs(p4.eta()) < 2.5)
+                jets.push_back(p4);
+            if (p4.pt() > 10. && fabs(p4.eta()) < 4.7)
+                goodJets.push_back(p4);
+        }
+
+        vector<metStruct> mets, metsNoJets;
+#ifdef REGRESSION_BASELINE
+        for (unsigned int ihyp = 0; ihyp < cms2.hyp_type().size(); ihyp++) {
+            mets.push_back(trackerMET(ihyp, 0.2, &jets));
+            metsNoJets.push_back(trackerMET(ihyp, 0.1));
+        }
+#else
+        vector<int> hyps;
+        for (unsigned int ihyp = 0; ihyp < cms2.hyp_type().size(); ihyp++)
+            hyps.push_back(ihyp);
+        trackerMET(mets, hyps, 0.2, &jets);
+        trackerMET(metsNoJets, hyps, 0.1);
+#endif
+        mets.insert(mets.end(), metsNoJets.begin(), metsNoJets.end());
+        for (unsigned int imet = 0; imet < mets.size(); imet++) {
+            out.add("TrackerMET", true, mets[imet].met);
+            out.add("TrackerMET", true, mets[imet].metphi);
+            out.add("TrackerMET", true, mets[imet].sumet);
+        }
+
+        for (unsigned int iel = 0; iel < cms2.els_p4().size(); iel++) {
+            if (cms2.els_p4()[iel].pt() > 10.)
+                goodEls.push_back(cms2.els_p4()[iel]);
+        }
+        for (unsigned int imu = 0; imu < cms2.mus_p4().size(); imu++) {
+            if (cms2.mus_p4()[imu].pt() > 10.)
+                goodMus.push_back(cms2.mus_p4()[imu]);
+        }
+        jetMET.SetInputParameters(goodEls, goodMus, goodJets);
+        dpair met(cms2.evt_pfmet(), cms2.evt_pfmetPhi());
+        // no JER: before the rewrite its up and down shifts drew their
+        // own smearing
+#ifdef REGRESSION_BASELINE
+        for (int icomp = JetMETUncertainty::ELE; icomp <= JetMETUncertainty::JES; icomp++) {
+            JetMETUncertainty::Component component = JetMETUncertainty::Component(icomp);
+            dpair up = jetMET.GetScaledMET(met, component, JetMETUncertainty::UP);
+            dpair down = jetMET.GetScaledMET(met, component, JetMETUncertainty::DOWN);
+            out.add("JetMETVariations", false, up.first);
+            out.add("JetMETVariations", false, up.second);
+            out.add("JetMETVariations", false, down.first);
+            out.add("JetMETVariations", false, down.second);
+        }
+        dpair total = jetMET.GetTotalUncertainty(met);
+#else
+        JetMETUncertainty::Variations variations = jetMET.GetAllVariations(met);
+        for (int icomp = JetMETUncertainty::ELE; icomp <= JetMETUncertainty::JES; icomp++) {
+            out.add("JetMETVariations", false, variations.up[icomp].first);
+            out.add("JetMETVariations", false, variations.up[icomp].second);
+            out.add("JetMETVariations", false, variations.down[icomp].first);
+            out.add("JetMETVariations", false, variations.down[icomp].second);
+        }
+        dpair total = variations.total;
+#endif
+        out.add("JetMETVariations", false, total.first);
+        out.add("JetMETVariations", false, total.second);
+    }
+
+    // the binned lookups: the effective areas at the electron etas
+    // and the MC jet resolution and JER scale factor at the PF jets
+    float jetResolutionErrPtAt(float pt, float eta) {
+#ifdef REGRESSION_BASELINE
+        return os2012::getErrPt(pt, eta);
+#else
+        return jetResolutionErrPt(pt, eta);
+#endif
+    }
+
+    float jetResolutionScaleAt(float eta) {
+#ifdef REGRESSION_BASELINE
+        return os2012::getJERScale(eta);
+#else
+        return jetResolutionScale(eta);
+#endif
+    }
+
+    void addLookups(Outputs& out, float pt, float eta) {
+        out.add("FastJetEffArea", true, fastJetEffArea03_v1(eta));
+        out.add("FastJetEffArea", true, fastJetEffArea04_v1(eta));
+        out.add("FastJetEffArea", true, fastJetEffArea03_v2(eta));
+        out.add("FastJetEffArea", true, fastJetEffArea04_v2(eta));
+        out.add("JetResolution", true, jetResolutionErrPtAt(pt, eta));
+        out.add("JetResolution", true, jetResolutionScaleAt(eta));
+    }
+
+    // the first event also has the bin edges of both, a step to
+    // either side of them and NaN, with pt = 30
+    void addLookupOutputs(Outputs& out, unsigned int ievt) {
+        for (unsigned int iel = 0; iel < cms2.els_p4().size(); iel++)
+            addLookups(out, cms2.els_p4()[iel].pt(), cms2.els_p4()[iel].eta());
+        for (unsigned int ijet = 0; ijet < cms2.pfjets_p4().size(); ijet++) {
+            LorentzVector p4 = cms2.pfjets_p4()[ijet] * cms2.pfjets_corL1FastL2L3()[ijet];
+            addLookups(out, p4.pt(), p4.eta());
+        }
+        if (ievt != 0)
+            return;
+        const float edges[] = { 0., 0.5, 1.0, 1.1, 1.479, 1.5, 1.7, 2.0, 2.2, 2.3, 2.4, 2.5, 3.0, 5.0 };
+        for (unsigned int iedge = 0; iedge < sizeof(edges) / sizeof(edges[0]); iedge++) {
+            for (int sign = -1; sign <= 1; sign += 2) {
+                addLookups(out, 30., sign * (edges[iedge] - 1e-6f));
+                addLookups(out, 30., sign * edges[iedge]);
+                addLookups(out, 30., sign * (edges[iedge] + 1e-6f));
+            }
+        }
+        addLookups(out, 30., numeric_limits<float>::quiet_NaN());
+    }
+
+#ifndef REGRESSION_BASELINE
+    // JER shifts of the JetMET variations and the MET significance,
+    // which need the jet resolutions
+    void addJetResolutionOutputs(Outputs& out, JetMETUncertainty& jetMETJER, JetSmearer* jetSmearer) {
+        vector<LorentzVector> goodJets, none;
+        vector<int> ijets;
+        vector<float> scales;
+        for (unsigned int ijet = 0; ijet < cms2.pfjets_p4().size(); ijet++) {
+            LorentzVector p4 = cms2.pfjets_p4()[ijet] * cms2.pfjets_corL1FastL2L3()[ijet];
+            if (p4.pt() > 10. && fabs(p4.eta()) < 4.7) {
+                goodJets.push_back(p4);
+                ijets.push_back(ijet);
+                scales.push_back(cms2.pfjets_corL1FastL2L3()[ijet]);
+            }
+        }
+        jetMETJER.SetInputParameters(none, none, goodJets);
+        dpair met(cms2.evt_pfmet(), cms2.evt_pfmetPhi());
+        JetMETUncertainty::Variations variations = jetMETJER.GetAllVariations(met);
+        out.add("JetMETVariations_JER", false, variations.up[JetMETUncertainty::JER].first);
+        out.add("JetMETVariations_JER", false, variations.up[JetMETUncertainty::JER].second);
+        out.add("JetMETVariations_JER", false, variations.down[JetMETUncertainty::JER].first);
+        out.add("JetMETVariations_JER", false, variations.down[JetMETUncertainty::JER].second);
+
+        float metx = cms2.evt_pfmet() * cos(cms2.evt_pfmetPhi());
+        float mety = cms2.evt_pfmet() * sin(cms2.evt_pfmetPhi());
+        out.add("METSignificance", false, getMETSignificance(metx, mety, jetSmearer, ijets, scales));
+    }
+#endif
+
+    // the same-sign lepton vetoes of each hypothesis
+    void addVetoOutputs(Outputs& out) {
+        for (unsigned int ihyp = 0; ihyp < cms2.hyp_type().size(); ihyp++) {
+            out.add("SSVetoes", false, samesign::makesExtraZ(ihyp));
+            out.add("SSVetoes", false, samesign::makesExtraGammaStar(ihyp));
+            out.add("SSVetoes", false, samesign::has3rdLepton(ihyp, 10.));
+            pair<int, int> highest = samesign::highestPtAdditionalLepton(ihyp, 10.);
+            out.add("SSVetoes", false, highest.first);
+            out.add("SSVetoes", false, highest.second);
+            vector<pair<int, int> > additional = samesign::additionalLeptons(ihyp, 5.);
+            out.add("SSAdditionalLeptons_n", false, additional.size());
+            for (unsigned int ilep = 0; ilep < additional.size(); ilep++) {
+                out.add("SSAdditionalLeptons", false, additional[ilep].first);
+                out.add("SSAdditionalLeptons", false, additional[ilep].second);
+            }
+        }
+    }
+
+    // MC truth of the event and of the leptons of each hypothesis
+    void addGenOutputs(Outputs& out) {
+        int nele = 0, nmuon = 0, ntau = 0;
+        // it complains about every other event
+        const vector<int>& ids = cms2.genps_id();
+        if (find(ids.begin(), ids.end(), 23) != ids.end())
+            out.add("GenTruth", false, getDrellYanType());
+        out.add("GenTruth", false, getZZType());
+        out.add("GenTruth", false, genpDileptonType());
+        out.add("GenTruth", false, leptonGenpCount(nele, nmuon, ntau));
+        out.add("GenTruth", false, nele);
+        out.add("GenTruth", false, nmuon);
+        out.add("GenTruth", false, ntau);
+        for (unsigned int ihyp = 0; ihyp < cms2.hyp_type().size(); ihyp++) {
+            int ltIndex = cms2.hyp_lt_index()[ihyp], ltId = cms2.hyp_lt_id()[ihyp];
+            int llIndex = cms2.hyp_ll_index()[ihyp], llId = cms2.hyp_ll_id()[ihyp];
+            out.add("GenLeptonTruth", false, leptonIsFromW(ltIndex, ltId));
+            out.add("GenLeptonTruth", false, leptonIsFromW(llIndex, llId));
+            out.add("GenLeptonTruth", false, leptonIsFromW(ltIndex, ltId, true));
+            out.add("GenLeptonTruth", false, mc3idx_eormu(ltId, ltIndex));
+            out.add("GenLeptonTruth", false, mc3idx_eormu(llId, llIndex));
+            out.add("GenLeptonTruth", false, ttbarconstituents(ihyp));
+        }
+    }
+
+    void computeOutputs(Outputs& out, const vector<SyntheticEvent>& events, const vector<SyntheticEvent>& ttbar, const string& core) {
+
+        vector<JetCorrectorParameters> jecParameters;
+        jecParameters.push_back(JetCorrectorParameters(core + "/jetcorr/data/FT_53_V10_AN1_L1FastJet_AK5PF.txt"));
+        jecParameters.push_back(JetCorrectorParameters(core + "/jetcorr/data/FT_53_V10_AN1_L2Relative_AK5PF.txt"));
+        jecParameters.push_back(JetCorrectorParameters(core + "/jetcorr/data/FT_53_V10_AN1_L3Absolute_AK5PF.txt"));
+        jecParameters.push_back(JetCorrectorParameters(core + "/jetcorr/data/FT_53_V10_AN1_L2L3Residual_AK5PF.txt"));
+        FactorizedJetCorrector jec(jecParameters);
+        JetCorrectionUncertainty jecUncertainty(core + "/jetcorr/data/FT_53_V10_AN1_Uncertainty_AK5PF.txt");
+        QGLikelihoodCalculator qgl(core + "/QuarkGluonTagger/QGTaggerConfig_nCharged_AK5PF.txt",
+                                   core + "/QuarkGluonTagger/QGTaggerConfig_nNeutral_AK5PF.txt",
+                                   core + "/QuarkGluonTagger/QGTaggerConfig_ptD_AK5PF.txt");
+        TMt2 tmt2;
+
+        // the JetMET variations without JER, which the baseline
+        // draws differently, and with it. Set through the setters,
+        // as the constructor leaves the service it is given no
+        // file for unset
+        JetMETUncertainty jetMET;
+        jetMET.SetJetCorrUncFileName(core + "/jetcorr/data/FT_53_V10_AN1_Uncertainty_AK5PF.txt");
+#ifndef REGRESSION_BASELINE
+        vector<string> jetsmearFiles;
+        jetsmearFiles.push_back(core + "/jetsmear/data/Spring10_PtResolution_AK5PF.txt");
+        jetsmearFiles.push_back(core + "/jetsmear/data/Spring10_PhiResolution_AK5PF.txt");
+        jetsmearFiles.push_back(core + "/jetsmear/data/jet_resolutions.txt");
+        JetMETUncertainty jetMETJER;
+        jetMETJER.SetJetSmearFileNames(jetsmearFiles);
+        JetSmearer* jetSmearer = makeJetSmearer(jetsmearFiles);
+#endif
+
+        for (unsigned int ievt = 0; ievt < events.size(); ievt++) {
+
+            const SyntheticEvent& evt = events[ievt];
+            const LorentzVector& lep1 = evt.leptons[0];
+            const LorentzVector& lep2 = evt.leptons[1];
+
+            vector<LorentzVector> jets, objects(evt.leptons);
+            for (unsigned int ijet = 0; ijet < evt.jets.size(); ijet++) {
+                jets.push_back(evt.jets[ijet].p4);
+                objects.push_back(evt.jets[ijet].p4);
+            }
+
+            // MT2
+            out.add("MT2", false, MT2(evt.met, evt.metPhi, lep1, lep2));
+            out.add("MT2_mn50", false, MT2(evt.met, evt.metPhi, lep1, lep2, 50.));
+
+            // each lepton with a different one of the first four jets
+            if (jets.size() >= 2)
+                out.add("MT2min", false, mt2min(evt, jets, jets.size() < 4 ? jets.size() : 4));
+            if (jets.size() >= 2)
+                out.add("MT2J", false, MT2J(evt.met, evt.metPhi, lep1, lep2, jets));
+
+            // the same on a dilepton ttbar event, where the lepton + b
+            // pairings are massive and the MT2 lower bound prunes more
+            const SyntheticEvent& tt = ttbar[ievt];
+            vector<LorentzVector> ttJets;
+            for (unsigned int ijet = 0; ijet < tt.jets.size(); ijet++)
+                ttJets.push_back(tt.jets[ijet].p4);
+            out.add("MT2min_ttbar", false, mt2min(tt, ttJets, ttJets.size()));
+            out.add("MT2J_ttbar", false, MT2J(tt.met, tt.metPhi, tt.leptons[0], tt.leptons[1], ttJets));
+
+            out.add("TMt2", true, tmt2.GetMt2(evt.met, evt.metPhi, lep1, lep2));
+            out.add("TMt2_nu", true, tmt2.Nu1p4().px());
+            out.add("TMt2_nu", true, tmt2.Nu1p4().py());
+            out.add("TMt2_nu", true, tmt2.Nu2p4().px());
+            out.add("TMt2_nu", true, tmt2.Nu2p4().py());
+
+            // event shapes
+            Thrust thrust(objects);
+            out.add("Thrust", false, thrust.thrust());
+            out.add("Thrust_axis", false, thrust.axis().x());
+            out.add("Thrust_axis", false, thrust.axis().y());
+            out.add("Thrust_axis", false, thrust.axis().z());
+#ifndef REGRESSION_BASELINE
+            Thrust thrustTransverse(objects, true);
+            out.add("ThrustTransverse", false, thrustTransverse.thrust());
+            out.add("ThrustTransverse_axis", false, thrustTransverse.axis().x());
+            out.add("ThrustTransverse_axis", false, thrustTransverse.axis().y());
+#endif
+
+            EventShape shape(objects);
+            out.add("Sphericity", false, shape.sphericity());
+            out.add("Aplanarity", false, shape.aplanarity());
+            out.add("Circularity", false, shape.circularity());
+
+            // jets: every level of the correction, the uncertainty
+            // and the QG likelihood
+            for (unsigned int ijet = 0; ijet < evt.jets.size(); ijet++) {
+                const SyntheticJet& jet = evt.jets[ijet];
+                jec.setRho(evt.rho);
+                jec.setJetA(jet.area);
+                jec.setJetPt(jet.pt);
+                jec.setJetEta(jet.eta);
+                vector<float> corrections = jec.getSubCorrections();
+                for (unsigned int ilevel = 0; ilevel < corrections.size(); ilevel++)
+                    out.add("JEC", true, corrections[ilevel]);
+
+                // the uncertainty is binned in corrected pt
+                jecUncertainty.setJetPt(jet.pt * corrections.back());
+                jecUncertainty.setJetEta(jet.eta);
+                out.add("JECUncertainty", true, jecUncertainty.getUncertainty(true));
+
+                out.add("QGL", true, qgl.computeQGLikelihood(jet.pt, evt.rho, jet.nCharged, jet.nNeutral, jet.ptD));
+            }
+
+#ifndef REGRESSION_BASELINE
+            for (unsigned int itrk = 0; itrk < evt.tracks.size(); itrk++)
+                out.add("TcmetResponse", true, getResponseFunction_fit(evt.tracks[itrk].eta, evt.tracks[itrk].pt));
+#endif
+
+            // the functions that read cms2
+            fillCMS2(evt, 1, ievt);
+            addLeptonOutputs(out);
+            addTriggerOutputs(out);
+            addPFJetOutputs(out, qgl);
+            addJetOutputs(out, jecUncertainty);
+            addMETOutputs(out, jetMET);
+#ifndef REGRESSION_BASELINE
+            addJetResolutionOutputs(out, jetMETJER, jetSmearer);
+#endif
+            addLookupOutputs(out, ievt);
+            addVetoOutputs(out);
+            addGenOutputs(out);
+
+            out.endEvent();
+        }
+
+#ifndef REGRESSION_BASELINE
+        delete jetSmearer;
+#endif
+    }
+
+    //
+    // ULP distance
+    //
+
+    const unsigned long long notComparable = ~0ULL;
+
+    // IEEE values ordered as integers: the bit patterns of negative
+    // values are reflected below those of the positive ones, so
+    // that -0 and +0 coincide and neighbours differ by one
+    unsigned long long ulpDistance(double a, double b, bool isFloat) {
+        if (a == b)
+            return 0;
+        if (a != a || b != b)
+            return (a != a && b != b) ? 0 : notComparable;
+        long long ia, ib;
+        if (isFloat) {
+            float fa = a, fb = b;
+            int ja, jb;
+            memcpy(&ja, &fa, sizeof(float));
+            memcpy(&jb, &fb, sizeof(float));
+            ia = ja < 0 ? -(long long)(ja & 0x7fffffff) : ja;
+            ib = jb < 0 ? -(long long)(jb & 0x7fffffff) : jb;
+        } else {
+            memcpy(&ia, &a, sizeof(double));
+            memcpy(&ib, &b, sizeof(double));
+            const long long magnitude = 0x7fffffffffffffffLL;
+            ia = ia < 0 ? -(ia & magnitude) : ia;
+            ib = ib < 0 ? -(ib & magnitude) : ib;
+        }
+        // the difference of two such values can exceed the range of
+        // long long, but not of unsigned long long
+        return ia > ib ? (unsigned long long)ia - (unsigned long long)ib
+                       : (unsigned long long)ib - (unsigned long long)ia;
+    }
+
+    //
+    // reference file
+    //
+
+    struct Header {
+        SyntheticConfig    config;
+        unsigned long long inputHash;
+    };
+
+    template <typename T>
+    void put(FILE* f, const T& x) { fwrite(&x, sizeof(T), 1, f); }
+
+    template <typename T>
+    bool get(FILE* f, T& x) { return fread(&x, sizeof(T), 1, f) == 1; }
+
+    bool writeReference(const string& fileName, const Header& header, const Outputs& out) {
+        FILE* f = fopen(fileName.c_str(), "wb");
+        if (!f)
+            return false;
+        fwrite(fileMagic, 1, sizeof(fileMagic), f);
+        put(f, header.config.seed);
+        put(f, header.config.nEvents);
+        put(f, header.config.pileup);
+        put(f, header.config.nJets);
+        put(f, header.inputHash);
+        put(f, (unsigned int)out.channels.size());
+        for (map<string, Channel>::const_iterator it = out.channels.begin(); it != out.channels.end(); it++) {
+            const Channel& ch = it->second;
+            put(f, (unsigned int)it->first.size());
+            fwrite(it->first.data(), 1, it->first.size(), f);
+            put(f, (unsigned char)ch.isFloat);
+            put(f, (unsigned int)ch.values.size());
+            fwrite(&ch.counts[0], sizeof(unsigned int), ch.counts.size(), f);
+            for (unsigned int i = 0; i < ch.values.size(); i++) {
+                if (ch.isFloat) put(f, float(ch.values[i]));
+                else            put(f, ch.values[i]);
+            }
+        }
+        return fclose(f) == 0;
+    }
+
+    bool readReference(const string& fileName, Header& header, map<string, Channel>& channels) {
+        FILE* f = fopen(fileName.c_str(), "rb");
+        if (!f)
+            return false;
+        char magic[sizeof(fileMagic)];
+        unsigned int nchannels = 0;
+        bool ok = fread(magic, 1, sizeof(magic), f) == sizeof(magic) && memcmp(magic, fileMagic, sizeof(magic)) == 0
+            && get(f, header.config.seed) && get(f, header.config.nEvents)
+            && get(f, header.config.pileup) && get(f, header.config.nJets)
+            && get(f, header.inputHash) && get(f, nchannels) && header.config.nEvents > 0;
+        for (unsigned int ich = 0; ok && ich < nchannels; ich++) {
+            unsigned int length = 0, nvalues = 0;
+            unsigned char isFloat = 0;
+            ok = get(f, length) && length > 0 && length < 1024;
+            string name(length, ' ');
+            ok = ok && fread(&name[0], 1, length, f) == length && get(f, isFloat) && get(f, nvalues);
+            if (!ok)
+                break;
+            Channel& ch = channels[name];
+            ch.isFloat = isFloat;
+            ch.counts.resize(header.config.nEvents);
+            ch.values.resize(nvalues);
+            ok = fread(&ch.counts[0], sizeof(unsigned int), ch.counts.size(), f) == ch.counts.size();
+            for (unsigned int i = 0; ok && i < nvalues; i++) {
+                if (isFloat) {
+                    float x;
+                    ok = get(f, x);
+                    ch.values[i] = x;
+                } else {
+                    ok = get(f, ch.values[i]);
+                }
+            }
+        }
+        fclose(f);
+        return ok;
+    }
+
+    //
+    // comparison
+    //
+
+    // true if the channel is within tolerance
+    bool compareChannel(const string& name, const Channel& ref, const Channel& cur, unsigned long long tolerance) {
+
+        if (ref.isFloat != cur.isFloat || ref.counts != cur.counts) {
+            printf("%-22s values per event differ from the reference\n", name.c_str());
+            return false;
+        }
+
+        unsigned long long maxUlps = 0;
+        unsigned int nfailed = 0, ival = 0;
+        vector<string> reports;
+        for (unsigned int ievt = 0; ievt < ref.counts.size(); ievt++) {
+            for (unsigned int k = 0; k < ref.counts[ievt]; k++, ival++) {
+                unsigned long long ulps = ulpDistance(ref.values[ival], cur.values[ival], ref.isFloat);
+                if (ulps > maxUlps)
+                    maxUlps = ulps;
+                if (ulps <= tolerance)
+                    continue;
+                nfailed++;
+                if (reports.size() < maxReported) {
+                    char line[256];
+                    snprintf(line, sizeof(line), "    event %u value %u: reference %.17g, now %.17g",
+                             ievt, k, ref.values[ival], cur.values[ival]);
+                    reports.push_back(line);
+                }
+            }
+        }
+
+        char ulpsText[32];
+        if (maxUlps == notComparable) snprintf(ulpsText, sizeof(ulpsText), "nan");
+        else                          snprintf(ulpsText, sizeof(ulpsText), "%llu", maxUlps);
+        printf("%-22s %10u %14s %10llu %10u\n", name.c_str(), (unsigned int)ref.values.size(), ulpsText, tolerance, nfailed);
+        for (unsigned int i = 0; i < reports.size(); i++)
+            printf("%s\n", reports[i].c_str());
+        return nfailed == 0;
+    }
+}
+
+//______________________________________________________________________________
+int main(int argc, char** argv)
+{
+    SyntheticConfig config;
+    string core("..");
+    string recordFile, replayFile;
+    map<string, unsigned long long> tolerances;
+    unsigned long long defaultTolerance = 0;
+
+    for (int i = 1; i < argc; i++) {
+        string arg(argv[i]);
+        if (arg == "--help") {
+            cout << "USAGE: coreRegression --record <file> [--nevts <n> --seed <s> --pileup <mean nvtx> --njets <mean njets>]" << endl
+                 << "       coreRegression --replay <file> [--tolerance <channel>=<ulps> ... --tolerance all=<ulps>]" << endl
+                 << "       and --core <CORE dir> for the correction text files" << endl;
+            return 0;
+        }
+        if (i + 1 >= argc) {
+            cerr << "ERROR: option '" << arg << "' needs a value" << endl;
+            return 2;
+        }
+        string value(argv[++i]);
+        stringstream ss(value);
+        if      (arg == "--record") recordFile = value;
+        else if (arg == "--replay") replayFile = value;
+        else if (arg == "--nevts")  ss >> config.nEvents;
+        else if (arg == "--seed")   ss >> config.seed;
+        else if (arg == "--pileup") ss >> config.pileup;
+        else if (arg == "--njets")  ss >> config.nJets;
+        else if (arg == "--core")   core = value;
+        else if (arg == "--tolerance") {
+            size_t eq = value.find('=');
+            unsigned long long ulps = 0;
+            stringstream ulpsStream(eq == string::npos ? "" : value.substr(eq + 1));
+            if (!(ulpsStream >> ulps)) {
+                cerr << "ERROR: tolerance '" << value << "' is not <channel>=<ulps>" << endl;
+                return 2;
+            }
+            if (value.substr(0, eq) == "all") defaultTolerance = ulps;
+            else                              tolerances[value.substr(0, eq)] = ulps;
+        }
+        else {
+            cerr << "ERROR: unknown option '" << arg << "'" << endl;
+            return 2;
+        }
+    }
+    if (recordFile.empty() == replayFile.empty()) {
+        cerr << "ERROR: give one of --record and --replay" << endl;
+        return 2;
+    }
+    if (config.nEvents == 0) {
+        cerr << "ERROR: no events to record" << endl;
+        return 2;
+    }
+
+    Header header;
+    map<string, Channel> reference;
+    if (!replayFile.empty()) {
+        if (!readReference(replayFile, header, reference)) {
+            cerr << "ERROR: cannot read reference '" << replayFile << "'" << endl;
+            return 2;
+        }
+        config = header.config;
+    }
+
+    vector<SyntheticEvent> events, ttbar;
+    generateEvents(events, config);
+    generateTTbarEvents(ttbar, config);
+    unsigned long long hash = inputHash(events, ttbar);
+
+    cout << "events: " << config.nEvents << ", seed: " << config.seed << ", pileup: " << config.pileup
+         << ", njets: " << config.nJets << endl;
+
+    if (!replayFile.empty() && hash != header.inputHash) {
+        cerr << "ERROR: the regenerated events differ from those of the reference" << endl;
+        return 2;
+    }
+
+    Outputs out;
+    computeOutputs(out, events, ttbar, core);
+
+    if (!recordFile.empty()) {
+        header.config = config;
+        header.inputHash = hash;
+        if (!writeReference(recordFile, header, out)) {
+            cerr << "ERROR: cannot write reference '" << recordFile << "'" << endl;
+            return 2;
+        }
+        cout << "recorded " << out.channels.size() << " channels into " << recordFile << endl;
+        return 0;
+    }
+
+    for (map<string, unsigned long long>::const_iterator it = tolerances.begin(); it != tolerances.end(); it++) {
+        if (!reference.count(it->first) && !out.channels.count(it->first))
+            cerr << "WARNING: no channel '" << it->first << "' to apply the tolerance to" << endl;
+    }
+
+    bool passed = true;
+    printf("\n%-22s %10s %14s %10s %10s\n", "channel", "values", "max ulps", "tolerance", "failed");
+    for (map<string, Channel>::const_iterator it = reference.begin(); it != reference.end(); it++) {
+        map<string, Channel>::const_iterator cur = out.channels.find(it->first);
+        if (cur == out.channels.end()) {
+            printf("%-22s not computed by this build\n", it->first.c_str());
+            continue;
+        }
+        map<string, unsigned long long>::const_iterator tol = tolerances.find(it->first);
+        passed &= compareChannel(it->first, it->second, cur->second, tol != tolerances.end() ? tol->second : defaultTolerance);
+    }
+    for (map<string, Channel>::const_iterator it = out.channels.begin(); it != out.channels.end(); it++) {
+        if (!reference.count(it->first))
+            printf("%-22s not in the reference\n", it->first.c_str());
+    }
+
+    cout << endl << (passed ? "PASSED" : "FAILED") << endl;
+    return passed ? 0 : 1;
+}
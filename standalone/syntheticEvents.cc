@@ -0,0 +1,212 @@
+#include "syntheticEvents.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+    const double pi = 3.14159265358979323846;
+
+    LorentzVector makeP4(double pt, double eta, double phi, double mass) {
+        double px = pt * cos(phi);
+        double py = pt * sin(phi);
+        double pz = pt * sinh(eta);
+        return LorentzVector(px, py, pz, sqrt(px*px + py*py + pz*pz + mass*mass));
+    }
+
+    bool jetPtGreater(const SyntheticJet& a, const SyntheticJet& b) {
+        return a.pt > b.pt;
+    }
+
+    // (E, px, py, pz) of a particle of momentum p in the rest frame
+    // of a parent, boosted into the frame the parent p4 is given in
+    void boost(const double parent[4], double parentMass, double p[4]) {
+        double beta[3] = { parent[1] / parent[0], parent[2] / parent[0], parent[3] / parent[0] };
+        double gamma = parent[0] / parentMass;
+        double bp = beta[0] * p[1] + beta[1] * p[2] + beta[2] * p[3];
+        double beta2 = beta[0] * beta[0] + beta[1] * beta[1] + beta[2] * beta[2];
+        double k = beta2 > 0. ? (gamma - 1.) * bp / beta2 + gamma * p[0] : 0.;
+        p[0] = gamma * (p[0] + bp);
+        for (unsigned int i = 0; i < 3; i++)
+            p[i + 1] += k * beta[i];
+    }
+
+    // isotropic two-body decay of a parent of mass m
+    void decay(const double parent[4], double m, double m1, double m2, SyntheticRandom& rnd, double d1[4], double d2[4]) {
+        double p = sqrt(std::max(0., (m*m - (m1 + m2)*(m1 + m2)) * (m*m - (m1 - m2)*(m1 - m2)))) / (2. * m);
+        double cost = rnd.uniform(-1., 1.);
+        double sint = sqrt(1. - cost * cost);
+        double phi = rnd.uniform(-pi, pi);
+        double dir[3] = { sint * cos(phi), sint * sin(phi), cost };
+        d1[0] = sqrt(p*p + m1*m1);
+        d2[0] = sqrt(p*p + m2*m2);
+        for (unsigned int i = 0; i < 3; i++) {
+            d1[i + 1] =  p * dir[i];
+            d2[i + 1] = -p * dir[i];
+        }
+        boost(parent, m, d1);
+        boost(parent, m, d2);
+    }
+
+    LorentzVector toP4(const double p[4]) {
+        return LorentzVector(p[1], p[2], p[3], p[0]);
+    }
+
+    void fillJet(SyntheticJet& jet, const LorentzVector& p4, SyntheticRandom& rnd) {
+        jet.p4       = p4;
+        jet.pt       = p4.pt();
+        jet.eta      = p4.eta();
+        jet.phi      = p4.phi();
+        jet.area     = rnd.gaussian(0.8, 0.08);
+        jet.nCharged = rnd.poisson(4. + jet.pt / 15.);
+        jet.nNeutral = rnd.poisson(3. + jet.pt / 25.);
+        jet.ptD      = rnd.uniform(0.2, 0.9);
+    }
+}
+
+SyntheticRandom::SyntheticRandom(unsigned long long seed)
+    : state_(seed ? seed : 0x9e3779b97f4a7c15ULL) {}
+
+unsigned long long SyntheticRandom::next() {
+    state_ ^= state_ >> 12;
+    state_ ^= state_ << 25;
+    state_ ^= state_ >> 27;
+    return state_ * 0x2545f4914f6cdd1dULL;
+}
+
+double SyntheticRandom::uniform() {
+    return (next() >> 11) * (1. / 9007199254740992.);
+}
+
+double SyntheticRandom::uniform(double lo, double hi) {
+    return lo + (hi - lo) * uniform();
+}
+
+double SyntheticRandom::exponential(double mean) {
+    return -mean * log(1. - uniform());
+}
+
+// Box-Muller, one draw per call so that the sequence does not
+// depend on how the calls are interleaved
+double SyntheticRandom::gaussian(double mean, double sigma) {
+    double u1 = 1. - uniform();
+    double u2 = uniform();
+    return mean + sigma * sqrt(-2. * log(u1)) * cos(2. * pi * u2);
+}
+
+unsigned int SyntheticRandom::poisson(double mean) {
+    if (mean <= 0.)
+        return 0;
+    if (mean > 30.) {
+        double n = floor(gaussian(mean, sqrt(mean)) + 0.5);
+        return n > 0. ? (unsigned int)n : 0;
+    }
+    double limit = exp(-mean), p = uniform();
+    unsigned int n = 0;
+    while (p > limit) {
+        p *= uniform();
+        n++;
+    }
+    return n;
+}
+
+void generateEvents(std::vector<SyntheticEvent>& events, const SyntheticConfig& config) {
+
+    SyntheticRandom rnd(config.seed);
+    events.clear();
+    events.resize(config.nEvents);
+
+    for (unsigned int ievt = 0; ievt < config.nEvents; ievt++) {
+
+        SyntheticEvent& evt = events[ievt];
+
+        evt.nvtx = std::max(1u, rnd.poisson(config.pileup));
+        evt.rho  = std::max(0., rnd.gaussian(1. + 0.55 * evt.nvtx, 1.5));
+        evt.met    = rnd.exponential(40.);
+        evt.metPhi = rnd.uniform(-pi, pi);
+
+        // two leptons, muons or electrons
+        for (unsigned int ilep = 0; ilep < 2; ilep++) {
+            double mass = rnd.uniform() < 0.5 ? 0.105658 : 0.000511;
+            evt.leptons.push_back(makeP4(20. + rnd.exponential(30.), rnd.uniform(-2.4, 2.4), rnd.uniform(-pi, pi), mass));
+        }
+        if (evt.leptons[1].pt() > evt.leptons[0].pt())
+            std::swap(evt.leptons[0], evt.leptons[1]);
+
+        // hard jets plus some from pileup
+        unsigned int njets = rnd.poisson(config.nJets + 0.05 * config.pileup);
+        evt.jets.resize(njets);
+        for (unsigned int ijet = 0; ijet < njets; ijet++) {
+            SyntheticJet& jet = evt.jets[ijet];
+            double eta = rnd.gaussian(0., 2.);
+            if (eta > 4.7 || eta < -4.7)
+                eta = rnd.uniform(-4.7, 4.7);
+            jet.pt       = 10. + rnd.exponential(40.);
+            jet.eta      = eta;
+            jet.phi      = rnd.uniform(-pi, pi);
+            jet.p4       = makeP4(jet.pt, jet.eta, jet.phi, jet.pt * rnd.uniform(0.05, 0.2));
+            jet.area     = rnd.gaussian(0.8, 0.08);
+            jet.nCharged = rnd.poisson(4. + jet.pt / 15.);
+            jet.nNeutral = rnd.poisson(3. + jet.pt / 25.);
+            jet.ptD      = rnd.uniform(0.2, 0.9);
+        }
+        std::sort(evt.jets.begin(), evt.jets.end(), jetPtGreater);
+
+        // mostly soft tracks, a few hard ones; some fall outside
+        // the tracker acceptance
+        unsigned int ntrks = rnd.poisson(15. + 8. * evt.nvtx);
+        evt.tracks.resize(ntrks);
+        for (unsigned int itrk = 0; itrk < ntrks; itrk++) {
+            SyntheticTrack& trk = evt.tracks[itrk];
+            trk.pt  = rnd.uniform() < 0.05 ? rnd.exponential(25.) : 0.3 + rnd.exponential(1.5);
+            trk.eta = rnd.uniform(-2.6, 2.6);
+        }
+    }
+}
+
+void generateTTbarEvents(std::vector<SyntheticEvent>& events, const SyntheticConfig& config) {
+
+    // a stream of its own, so that the generic events do not change
+    SyntheticRandom rnd(config.seed ^ 0x7474626172ULL);
+    events.clear();
+    events.resize(config.nEvents);
+
+    const double mt = 172.5, mw = 80.4, mb = 4.8, ml = 0.105658;
+    for (unsigned int ievt = 0; ievt < config.nEvents; ievt++) {
+
+        SyntheticEvent& evt = events[ievt];
+
+        evt.nvtx = std::max(1u, rnd.poisson(config.pileup));
+        evt.rho  = std::max(0., rnd.gaussian(1. + 0.55 * evt.nvtx, 1.5));
+
+        // t -> b W -> b l nu on both sides
+        double nux = 0., nuy = 0.;
+        for (unsigned int itop = 0; itop < 2; itop++) {
+            LorentzVector top = makeP4(rnd.exponential(70.), rnd.gaussian(0., 1.4), rnd.uniform(-pi, pi), rnd.gaussian(mt, 1.4));
+            double ptop[4] = { top.E(), top.px(), top.py(), top.pz() };
+            double pb[4], pw[4], pl[4], pnu[4];
+            decay(ptop, top.M(), mb, mw, rnd, pb, pw);
+            decay(pw, mw, ml, 0., rnd, pl, pnu);
+            evt.leptons.push_back(toP4(pl));
+            evt.jets.push_back(SyntheticJet());
+            fillJet(evt.jets.back(), toP4(pb) * rnd.gaussian(1., 0.1), rnd);
+            nux += pnu[1];
+            nuy += pnu[2];
+        }
+        if (evt.leptons[1].pt() > evt.leptons[0].pt())
+            std::swap(evt.leptons[0], evt.leptons[1]);
+
+        // MET from the neutrinos with a resolution
+        nux += rnd.gaussian(0., 10.);
+        nuy += rnd.gaussian(0., 10.);
+        evt.met    = sqrt(nux * nux + nuy * nuy);
+        evt.metPhi = atan2(nuy, nux);
+
+        // radiation on top of the b jets
+        unsigned int nisr = rnd.poisson(std::max(0., config.nJets - 2.));
+        for (unsigned int ijet = 0; ijet < nisr; ijet++) {
+            evt.jets.push_back(SyntheticJet());
+            fillJet(evt.jets.back(), makeP4(20. + rnd.exponential(30.), rnd.gaussian(0., 2.), rnd.uniform(-pi, pi), 5.), rnd);
+        }
+        std::sort(evt.jets.begin(), evt.jets.end(), jetPtGreater);
+    }
+}
@@ -0,0 +1,77 @@
+#ifndef SYNTHETICEVENTS_H
+#define SYNTHETICEVENTS_H
+
+//---------------------------------------------------------
+// Synthetic events for the standalone benchmark and
+// regression programs. They feed the CORE code that does
+// not read cms2 directly (MT2, Thrust, EventShape, the
+// jet corrections, the QG likelihood and the tcMET
+// response table), and the mock cms2 for the rest
+// (mock/mockEvents.h), so no ntuple is needed.
+//
+// The generator has its own random number engine, so the
+// same seed gives the same events on any machine and with
+// any ROOT version.
+//---------------------------------------------------------
+
+#include "Math/LorentzVector.h"
+#include <vector>
+
+typedef ROOT::Math::LorentzVector<ROOT::Math::PxPyPzE4D<float> > LorentzVector;
+
+struct SyntheticJet {
+    LorentzVector p4;
+    float pt;
+    float eta;
+    float phi;
+    float area;
+    int   nCharged;
+    int   nNeutral;
+    float ptD;
+};
+
+struct SyntheticTrack {
+    float pt;
+    float eta;
+};
+
+struct SyntheticEvent {
+    std::vector<LorentzVector>  leptons;    // two, leading first
+    std::vector<SyntheticJet>   jets;       // pt ordered
+    std::vector<SyntheticTrack> tracks;
+    float met;
+    float metPhi;
+    float rho;
+    int   nvtx;
+};
+
+struct SyntheticConfig {
+    SyntheticConfig() : seed(12345), nEvents(10000), pileup(20.), nJets(4.) {}
+    unsigned long long seed;
+    unsigned int nEvents;
+    double pileup;        // mean number of vertices
+    double nJets;         // mean jet multiplicity
+};
+
+// xorshift64* (Vigna), enough for filling events
+class SyntheticRandom {
+public:
+    SyntheticRandom(unsigned long long seed);
+    unsigned long long next();
+    double uniform();                          // [0, 1)
+    double uniform(double lo, double hi);
+    double exponential(double mean);
+    double gaussian(double mean, double sigma);
+    unsigned int poisson(double mean);
+private:
+    unsigned long long state_;
+};
+
+void generateEvents(std::vector<SyntheticEvent>& events, const SyntheticConfig& config);
+
+// dilepton ttbar: two leptons, their b jets, radiation and MET
+// from the neutrinos; no tracks. For the paths whose cost
+// depends on the event topology, such as MT2J
+void generateTTbarEvents(std::vector<SyntheticEvent>& events, const SyntheticConfig& config);
+
+#endif
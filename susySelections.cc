@@ -370,25 +370,8 @@ int leptonOrTauIsFromW(int idx, int id, bool alsoSusy) {
     //we have to do some work to trace the parentage
     //to do this, we have to go to the status==3 block because 
     //the daughter info is not in status==1
-    if(abs(st1_motherid)==15) {
-      bool foundelectronneutrino = false; //ensures that the matched electron from a tau really came from a W
-      for(unsigned int i = 0; i < cms2.genps_id().size(); i++) {//status 3 loop
-	if(abs(cms2.genps_id()[i]) == 15 ) { //make sure we get the right tau!
-	  cms2.genps_lepdaughter_id()[i].size(); 
-	  for(unsigned int j = 0; j < cms2.genps_lepdaughter_id()[i].size(); j++) { //loop over the tau's status1 daughters
-	    if(abs(cms2.genps_lepdaughter_id()[i][j]) == 12)
-	      foundelectronneutrino = true;
-	    float dr = ROOT::Math::VectorUtil::DeltaR(cms2.els_mc_p4()[idx], cms2.genps_lepdaughter_p4()[i][j]);
-	    if (dr < 0.0001) { //should be the same exact status==1 gen particle!
-	      st1_motherid = cms2.genps_id_mother()[i];
-	      continue;
-	    }//if (dr < 0.0001)
-	  }//loop over the tau's daughters
-	  if(!foundelectronneutrino)
-	    st1_motherid = -9999;
-	}//tau
-      }//status 3 loop
-    }//if(abs(st1_motherid)==15) {
+    if(abs(st1_motherid)==15)
+      st1_motherid = genTauLeptonMotherId(cms2.els_mc_p4()[idx], 12, st1_motherid);
   } else if (abs(id) == 13) {
     st1_id = cms2.mus_mc_id()[idx];
     st3_id = cms2.mus_mc3_id()[idx];
@@ -398,25 +381,8 @@ int leptonOrTauIsFromW(int idx, int id, bool alsoSusy) {
     //we have to do some work to trace the parentage
     //to do this, we have to go to the status==3 block because 
     //the daughter info is not in status==1
-    if(abs(st1_motherid)==15) {
-      bool foundmuonneutrino = false;
-      for(unsigned int i = 0; i < cms2.genps_id().size(); i++) {//status 3 loop
-	if(abs(cms2.genps_id()[i]) == 15 ) { //make sure we get the right tau!
-	  cms2.genps_lepdaughter_id()[i].size();
-	  for(unsigned int j = 0; j < cms2.genps_lepdaughter_id()[i].size(); j++) {//loop over the tau's status1 daughters
-	    if(abs(cms2.genps_lepdaughter_id()[i][j]) == 14)
-	      foundmuonneutrino = true;
-	    float dr = ROOT::Math::VectorUtil::DeltaR(cms2.mus_mc_p4()[idx], cms2.genps_lepdaughter_p4()[i][j]);
-	    if (dr < 0.0001) { //should be the same exact status==1 gen particle!
- 	      st1_motherid = cms2.genps_id_mother()[i];
-	      continue;
-	    }//if (dr < 0.0001)
-	  }//loop over the tau's daughters
-	  if(!foundmuonneutrino)
-	    st1_motherid = -9999;
-	}//tau
-      }//status 3 loop
-    }//if(abs(st1_motherid)==15) {
+    if(abs(st1_motherid)==15)
+      st1_motherid = genTauLeptonMotherId(cms2.mus_mc_p4()[idx], 14, st1_motherid);
   } else {
     std::cout << "You fool.  Give me +/- 11 or +/- 13 please" << std::endl;
     return false;
@@ -464,21 +430,9 @@ int leptonOrTauIsFromW(int idx, int id, bool alsoSusy) {
 
     //have to find the index of the status3 particle by dR
     //because the indices are buggy
-    unsigned int mc3idx = 999999;
-    LorentzVector lepp4 =  abs(id)==11 ? cms2.els_p4()[idx] : cms2.mus_p4()[idx];
-    double mindR = 9999;
-    for(unsigned int i = 0; i < cms2.genps_id().size(); i++) {
-      float dr = ROOT::Math::VectorUtil::DeltaR(lepp4, cms2.genps_p4()[i]);
-      if(dr < mindR) {
-	mindR = dr;
-	mc3idx = i;
-      }
-    }
-    bool foundElOrMuNu = false;    
-    for(unsigned int i = 0; i < cms2.genps_lepdaughter_p4()[mc3idx].size(); i++) {
-      if(abs(cms2.genps_lepdaughter_id()[mc3idx][i]) == 12 || abs(cms2.genps_lepdaughter_id()[mc3idx][i]) == 14)
-	foundElOrMuNu = true;
-    }
+    unsigned int mc3idx = genNearestIndex(abs(id)==11 ? cms2.els_p4()[idx] : cms2.mus_p4()[idx]);
+    const GenRecordIndex &gen = genRecordIndex();
+    bool foundElOrMuNu = gen.hasNuE.at(mc3idx) || gen.hasNuMu.at(mc3idx);
     if(!foundElOrMuNu) //comes from a hadronic decay of the tau
       return -3;
     //if(id*st3_id > 0) 
@@ -2,6 +2,8 @@
 #include <math.h>
 #include "CMS2.h"
 #include "trackSelections.h"
+#include "utilities.h"
+#include "coreProfiler.h"
 
 // return a pair of d0, d0err of a ctf track with respect to a primary vertex
 std::pair<double, double> trks_d0_pv (int itrk, int ipv)
@@ -151,6 +153,69 @@ std::pair<double, double> gsftrks_dz_pv (int itrk, int ipv)
 }
 
 
+//
+// dz values (without errors) cached per event, one table per vertex and
+// track collection; entries are filled on first use
+//
+namespace {
+
+    struct DzCache {
+        EventTag tag;
+        std::vector<std::vector<float> > values;   // [ipv][itrk]
+        std::vector<std::vector<bool> >  filled;
+    };
+
+    DzCache trks_dzcache;
+    DzCache gsftrks_dzcache;
+
+    bool lookupDz(DzCache &cache, int itrk, int ipv, unsigned int ntrks, float *&value) {
+        if (isNewEvent(cache.tag)) {
+            for (unsigned int i = 0; i < cache.filled.size(); i++)
+                cache.filled[i].assign(cache.filled[i].size(), false);
+        }
+        if (cache.values.size() <= (unsigned int)ipv) {
+            cache.values.resize(ipv + 1);
+            cache.filled.resize(ipv + 1);
+        }
+        if (cache.values[ipv].size() < ntrks) {
+            cache.values[ipv].resize(ntrks);
+            cache.filled[ipv].resize(ntrks, false);
+        }
+        value = &cache.values[ipv].at(itrk);
+        CORE_PROFILE_CACHE("dz_pv_cached", cache.filled[ipv].at(itrk));
+        if (cache.filled[ipv].at(itrk))
+            return true;
+        cache.filled[ipv].at(itrk) = true;
+        return false;
+    }
+}
+
+float trks_dz_pv_cached (int itrk, int ipv)
+{
+    LorentzVector pv = cms2.vtxs_position().at(ipv);
+    float *value = 0;
+    if (lookupDz(trks_dzcache, itrk, ipv, cms2.trks_trk_p4().size(), value))
+        return *value;
+
+    double phi       = cms2.trks_trk_p4().at(itrk).phi();
+    double theta     = cms2.trks_trk_p4().at(itrk).theta();
+    *value = cms2.trks_z0().at(itrk) - pv.z() + (pv.x()*cos(phi) + pv.y()*sin(phi) )*1./tan(theta);
+    return *value;
+}
+
+float gsftrks_dz_pv_cached (int itrk, int ipv)
+{
+    LorentzVector pv = cms2.vtxs_position().at(ipv);
+    float *value = 0;
+    if (lookupDz(gsftrks_dzcache, itrk, ipv, cms2.gsftrks_p4().size(), value))
+        return *value;
+
+    double phi       = cms2.gsftrks_p4().at(itrk).phi();
+    double theta     = cms2.gsftrks_p4().at(itrk).theta();
+    *value = cms2.gsftrks_z0().at(itrk) - pv.z() + (pv.x()*cos(phi) + pv.y()*sin(phi) )*1./tan(theta);
+    return *value;
+}
+
 //----------------------------------------------------------------
 // Simple function that tells you whether or not a track passed 
 // a particular quality flag.
@@ -23,6 +23,10 @@ std::pair<double , double> trks_dz_pv      (int itrk, int ipv);
 std::pair<double , double> gsftrks_dz_pv   (int itrk, int ipv);
 std::pair<double , double> gsftrks_d0_pv   (int itrk, int ipv);
 
+// dz only (the first element of trks_dz_pv and gsftrks_dz_pv), cached per event
+float trks_dz_pv_cached    (int itrk, int ipv);
+float gsftrks_dz_pv_cached (int itrk, int ipv);
+
 bool isTrackQuality( int index, int cuts );
 
 float ctfIsoValuePF(const unsigned int itrk, unsigned int ivtx, float coner = 0.3, float minptn = 1.0, float dzcut = 0.1);
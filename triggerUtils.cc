@@ -6,6 +6,7 @@
 #include "triggerUtils.h"
 #include "CMS2.h"
 #include "Math/VectorUtil.h"
+#include "coreProfiler.h"
 
 using namespace std;
 
@@ -58,6 +59,7 @@ bool goodEGTrigger5July2010 (bool mc) {
 ///----------------------------------------------------
 LorentzVector p4HLTObject(const char* arg, int objNumber){
  
+  CORE_PROFILE_SCOPE("p4HLTObject");
   TString HLTTrigger( arg );
   int trigIndx = -1;
   vector<TString>::const_iterator begin_it = cms2.hlt_trigNames().begin();
@@ -90,6 +92,7 @@ LorentzVector p4HLTObject(const char* arg, int objNumber){
 // trigger id
 int idHLTObject(const char* arg, int objNumber){
 
+  CORE_PROFILE_SCOPE("idHLTObject");
   TString HLTTrigger( arg );
   int trigIndx = -1;
   vector<TString>::const_iterator begin_it = cms2.hlt_trigNames().begin();
@@ -128,6 +131,8 @@ int idHLTObject(const char* arg, int objNumber){
 //--------------------------------------------------------
 int nHLTObjects(const char* arg ){
 
+  CORE_PROFILE_SCOPE("nHLTObjects");
+
   // put the trigger name into a string
   TString HLTTrigger( arg );
 
@@ -179,6 +184,8 @@ void PrintTriggers(){
 //---------------------------------------------
 bool passUnprescaledHLTTrigger(const char* arg){
 
+  CORE_PROFILE_SCOPE("passUnprescaledHLTTrigger");
+
   // put the trigger name into a string
   TString HLTTrigger( arg );
 
@@ -220,6 +227,8 @@ bool passUnprescaledHLTTrigger(const char* arg){
 //---------------------------------------------
 bool passUnprescaledHLTTrigger(const char* arg, const LorentzVector &obj){
 
+  CORE_PROFILE_SCOPE("passUnprescaledHLTTrigger obj");
+
   // put the trigger name into a string
   TString HLTTrigger( arg );
 
@@ -272,6 +281,8 @@ bool passUnprescaledHLTTrigger(const char* arg, const LorentzVector &obj){
 
 int HLT_prescale( const char* arg ){
 
+  CORE_PROFILE_SCOPE("HLT_prescale");
+
  // put the trigger name into a string
   TString HLTTrigger( arg );
 
@@ -311,6 +322,8 @@ int HLT_prescale( const char* arg ){
 
 int L1_prescale( const char* arg ){
 
+  CORE_PROFILE_SCOPE("L1_prescale");
+
   // put the trigger name into a string
   TString trigger( arg );
 
@@ -360,12 +360,14 @@ bool ttv::isDenominatorLepton (int id, int idx, LeptonType::value_type lep_type,
 
 bool ttv::overlapMuon(int idx, LeptonType::value_type lep_type, float pt, float eta, float deltaR)
 {
+  // muons within deltaR of the electron, from the per-event Delta R table
+  const JetMask &near_mus = p4LeptonOverlapMask(cms2.mus_p4(), 11, idx, deltaR);
   for( unsigned int muidx = 0; muidx < cms2.mus_p4().size(); muidx++)
   {
-	  if (cms2.mus_p4()[muidx].pt() > pt &&
+	  if (jetOverlaps(near_mus, muidx) &&
+		  cms2.mus_p4()[muidx].pt() > pt &&
 		  abs(cms2.mus_p4()[muidx].eta()) < eta &&
-		  ttv::isNumeratorLepton(13, muidx, lep_type) &&
-		  ROOT::Math::VectorUtil::DeltaR(cms2.mus_p4()[muidx], cms2.els_p4()[idx]) < deltaR)
+		  ttv::isNumeratorLepton(13, muidx, lep_type))
 	  { 
 		  return true; 
 	  }
@@ -490,32 +492,10 @@ float ttv::getNonTrigMVAThreshold(int idx, LeptonType::value_type lep_type)
 
 std::vector<LorentzVector> ttv::getJets(std::vector<LorentzVector>& leps, enum JetType type, float deltaR, float min_pt, float max_eta, float rescale, int systFlag)
 {
+  JetVariations tmp_jets;
+  ttv::getJetVariations(tmp_jets, std::vector<JetVariation>(1, JetVariation(JETS_VAR_SYST, systFlag, rescale)), leps, type, deltaR, min_pt, max_eta);
 
-  std::vector<LorentzVector> tmp_jets = getJets(999999, true, type, JETS_CLEAN_NONE, deltaR, min_pt, max_eta, (double) rescale, systFlag);
-
-  // ok, now perform the rest of the lepton overlap removal
-  // and the impose the pt requirement after applying the
-  // extra corrections
-  std::vector<LorentzVector> final_jets;
-
-  for (unsigned int jidx = 0; jidx < tmp_jets.size(); jidx++)
-  {
-	  LorentzVector vjet = tmp_jets.at(jidx);
-	  bool jetIsLep = false;
-	  for (unsigned int lidx = 0; lidx < leps.size(); lidx++)
-      {
-		  if (ROOT::Math::VectorUtil::DeltaR(vjet, leps.at(lidx)) < deltaR)
-          {
-			  jetIsLep = true;
-			  break;
-          }
-      }
-
-	  if (jetIsLep) { continue; }        
-
-	  final_jets.push_back(vjet);
-  }
-
+  std::vector<LorentzVector> final_jets = tmp_jets.getJets(0);
   sort(final_jets.begin(), final_jets.end(), jet_pt_gt_ttv());
   return final_jets;    
 }
@@ -549,36 +529,30 @@ std::vector<LorentzVector> ttv::getJets(std::vector<LorentzVector>& leps, Factor
   return final_jets;
 }
 
+// the lepton overlap removal uses the uncorrected jet direction
+void ttv::getJetVariations(JetVariations& result, const std::vector<JetVariation>& variations, std::vector<LorentzVector>& leps, enum JetType type, float deltaR, float min_pt, float max_eta, JetCorrectionUncertainty *jet_unc, JetSmearer *jet_smearer)
+{
+  ::getJetVariations(result, variations, 999999, type, JETS_CLEAN_NONE, (double)deltaR, (double)min_pt, (double)max_eta, jet_unc, jet_smearer);
+
+  // jets within deltaR of a lepton
+  JetMask overlaps;
+  addJetOverlaps(overlaps, type, leps, deltaR);
+  result.removeOverlaps(overlaps);
+}
+
 std::vector<bool> ttv::getJetFlags(std::vector<LorentzVector>& leps, enum JetType type, float deltaR, float min_pt, float max_eta, float rescale, int systFlag)
 {
-  std::vector<bool> tmp_jet_flags = getJetFlags(999999, type, JETS_CLEAN_NONE, (double)deltaR, min_pt, (double)max_eta, (double)rescale, systFlag);
-  std::vector<LorentzVector> tmp_jets = getJets(999999, false, type, JETS_CLEAN_NONE, deltaR, min_pt, max_eta, (double) rescale, systFlag);
+  std::vector<bool> final_jets = getJetFlags(999999, type, JETS_CLEAN_NONE, (double)deltaR, min_pt, (double)max_eta, (double)rescale, systFlag);
 
   // ok, now perform the rest of the lepton overlap removal
-  // and the impose the pt requirement after applying the
-  // extra corrections
-  std::vector<bool> final_jets;
-  for (unsigned int jidx = 0; jidx < tmp_jet_flags.size(); jidx++) 
-  {
+  // with the jet-lepton masks of the good leptons
+  JetMask overlaps;
+  addJetOverlaps(overlaps, type, leps, deltaR);
 
-	if (!tmp_jet_flags.at(jidx)) 
-	{
-	  final_jets.push_back(tmp_jet_flags.at(jidx));
-	  continue;
-	}
-        
-	LorentzVector vjet = tmp_jets.at(jidx);
-	bool jetIsLep = false;
-	for (unsigned int lidx = 0; lidx < leps.size(); lidx++)
-	{
-		if (ROOT::Math::VectorUtil::DeltaR(vjet, leps.at(lidx)) < deltaR)
-		{
-			jetIsLep = true;
-			break;
-		}
-	}
-            
-	final_jets.push_back(!jetIsLep);
+  for (unsigned int jidx = 0; jidx < final_jets.size(); jidx++) 
+  {
+	if (final_jets[jidx] && jetOverlaps(overlaps, jidx))
+	  { final_jets[jidx] = false; }
   }
 
   return final_jets;
@@ -662,29 +636,21 @@ int ttv::nJets(std::vector<LorentzVector>& leps, FactorizedJetCorrector* jet_cor
 
 std::vector<LorentzVector> ttv::getBtaggedJets(std::vector<LorentzVector>& leps, enum JetType type, enum BtagType btag_type, float deltaR, float min_pt, float max_eta, float rescale, int systFlag)
 {
-  std::vector<LorentzVector> tmp_jets = getBtaggedJets(999999, true, type, JETS_CLEAN_NONE, btag_type, deltaR, min_pt, max_eta, (double) rescale, systFlag);
+  SelectedJets tmp_jets;
+  selectBtaggedJets(tmp_jets, 999999, type, JETS_CLEAN_NONE, btag_type, deltaR, min_pt, max_eta, (double) rescale, systFlag);
 
   // ok, now perform the rest of the lepton overlap removal
-  // and the impose the pt requirement after applying the
-  // extra corrections
+  // with the jet-lepton masks of the good leptons
+  JetMask overlaps;
+  addJetOverlaps(overlaps, type, leps, deltaR);
+
   std::vector<LorentzVector> final_jets;
   for (unsigned int jidx = 0; jidx < tmp_jets.size(); jidx++)
   {
-	  LorentzVector vjet = tmp_jets.at(jidx);
-	  bool jetIsLep = false;
-	  for (unsigned int lidx = 0; lidx < leps.size(); lidx++)
-      {
-		  if (ROOT::Math::VectorUtil::DeltaR(vjet, leps.at(lidx)) < deltaR)
-          {
-			  jetIsLep = true;
-			  break;
-          }
-      }
-
-	  if (jetIsLep) { continue; }       
+	  if (jetOverlaps(overlaps, tmp_jets.index(jidx))) { continue; }
 
-	  final_jets.push_back(vjet);
-    }
+	  final_jets.push_back(tmp_jets.p4(jidx));
+  }
 
   sort(final_jets.begin(), final_jets.end(), jet_pt_gt_ttv());
   return final_jets;    
@@ -722,32 +688,16 @@ std::vector<LorentzVector> ttv::getBtaggedJets(std::vector<LorentzVector>& leps,
 
 std::vector<bool> ttv::getBtaggedJetFlags(std::vector<LorentzVector>& leps, enum JetType type, enum BtagType btag_type, float deltaR, float min_pt, float max_eta, float rescale, int systFlag)
 {
-  std::vector<bool> tmp_jet_flags = getBtaggedJetFlags(999999, type, JETS_CLEAN_NONE, btag_type, (double)deltaR, (double)min_pt, (double)max_eta, (double)rescale, systFlag);
-  std::vector<LorentzVector> tmp_jets = getBtaggedJets(999999, false, type, JETS_CLEAN_NONE, btag_type, deltaR, min_pt, max_eta, (double) rescale, systFlag);
+  std::vector<bool> final_jets = getBtaggedJetFlags(999999, type, JETS_CLEAN_NONE, btag_type, (double)deltaR, (double)min_pt, (double)max_eta, (double)rescale, systFlag);
 
   // ok, now perform the rest of the lepton overlap removal
-  // and the impose the pt requirement after applying the
-  // extra corrections
-  std::vector<bool> final_jets;
-  for (unsigned int jidx = 0; jidx < tmp_jet_flags.size(); jidx++) {
+  // with the jet-lepton masks of the good leptons
+  JetMask overlaps;
+  addJetOverlaps(overlaps, type, leps, deltaR);
 
-	if (!tmp_jet_flags.at(jidx)) {
-	  final_jets.push_back(tmp_jet_flags.at(jidx));
-	  continue;
-	}
-        
-	LorentzVector vjet = tmp_jets.at(jidx);
-	bool jetIsLep = false;
-	for (unsigned int lidx = 0; lidx < leps.size(); lidx++)
-	  {
-		if (ROOT::Math::VectorUtil::DeltaR(vjet, leps.at(lidx)) < deltaR)
-		  {
-			jetIsLep = true;
-			break;
-		  }
-	  }
-            
-	final_jets.push_back(!jetIsLep);
+  for (unsigned int jidx = 0; jidx < final_jets.size(); jidx++) {
+	if (final_jets[jidx] && jetOverlaps(overlaps, jidx))
+	  { final_jets[jidx] = false; }
   }
 
   return final_jets;
@@ -23,6 +23,19 @@ bool hypsOverlap(int idxa, int idxb){
   return matches>0;
 }
 
+bool isNewEvent(EventTag &tag){
+  unsigned int run   = cms2.evt_run();
+  unsigned int lumi  = cms2.evt_lumiBlock();
+  unsigned int event = cms2.evt_event();
+  if (tag.valid && tag.run == run && tag.lumi == lumi && tag.event == event)
+    return false;
+  tag.run   = run;
+  tag.lumi  = lumi;
+  tag.event = event;
+  tag.valid = true;
+  return true;
+}
+
 int match4vector(const LorentzVector &lvec, const vector<LorentzVector> &vec, double cut=10.0 ){
 
   if( vec.size() == 0 ) return -1;
@@ -19,14 +19,59 @@ inline float deltaPhi( float phi1 , float phi2 ) {
 
 // Delta R
 inline double deltaR(float eta1 , float phi1 , float eta2 , float phi2) {
-  double dphi = std::min(::fabs(phi1 - phi2), 2 * M_PI - fabs(phi1 - phi2));
+  double dphi = std::min<double>(::fabs(phi1 - phi2), 2 * M_PI - fabs(phi1 - phi2));
   double deta = eta1 - eta2;
   return sqrt(dphi*dphi + deta*deta);
 }
 
+// Delta R from precomputed eta and phi, with the same float arithmetic as
+// ROOT::Math::VectorUtil::DeltaR(v1, v2) on LorentzVector
+inline float deltaRFromEtaPhi(float eta1, float phi1, float eta2, float phi2) {
+  float dphi = phi2 - phi1;
+  if (dphi > M_PI) dphi -= 2.0*M_PI;
+  else if (dphi <= -M_PI) dphi += 2.0*M_PI;
+  float deta = eta2 - eta1;
+  return std::sqrt(dphi*dphi + deta*deta);
+}
+
+
+// Bin index in a small table of fixed bin edges, without branches.
+// binAbove counts the edges x is above, for bins with inclusive upper
+// edges (x <= edge[0], edge[0] < x <= edge[1], ...); binAtOrAbove counts
+// the edges x is at or above, for inclusive lower edges. A NaN x gives 0.
+template <unsigned int N>
+inline unsigned int binAbove(double x, const double (&edges)[N]) {
+  unsigned int bin = 0;
+  for (unsigned int i = 0; i < N; i++)
+    bin += (x > edges[i]);
+  return bin;
+}
+
+template <unsigned int N>
+inline unsigned int binAtOrAbove(double x, const double (&edges)[N]) {
+  unsigned int bin = 0;
+  for (unsigned int i = 0; i < N; i++)
+    bin += (x >= edges[i]);
+  return bin;
+}
+
 
 bool   hypsOverlap(int, int );
 
+// Identifies the event currently loaded in cms2. Per-event caches keep the
+// tag of the event they were filled for and rebuild when isNewEvent says so.
+struct EventTag {
+    EventTag() : run(0), lumi(0), event(0), valid(false) {}
+    unsigned int run;
+    unsigned int lumi;
+    unsigned int event;
+    bool valid;
+};
+
+// returns true if cms2 has moved to another event since tag was last
+// updated; the tag is updated to the current event
+bool   isNewEvent(EventTag &tag);
+
 //double trkIsolation(int trk_index);
 
 #endif